@@ -0,0 +1,716 @@
+#include "avx2Kernels.h"
+#include "fusedEpilogue.h"
+#include "arm_compute/core/Error.h"
+#include "arm_compute/core/Helpers.h"
+#include "arm_compute/runtime/NEON/NEScheduler.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+#if defined(__AVX2__) && defined(__FMA__)
+#include <immintrin.h>
+#endif
+
+namespace opWrapper{
+
+	//Output pixels per panel, two AVX2 vectors
+	static const int block_cols = 16;
+	//Output channels per micro-kernel call, 6 x 2 accumulators + 2 panel vectors + 1 weight fit in the 16 registers
+	static const int block_rows = 6;
+
+	static void checkF32(const ITensor * tensor){
+		if(tensor->info()->data_type() != DataType::F32)
+		{
+			ARM_COMPUTE_ERROR("The AVX2 backend only runs F32");
+		}
+	}
+
+	//First byte of channel c of image n
+	static uint8_t * plane(const ITensor * tensor, int c, int n){
+		const Strides &strides = tensor->info()->strides_in_bytes();
+		return tensor->buffer() + tensor->info()->offset_first_element_in_bytes() + c * strides[2] + n * strides[3];
+	}
+
+	static const float * data(const ITensor * tensor){
+		return reinterpret_cast<const float *>(tensor->buffer() + tensor->info()->offset_first_element_in_bytes());
+	}
+
+	static Window indexWindow(int count){
+		Window window;
+		window.set(Window::DimX, Window::Dimension(0, count, 1));
+		return window;
+	}
+
+	static void initOutput(ITensor * output, const TensorShape &shape){
+		auto_init_if_empty(*output->info(), shape, 1, DataType::F32);
+		if(output->info()->tensor_shape().total_size() != shape.total_size())
+		{
+			ARM_COMPUTE_ERROR("The output does not have the shape of the layer");
+		}
+	}
+
+	//Output size of a convolution or pooling window, rounded down as PadStrideInfo does by default
+	static int outputSize(int input, int kernel, int stride, int padding){
+		return (input + 2 * padding - kernel) / stride + 1;
+	}
+
+	//out = clamp(in * scale + shift), in and out may be the same row
+	static void affineRow(const float * in, float * out, int width, float scale, float shift, float lower, float upper){
+		int x = 0;
+#if defined(__AVX2__) && defined(__FMA__)
+		const __m256 vscale = _mm256_set1_ps(scale);
+		const __m256 vshift = _mm256_set1_ps(shift);
+		const __m256 vlower = _mm256_set1_ps(lower);
+		const __m256 vupper = _mm256_set1_ps(upper);
+		for(; x <= width - 8; x += 8)
+		{
+			const __m256 v = _mm256_fmadd_ps(_mm256_loadu_ps(in + x), vscale, vshift);
+			_mm256_storeu_ps(out + x, _mm256_min_ps(_mm256_max_ps(v, vlower), vupper));
+		}
+#endif
+		for(; x < width; x++)
+		{
+			out[x] = std::min(std::max(in[x] * scale + shift, lower), upper);
+		}
+	}
+
+	//acc += w * in
+	static void axpyRow(float * acc, const float * in, float w, int width){
+		int x = 0;
+#if defined(__AVX2__) && defined(__FMA__)
+		const __m256 vw = _mm256_set1_ps(w);
+		for(; x <= width - 8; x += 8)
+		{
+			_mm256_storeu_ps(acc + x, _mm256_fmadd_ps(vw, _mm256_loadu_ps(in + x), _mm256_loadu_ps(acc + x)));
+		}
+#endif
+		for(; x < width; x++)
+		{
+			acc[x] += w * in[x];
+		}
+	}
+
+	static void maxRow(float * acc, const float * in, int width){
+		int x = 0;
+#if defined(__AVX2__) && defined(__FMA__)
+		for(; x <= width - 8; x += 8)
+		{
+			_mm256_storeu_ps(acc + x, _mm256_max_ps(_mm256_loadu_ps(acc + x), _mm256_loadu_ps(in + x)));
+		}
+#endif
+		for(; x < width; x++)
+		{
+			acc[x] = std::max(acc[x], in[x]);
+		}
+	}
+
+	static void addRow(float * acc, const float * in, int width){
+		int x = 0;
+#if defined(__AVX2__) && defined(__FMA__)
+		for(; x <= width - 8; x += 8)
+		{
+			_mm256_storeu_ps(acc + x, _mm256_add_ps(_mm256_loadu_ps(acc + x), _mm256_loadu_ps(in + x)));
+		}
+#endif
+		for(; x < width; x++)
+		{
+			acc[x] += in[x];
+		}
+	}
+
+	static float dot(const float * a, const float * b, int size){
+		int x = 0;
+		float sum = 0.f;
+#if defined(__AVX2__) && defined(__FMA__)
+		__m256 acc0 = _mm256_setzero_ps();
+		__m256 acc1 = _mm256_setzero_ps();
+		for(; x <= size - 16; x += 16)
+		{
+			acc0 = _mm256_fmadd_ps(_mm256_loadu_ps(a + x), _mm256_loadu_ps(b + x), acc0);
+			acc1 = _mm256_fmadd_ps(_mm256_loadu_ps(a + x + 8), _mm256_loadu_ps(b + x + 8), acc1);
+		}
+		float lanes[8];
+		_mm256_storeu_ps(lanes, _mm256_add_ps(acc0, acc1));
+		for(int l = 0; l < 8; l++)
+		{
+			sum += lanes[l];
+		}
+#endif
+		for(; x < size; x++)
+		{
+			sum += a[x] * b[x];
+		}
+		return sum;
+	}
+
+	//A buffer of the calling thread that keeps its capacity between runs
+	static float * scratch(size_t size){
+		static thread_local std::vector<float> buffer;
+		if(buffer.size() < size)
+		{
+			buffer.resize(size);
+		}
+		return buffer.data();
+	}
+
+	//R rows of the weights (depth apart) times the panel, c is R x 16
+	template <int R>
+	static void gemmBlock(const float * a, int depth, const float * panel, float * c){
+#if defined(__AVX2__) && defined(__FMA__)
+		__m256 lo[R];
+		__m256 hi[R];
+		for(int r = 0; r < R; r++)
+		{
+			lo[r] = _mm256_setzero_ps();
+			hi[r] = _mm256_setzero_ps();
+		}
+		for(int k = 0; k < depth; k++)
+		{
+			const __m256 b0 = _mm256_loadu_ps(panel + k * block_cols);
+			const __m256 b1 = _mm256_loadu_ps(panel + k * block_cols + 8);
+			for(int r = 0; r < R; r++)
+			{
+				const __m256 w = _mm256_broadcast_ss(a + r * depth + k);
+				lo[r] = _mm256_fmadd_ps(w, b0, lo[r]);
+				hi[r] = _mm256_fmadd_ps(w, b1, hi[r]);
+			}
+		}
+		for(int r = 0; r < R; r++)
+		{
+			_mm256_storeu_ps(c + r * block_cols, lo[r]);
+			_mm256_storeu_ps(c + r * block_cols + 8, hi[r]);
+		}
+#else
+		std::fill(c, c + R * block_cols, 0.f);
+		for(int k = 0; k < depth; k++)
+		{
+			const float * b = panel + k * block_cols;
+			for(int r = 0; r < R; r++)
+			{
+				const float w = a[r * depth + k];
+				for(int j = 0; j < block_cols; j++)
+				{
+					c[r * block_cols + j] += w * b[j];
+				}
+			}
+		}
+#endif
+	}
+
+	typedef void (*GemmBlock)(const float *, int, const float *, float *);
+	static const GemmBlock gemm_blocks[block_rows + 1] = { nullptr, gemmBlock<1>, gemmBlock<2>, gemmBlock<3>, gemmBlock<4>, gemmBlock<5>, gemmBlock<6> };
+
+	AVX2ConvolutionKernel::AVX2ConvolutionKernel()
+		: _input(nullptr), _weights(nullptr), _biases(nullptr), _output(nullptr), _stride_x(1), _stride_y(1), _pad_x(0), _pad_y(0), _blocks(0),
+		  _lower(-std::numeric_limits<float>::infinity()), _upper(std::numeric_limits<float>::infinity())
+	{
+	}
+
+	void AVX2ConvolutionKernel::configure(const ITensor * input, const ITensor * weights, const ITensor * biases, ITensor * output,
+										  const PadStrideInfo &conv_info, const ActivationLayerInfo &act_info){
+		checkF32(input);
+		checkF32(weights);
+		const ITensorInfo * in = input->info();
+		const ITensorInfo * w = weights->info();
+		if(w->dimension(2) != in->dimension(2))
+		{
+			ARM_COMPUTE_ERROR("The weights do not have the channels of the input");
+		}
+		_input = input;
+		_weights = weights;
+		_biases = biases;
+		_output = output;
+		_stride_x = conv_info.stride().first;
+		_stride_y = conv_info.stride().second;
+		_pad_x = conv_info.pad().first;
+		_pad_y = conv_info.pad().second;
+		clampBounds(act_info, _lower, _upper);
+		const int out_w = outputSize(in->dimension(0), w->dimension(0), _stride_x, _pad_x);
+		const int out_h = outputSize(in->dimension(1), w->dimension(1), _stride_y, _pad_y);
+		initOutput(output, TensorShape(out_w, out_h, w->dimension(3), in->dimension(3)));
+		_blocks = (out_w * out_h + block_cols - 1) / block_cols;
+		INEKernel::configure(indexWindow(_blocks * in->dimension(3)));
+	}
+
+	void AVX2ConvolutionKernel::run(const Window &window, const ThreadInfo &info){
+		ARM_COMPUTE_UNUSED(info);
+		const ITensorInfo * in = _input->info();
+		const ITensorInfo * w = _weights->info();
+		const ITensorInfo * out = _output->info();
+		const int in_w = in->dimension(0);
+		const int in_h = in->dimension(1);
+		const int kernel_x = w->dimension(0);
+		const int kernel_y = w->dimension(1);
+		const int channels = w->dimension(2);
+		const int out_channels = w->dimension(3);
+		const int out_w = out->dimension(0);
+		const int pixels = out_w * out->dimension(1);
+		const int depth = channels * kernel_x * kernel_y;
+		const size_t in_row = in->strides_in_bytes()[1];
+		const size_t out_row = out->strides_in_bytes()[1];
+		//A 1x1 stride 1 convolution reads the panel rows straight from dense input planes
+		const bool pointwise = kernel_x == 1 && kernel_y == 1 && _stride_x == 1 && _stride_y == 1 && _pad_x == 0 && _pad_y == 0
+							   && in_row == static_cast<size_t>(in_w) * sizeof(float);
+		const bool dense_out = out_row == static_cast<size_t>(out_w) * sizeof(float);
+		const float * a = data(_weights);
+		const float * bias = _biases != nullptr ? data(_biases) : nullptr;
+
+		float * panel = scratch(static_cast<size_t>(depth) * block_cols + block_rows * block_cols);
+		float * c = panel + static_cast<size_t>(depth) * block_cols;
+		int oy[block_cols];
+		int ox[block_cols];
+		size_t offset[block_cols];
+		for(int b = window.x().start(); b < window.x().end(); b++)
+		{
+			const int n = b / _blocks;
+			const int first = (b % _blocks) * block_cols;
+			const int count = std::min(block_cols, pixels - first);
+			for(int j = 0; j < count; j++)
+			{
+				oy[j] = (first + j) / out_w;
+				ox[j] = (first + j) % out_w;
+				offset[j] = oy[j] * out_row + ox[j] * sizeof(float);
+			}
+
+			//Row k of the panel is (channel, ky, kx) in the order of the weights, the columns past count stay zero
+			int k = 0;
+			for(int ic = 0; ic < channels; ic++)
+			{
+				const uint8_t * src = plane(_input, ic, n);
+				if(pointwise)
+				{
+					float * row = panel + k * block_cols;
+					memcpy(row, src + first * sizeof(float), count * sizeof(float));
+					std::fill(row + count, row + block_cols, 0.f);
+					k++;
+					continue;
+				}
+				for(int ky = 0; ky < kernel_y; ky++)
+				{
+					for(int kx = 0; kx < kernel_x; kx++, k++)
+					{
+						float * row = panel + k * block_cols;
+						for(int j = 0; j < count; j++)
+						{
+							const int iy = oy[j] * _stride_y - _pad_y + ky;
+							const int ix = ox[j] * _stride_x - _pad_x + kx;
+							row[j] = iy >= 0 && iy < in_h && ix >= 0 && ix < in_w ? *reinterpret_cast<const float *>(src + iy * in_row + ix * sizeof(float)) : 0.f;
+						}
+						std::fill(row + count, row + block_cols, 0.f);
+					}
+				}
+			}
+
+			for(int m = 0; m < out_channels; m += block_rows)
+			{
+				const int rows = std::min(block_rows, out_channels - m);
+				gemm_blocks[rows](a + static_cast<size_t>(m) * depth, depth, panel, c);
+				for(int r = 0; r < rows; r++)
+				{
+					const float shift = bias != nullptr ? bias[m + r] : 0.f;
+					uint8_t * dst = plane(_output, m + r, n);
+					//The block is one run of pixels when the output rows have no padding
+					if(dense_out)
+					{
+						affineRow(c + r * block_cols, reinterpret_cast<float *>(dst) + first, count, 1.f, shift, _lower, _upper);
+						continue;
+					}
+					for(int j = 0; j < count; j++)
+					{
+						*reinterpret_cast<float *>(dst + offset[j]) = std::min(std::max(c[r * block_cols + j] + shift, _lower), _upper);
+					}
+				}
+			}
+		}
+	}
+
+	AVX2DepthwiseKernel::AVX2DepthwiseKernel()
+		: _input(nullptr), _weights(nullptr), _biases(nullptr), _output(nullptr), _stride_x(1), _stride_y(1), _pad_x(0), _pad_y(0),
+		  _lower(-std::numeric_limits<float>::infinity()), _upper(std::numeric_limits<float>::infinity())
+	{
+	}
+
+	void AVX2DepthwiseKernel::configure(const ITensor * input, const ITensor * weights, const ITensor * biases, ITensor * output,
+										const PadStrideInfo &conv_info, const ActivationLayerInfo &act_info){
+		checkF32(input);
+		checkF32(weights);
+		const ITensorInfo * in = input->info();
+		const ITensorInfo * w = weights->info();
+		if(w->dimension(2) != in->dimension(2))
+		{
+			ARM_COMPUTE_ERROR("The depthwise weights need one kernel per input channel");
+		}
+		_input = input;
+		_weights = weights;
+		_biases = biases;
+		_output = output;
+		_stride_x = conv_info.stride().first;
+		_stride_y = conv_info.stride().second;
+		_pad_x = conv_info.pad().first;
+		_pad_y = conv_info.pad().second;
+		clampBounds(act_info, _lower, _upper);
+		const int out_w = outputSize(in->dimension(0), w->dimension(0), _stride_x, _pad_x);
+		const int out_h = outputSize(in->dimension(1), w->dimension(1), _stride_y, _pad_y);
+		initOutput(output, TensorShape(out_w, out_h, in->dimension(2), in->dimension(3)));
+		INEKernel::configure(indexWindow(in->dimension(2) * in->dimension(3)));
+	}
+
+	void AVX2DepthwiseKernel::run(const Window &window, const ThreadInfo &info){
+		ARM_COMPUTE_UNUSED(info);
+		const ITensorInfo * in = _input->info();
+		const int in_w = in->dimension(0);
+		const int in_h = in->dimension(1);
+		const int channels = in->dimension(2);
+		const int kernel_x = _weights->info()->dimension(0);
+		const int kernel_y = _weights->info()->dimension(1);
+		const int out_w = _output->info()->dimension(0);
+		const int out_h = _output->info()->dimension(1);
+		const size_t in_row = in->strides_in_bytes()[1];
+		const size_t out_row = _output->info()->strides_in_bytes()[1];
+		const float * weights = data(_weights);
+		const float * bias = _biases != nullptr ? data(_biases) : nullptr;
+		float * acc = scratch(out_w);
+		for(int p = window.x().start(); p < window.x().end(); p++)
+		{
+			const int c = p % channels;
+			const int n = p / channels;
+			const uint8_t * src = plane(_input, c, n);
+			uint8_t * dst = plane(_output, c, n);
+			const float * kernel = weights + c * kernel_x * kernel_y;
+			for(int y = 0; y < out_h; y++)
+			{
+				std::fill(acc, acc + out_w, bias != nullptr ? bias[c] : 0.f);
+				for(int ky = 0; ky < kernel_y; ky++)
+				{
+					const int iy = y * _stride_y - _pad_y + ky;
+					if(iy < 0 || iy >= in_h)
+					{
+						continue;
+					}
+					const float * row = reinterpret_cast<const float *>(src + iy * in_row);
+					for(int kx = 0; kx < kernel_x; kx++)
+					{
+						//Output columns whose tap falls inside the row
+						const int shift = kx - _pad_x;
+						const int first = shift < 0 ? (-shift + _stride_x - 1) / _stride_x : 0;
+						const int last = in_w - 1 - shift < 0 ? 0 : std::min(out_w, (in_w - 1 - shift) / _stride_x + 1);
+						const float w = kernel[ky * kernel_x + kx];
+						if(_stride_x == 1)
+						{
+							if(last > first)
+							{
+								axpyRow(acc + first, row + first + shift, w, last - first);
+							}
+							continue;
+						}
+						for(int x = first; x < last; x++)
+						{
+							acc[x] += w * row[x * _stride_x + shift];
+						}
+					}
+				}
+				affineRow(acc, reinterpret_cast<float *>(dst + y * out_row), out_w, 1.f, 0.f, _lower, _upper);
+			}
+		}
+	}
+
+	AVX2ChannelAffineKernel::AVX2ChannelAffineKernel()
+		: _input(nullptr), _output(nullptr), _scale(nullptr), _shift(nullptr),
+		  _lower(-std::numeric_limits<float>::infinity()), _upper(std::numeric_limits<float>::infinity())
+	{
+	}
+
+	void AVX2ChannelAffineKernel::configure(const ITensor * input, ITensor * output, const float * scale, const float * shift,
+											const ActivationLayerInfo &act_info){
+		checkF32(input);
+		_input = input;
+		_output = output;
+		_scale = scale;
+		_shift = shift;
+		clampBounds(act_info, _lower, _upper);
+		if(output != nullptr)
+		{
+			initOutput(output, input->info()->tensor_shape());
+		}
+		INEKernel::configure(indexWindow(input->info()->dimension(2) * input->info()->dimension(3)));
+	}
+
+	void AVX2ChannelAffineKernel::run(const Window &window, const ThreadInfo &info){
+		ARM_COMPUTE_UNUSED(info);
+		const ITensor * output = _output != nullptr ? _output : _input;
+		const int width = _input->info()->dimension(0);
+		const int height = _input->info()->dimension(1);
+		const int channels = _input->info()->dimension(2);
+		const size_t in_row = _input->info()->strides_in_bytes()[1];
+		const size_t out_row = output->info()->strides_in_bytes()[1];
+		for(int p = window.x().start(); p < window.x().end(); p++)
+		{
+			const int c = p % channels;
+			const int n = p / channels;
+			const uint8_t * src = plane(_input, c, n);
+			uint8_t * dst = plane(output, c, n);
+			const float scale = _scale != nullptr ? _scale[c] : 1.f;
+			const float shift = _shift != nullptr ? _shift[c] : 0.f;
+			for(int y = 0; y < height; y++)
+			{
+				affineRow(reinterpret_cast<const float *>(src + y * in_row), reinterpret_cast<float *>(dst + y * out_row), width, scale, shift, _lower, _upper);
+			}
+		}
+	}
+
+	AVX2PoolingKernel::AVX2PoolingKernel()
+		: _input(nullptr), _output(nullptr), _type(PoolingType::MAX), _pool_size(1), _stride(1), _padding(0)
+	{
+	}
+
+	void AVX2PoolingKernel::configure(const ITensor * input, ITensor * output, PoolingType type, int pool_size, int stride, int padding){
+		checkF32(input);
+		if(type != PoolingType::MAX && type != PoolingType::AVG)
+		{
+			ARM_COMPUTE_ERROR("The AVX2 backend only pools with MAX and AVG");
+		}
+		_input = input;
+		_output = output;
+		_type = type;
+		_pool_size = pool_size;
+		_stride = stride;
+		_padding = padding;
+		const ITensorInfo * in = input->info();
+		initOutput(output, TensorShape(outputSize(in->dimension(0), pool_size, stride, padding), outputSize(in->dimension(1), pool_size, stride, padding),
+									   in->dimension(2), in->dimension(3)));
+		INEKernel::configure(indexWindow(in->dimension(2) * in->dimension(3)));
+	}
+
+	void AVX2PoolingKernel::run(const Window &window, const ThreadInfo &info){
+		ARM_COMPUTE_UNUSED(info);
+		const int in_w = _input->info()->dimension(0);
+		const int in_h = _input->info()->dimension(1);
+		const int channels = _input->info()->dimension(2);
+		const int out_w = _output->info()->dimension(0);
+		const int out_h = _output->info()->dimension(1);
+		const size_t in_row = _input->info()->strides_in_bytes()[1];
+		const size_t out_row = _output->info()->strides_in_bytes()[1];
+		const bool max = _type == PoolingType::MAX;
+		float * rows = scratch(in_w);
+		for(int p = window.x().start(); p < window.x().end(); p++)
+		{
+			const uint8_t * src = plane(_input, p % channels, p / channels);
+			uint8_t * dst = plane(_output, p % channels, p / channels);
+			for(int y = 0; y < out_h; y++)
+			{
+				const int start_y = y * _stride - _padding;
+				const int first_y = std::max(start_y, 0);
+				const int last_y = std::min(start_y + _pool_size, in_h);
+				memcpy(rows, src + first_y * in_row, in_w * sizeof(float));
+				for(int iy = first_y + 1; iy < last_y; iy++)
+				{
+					const float * row = reinterpret_cast<const float *>(src + iy * in_row);
+					if(max)
+					{
+						maxRow(rows, row, in_w);
+					}
+					else
+					{
+						addRow(rows, row, in_w);
+					}
+				}
+				const int area_y = std::min(start_y + _pool_size, in_h + _padding) - start_y;
+				float * out = reinterpret_cast<float *>(dst + y * out_row);
+				for(int x = 0; x < out_w; x++)
+				{
+					const int start_x = x * _stride - _padding;
+					const int first_x = std::max(start_x, 0);
+					const int last_x = std::min(start_x + _pool_size, in_w);
+					float v = rows[first_x];
+					for(int ix = first_x + 1; ix < last_x; ix++)
+					{
+						v = max ? std::max(v, rows[ix]) : v + rows[ix];
+					}
+					out[x] = max ? v : v / (area_y * (std::min(start_x + _pool_size, in_w + _padding) - start_x));
+				}
+			}
+		}
+	}
+
+	AVX2ChannelCopyKernel::AVX2ChannelCopyKernel()
+		: _copies()
+	{
+	}
+
+	void AVX2ChannelCopyKernel::configure(const std::vector<ChannelCopy> &copies){
+		if(copies.empty())
+		{
+			ARM_COMPUTE_ERROR("Nothing to copy");
+		}
+		for(size_t i = 0; i < copies.size(); i++)
+		{
+			checkF32(copies[i].src);
+			checkF32(copies[i].dst);
+		}
+		_copies = copies;
+		INEKernel::configure(indexWindow(copies.size()));
+	}
+
+	void AVX2ChannelCopyKernel::run(const Window &window, const ThreadInfo &info){
+		ARM_COMPUTE_UNUSED(info);
+		for(int i = window.x().start(); i < window.x().end(); i++)
+		{
+			const ChannelCopy &copy = _copies[i];
+			const ITensorInfo * src = copy.src->info();
+			const size_t row = src->dimension(0) * sizeof(float);
+			const size_t src_row = src->strides_in_bytes()[1];
+			const size_t dst_row = copy.dst->info()->strides_in_bytes()[1];
+			const int height = src->dimension(1);
+			for(size_t n = 0; n < src->dimension(3); n++)
+			{
+				const uint8_t * from = plane(copy.src, copy.src_channel, n);
+				uint8_t * to = plane(copy.dst, copy.dst_channel, n);
+				//Planes without row padding are one block
+				if(src_row == row && dst_row == row)
+				{
+					memcpy(to, from, row * height);
+					continue;
+				}
+				for(int y = 0; y < height; y++)
+				{
+					memcpy(to + y * dst_row, from + y * src_row, row);
+				}
+			}
+		}
+	}
+
+	AVX2ReduceMeanKernel::AVX2ReduceMeanKernel()
+		: _input(nullptr), _output(nullptr)
+	{
+	}
+
+	void AVX2ReduceMeanKernel::configure(const ITensor * input, ITensor * output){
+		checkF32(input);
+		_input = input;
+		_output = output;
+		initOutput(output, TensorShape(1U, 1U, input->info()->dimension(2), input->info()->dimension(3)));
+		INEKernel::configure(indexWindow(input->info()->dimension(2) * input->info()->dimension(3)));
+	}
+
+	void AVX2ReduceMeanKernel::run(const Window &window, const ThreadInfo &info){
+		ARM_COMPUTE_UNUSED(info);
+		const int width = _input->info()->dimension(0);
+		const int height = _input->info()->dimension(1);
+		const int channels = _input->info()->dimension(2);
+		const size_t in_row = _input->info()->strides_in_bytes()[1];
+		float * sums = scratch(width);
+		for(int p = window.x().start(); p < window.x().end(); p++)
+		{
+			const uint8_t * src = plane(_input, p % channels, p / channels);
+			memcpy(sums, src, width * sizeof(float));
+			for(int y = 1; y < height; y++)
+			{
+				addRow(sums, reinterpret_cast<const float *>(src + y * in_row), width);
+			}
+			float sum = 0.f;
+			for(int x = 0; x < width; x++)
+			{
+				sum += sums[x];
+			}
+			*reinterpret_cast<float *>(plane(_output, p % channels, p / channels)) = sum / (width * height);
+		}
+	}
+
+	AVX2FullyConnectedKernel::AVX2FullyConnectedKernel()
+		: _input(nullptr), _weights(nullptr), _biases(nullptr), _output(nullptr)
+	{
+	}
+
+	void AVX2FullyConnectedKernel::configure(const ITensor * input, const ITensor * weights, const ITensor * biases, ITensor * output){
+		checkF32(input);
+		checkF32(weights);
+		const size_t in = weights->info()->dimension(0);
+		const size_t out = weights->info()->dimension(1);
+		if(input->info()->tensor_shape().total_size() % in != 0)
+		{
+			ARM_COMPUTE_ERROR("The input does not hold a whole number of images for the weights");
+		}
+		_input = input;
+		_weights = weights;
+		_biases = biases;
+		_output = output;
+		initOutput(output, TensorShape(out, input->info()->tensor_shape().total_size() / in));
+		INEKernel::configure(indexWindow(out));
+	}
+
+	void AVX2FullyConnectedKernel::run(const Window &window, const ThreadInfo &info){
+		ARM_COMPUTE_UNUSED(info);
+		const int in = _weights->info()->dimension(0);
+		const size_t images = _output->info()->dimension(1);
+		const size_t out_row = _output->info()->strides_in_bytes()[1];
+		const float * input = data(_input);
+		const float * weights = data(_weights);
+		const float * bias = _biases != nullptr ? data(_biases) : nullptr;
+		uint8_t * output = _output->buffer() + _output->info()->offset_first_element_in_bytes();
+		for(int o = window.x().start(); o < window.x().end(); o++)
+		{
+			for(size_t n = 0; n < images; n++)
+			{
+				const float v = dot(weights + static_cast<size_t>(o) * in, input + n * in, in);
+				reinterpret_cast<float *>(output + n * out_row)[o] = bias != nullptr ? v + bias[o] : v;
+			}
+		}
+	}
+
+	AVX2Function::AVX2Function(INEKernel * kernel)
+		: _kernel(kernel)
+	{
+	}
+
+	void AVX2Function::run(){
+		NEScheduler::get().schedule(_kernel.get(), Window::DimX);
+	}
+
+	AVX2BatchNormalization::AVX2BatchNormalization()
+		: _mean(nullptr), _var(nullptr), _beta(nullptr), _gamma(nullptr), _epsilon(0.f), _prepared(false), _scale(), _shift(), _kernel()
+	{
+	}
+
+	void AVX2BatchNormalization::configure(const ITensor * input, ITensor * output, const ITensor * mean, const ITensor * var,
+										   const ITensor * beta, const ITensor * gamma, float epsilon, const ActivationLayerInfo &act_info){
+		const size_t channels = input->info()->dimension(2);
+		_mean = mean;
+		_var = var;
+		_beta = beta;
+		_gamma = gamma;
+		_epsilon = epsilon;
+		_prepared = false;
+		_scale.assign(channels, 1.f);
+		_shift.assign(channels, 0.f);
+		_kernel.configure(input, output, _scale.data(), _shift.data(), act_info);
+	}
+
+	void AVX2BatchNormalization::prepare(){
+		if(_prepared)
+		{
+			return;
+		}
+		const float * mean = data(_mean);
+		const float * var = data(_var);
+		const float * beta = data(_beta);
+		const float * gamma = data(_gamma);
+		for(size_t c = 0; c < _scale.size(); c++)
+		{
+			_scale[c] = gamma[c] / std::sqrt(var[c] + _epsilon);
+			_shift[c] = beta[c] - mean[c] * _scale[c];
+		}
+		_mean->mark_as_unused();
+		_var->mark_as_unused();
+		_beta->mark_as_unused();
+		_gamma->mark_as_unused();
+		_prepared = true;
+	}
+
+	void AVX2BatchNormalization::run(){
+		prepare();
+		NEScheduler::get().schedule(&_kernel, Window::DimX);
+	}
+
+ }
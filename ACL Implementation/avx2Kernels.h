@@ -0,0 +1,220 @@
+#ifndef OPAVX2KERNELS
+#define OPAVX2KERNELS
+
+#include "arm_compute/core/NEON/INEKernel.h"
+#include "arm_compute/core/Types.h"
+#include "arm_compute/core/Window.h"
+#include "arm_compute/runtime/IFunction.h"
+
+#include <memory>
+#include <vector>
+
+using namespace arm_compute;
+
+namespace opWrapper{
+
+	//Kernels of the x86-64 backend (opWrapper_avx2), NCHW F32 only
+	//The inner loops take AVX2 + FMA when built with -mavx2 -mfma and have a scalar tail, so they build anywhere
+	//Like NEFusedEpilogueKernel they ask for no padding and walk rows and planes through the strides,
+	//channel views of a parent tensor can be read and written
+	//The window is one index per unit of work (plane, pixel block, copy, output), the scheduler splits it on DimX
+
+	//Dense convolution as a GEMM of the weights (output channels x depth) with an im2col panel of 16 output pixels
+	//The panel is built per block in a buffer of the thread, the 6x16 micro-kernel keeps its sums in registers
+	//and adds the bias and clamps on the way out
+	class AVX2ConvolutionKernel : public INEKernel{
+	public:
+		AVX2ConvolutionKernel();
+		AVX2ConvolutionKernel(const AVX2ConvolutionKernel &) = delete;
+		AVX2ConvolutionKernel &operator=(const AVX2ConvolutionKernel &) = delete;
+
+		const char * name() const override { return "AVX2ConvolutionKernel"; }
+		//weights are (kernel x, kernel y, input channels, output channels) without padding, biases may be nullptr
+		//An empty output is initialised here, only clamping activations can be applied
+		void configure(const ITensor * input, const ITensor * weights, const ITensor * biases, ITensor * output,
+					   const PadStrideInfo &conv_info, const ActivationLayerInfo &act_info);
+		void run(const Window &window, const ThreadInfo &info) override;
+
+	private:
+		const ITensor * _input;
+		const ITensor * _weights;
+		const ITensor * _biases;
+		ITensor * _output;
+		int _stride_x;
+		int _stride_y;
+		int _pad_x;
+		int _pad_y;
+		int _blocks;	//pixel blocks per image
+		float _lower;
+		float _upper;
+	};
+
+	//Depthwise convolution, one plane per index, every row of the output is summed in a buffer of the thread
+	//Stride 1 taps are contiguous and vectorised, stride 2 taps are gathered
+	class AVX2DepthwiseKernel : public INEKernel{
+	public:
+		AVX2DepthwiseKernel();
+		AVX2DepthwiseKernel(const AVX2DepthwiseKernel &) = delete;
+		AVX2DepthwiseKernel &operator=(const AVX2DepthwiseKernel &) = delete;
+
+		const char * name() const override { return "AVX2DepthwiseKernel"; }
+		//weights are (kernel x, kernel y, channels) without padding, biases may be nullptr
+		void configure(const ITensor * input, const ITensor * weights, const ITensor * biases, ITensor * output,
+					   const PadStrideInfo &conv_info, const ActivationLayerInfo &act_info);
+		void run(const Window &window, const ThreadInfo &info) override;
+
+	private:
+		const ITensor * _input;
+		const ITensor * _weights;
+		const ITensor * _biases;
+		ITensor * _output;
+		int _stride_x;
+		int _stride_y;
+		int _pad_x;
+		int _pad_y;
+		float _lower;
+		float _upper;
+	};
+
+	//output = clamp(input * scale[c] + shift[c]), one plane per index: batch norm and the clamping activations
+	//nullptr scale and shift are the identity, a nullptr output runs in place
+	class AVX2ChannelAffineKernel : public INEKernel{
+	public:
+		AVX2ChannelAffineKernel();
+		AVX2ChannelAffineKernel(const AVX2ChannelAffineKernel &) = delete;
+		AVX2ChannelAffineKernel &operator=(const AVX2ChannelAffineKernel &) = delete;
+
+		const char * name() const override { return "AVX2ChannelAffineKernel"; }
+		//scale and shift hold one value per channel and must outlive the kernel
+		void configure(const ITensor * input, ITensor * output, const float * scale, const float * shift, const ActivationLayerInfo &act_info);
+		void run(const Window &window, const ThreadInfo &info) override;
+
+	private:
+		const ITensor * _input;
+		ITensor * _output;
+		const float * _scale;
+		const float * _shift;
+		float _lower;
+		float _upper;
+	};
+
+	//Max and average pooling, one plane per index: the rows of a window are combined first, then the columns
+	//The average divides by the window clipped to the padded input, as NEPoolingLayer does without exclude_padding
+	class AVX2PoolingKernel : public INEKernel{
+	public:
+		AVX2PoolingKernel();
+		AVX2PoolingKernel(const AVX2PoolingKernel &) = delete;
+		AVX2PoolingKernel &operator=(const AVX2PoolingKernel &) = delete;
+
+		const char * name() const override { return "AVX2PoolingKernel"; }
+		void configure(const ITensor * input, ITensor * output, PoolingType type, int pool_size, int stride, int padding);
+		void run(const Window &window, const ThreadInfo &info) override;
+
+	private:
+		const ITensor * _input;
+		ITensor * _output;
+		PoolingType _type;
+		int _pool_size;
+		int _stride;
+		int _padding;
+	};
+
+	//One channel of src copied into one channel of dst, for every image of the batch
+	struct ChannelCopy{
+		const ITensor * src;
+		int src_channel;
+		ITensor * dst;
+		int dst_channel;
+	};
+
+	//Channel shuffle, split and concatenation are all lists of plane copies, one copy per index
+	class AVX2ChannelCopyKernel : public INEKernel{
+	public:
+		AVX2ChannelCopyKernel();
+
+		const char * name() const override { return "AVX2ChannelCopyKernel"; }
+		//Every src and dst has the same width, height and batch
+		void configure(const std::vector<ChannelCopy> &copies);
+		void run(const Window &window, const ThreadInfo &info) override;
+
+	private:
+		std::vector<ChannelCopy> _copies;
+	};
+
+	//Mean over width and height, one plane per index, the output is (1, 1, C, N)
+	class AVX2ReduceMeanKernel : public INEKernel{
+	public:
+		AVX2ReduceMeanKernel();
+		AVX2ReduceMeanKernel(const AVX2ReduceMeanKernel &) = delete;
+		AVX2ReduceMeanKernel &operator=(const AVX2ReduceMeanKernel &) = delete;
+
+		const char * name() const override { return "AVX2ReduceMeanKernel"; }
+		void configure(const ITensor * input, ITensor * output);
+		void run(const Window &window, const ThreadInfo &info) override;
+
+	private:
+		const ITensor * _input;
+		ITensor * _output;
+	};
+
+	//output(o, n) = weights row o . input image n + biases(o), one output neuron per index for the whole batch
+	//weights are (in, out) and the input holds in values per image, both without padding
+	class AVX2FullyConnectedKernel : public INEKernel{
+	public:
+		AVX2FullyConnectedKernel();
+		AVX2FullyConnectedKernel(const AVX2FullyConnectedKernel &) = delete;
+		AVX2FullyConnectedKernel &operator=(const AVX2FullyConnectedKernel &) = delete;
+
+		const char * name() const override { return "AVX2FullyConnectedKernel"; }
+		void configure(const ITensor * input, const ITensor * weights, const ITensor * biases, ITensor * output);
+		void run(const Window &window, const ThreadInfo &info) override;
+
+	private:
+		const ITensor * _input;
+		const ITensor * _weights;
+		const ITensor * _biases;
+		ITensor * _output;
+	};
+
+	//Runs one configured kernel on the scheduler and owns it
+	class AVX2Function : public IFunction{
+	public:
+		explicit AVX2Function(INEKernel * kernel);
+		AVX2Function(const AVX2Function &) = delete;
+		AVX2Function &operator=(const AVX2Function &) = delete;
+
+		void run() override;
+
+	private:
+		std::unique_ptr<INEKernel> _kernel;
+	};
+
+	//Batch norm from its mean, variance, beta and gamma tensors
+	//prepare() turns them into a scale and shift per channel once they are filled, then marks them unused
+	class AVX2BatchNormalization : public IFunction{
+	public:
+		AVX2BatchNormalization();
+		AVX2BatchNormalization(const AVX2BatchNormalization &) = delete;
+		AVX2BatchNormalization &operator=(const AVX2BatchNormalization &) = delete;
+
+		void configure(const ITensor * input, ITensor * output, const ITensor * mean, const ITensor * var,
+					   const ITensor * beta, const ITensor * gamma, float epsilon, const ActivationLayerInfo &act_info);
+		void prepare() override;
+		void run() override;
+
+	private:
+		const ITensor * _mean;
+		const ITensor * _var;
+		const ITensor * _beta;
+		const ITensor * _gamma;
+		float _epsilon;
+		bool _prepared;
+		std::vector<float> _scale;
+		std::vector<float> _shift;
+		AVX2ChannelAffineKernel _kernel;
+	};
+
+ }
+
+
+#endif
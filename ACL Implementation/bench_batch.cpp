@@ -0,0 +1,66 @@
+#include "network.h"
+#include "modelZoo.h"
+#include <chrono>
+#include <arm_compute/runtime/Scheduler.h>
+
+#include <algorithm>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace arm_compute;
+using namespace std;
+
+//Throughput of one model against the batch size, batch 1, 2, 4, ... up to the largest one asked for
+//A batch reads every weight once for all its images, the larger GEMMs also keep the cores busier
+
+static double medianLatency(opGraph::Network &network, int iterations){
+	network.run();
+	vector<double> latency;
+	for(int i = 0; i < iterations; i++)
+	{
+		auto beginTime = std::chrono::steady_clock::now();
+		network.run();
+		latency.push_back(std::chrono::duration<double,std::milli>(std::chrono::steady_clock::now() - beginTime).count());
+	}
+	std::sort(latency.begin(), latency.end());
+	return latency[latency.size() / 2];
+}
+
+int main (int argc, char **argv)
+{
+	if(argc > 5)
+	{
+		std::cout<<"Usage: ./bench_batch [model(resnet50)] [numberThread(4)] [numberIteration(10)] [max batch(16)]"<<std::endl;
+		return 0;
+	}
+	const string model = argc > 1 ? argv[1] : "resnet50";
+	arm_compute::Scheduler::get().set_num_threads(argc > 2 ? atoi(argv[2]) : 4);
+	const int iterations = std::max(argc > 3 ? atoi(argv[3]) : 10, 1);
+	const int max_batch = std::max(argc > 4 ? atoi(argv[4]) : 16, 1);
+
+	opGraph::Graph graph;
+	opGraph::buildModel(graph, model);
+
+	std::cout << std::fixed << std::setprecision(3);
+	std::cout << model << std::endl;
+	std::cout << "batch  latency ms  ms/image  images/s  vs batch 1  activations MB" << std::endl;
+	double single = 0;
+	for(int batch = 1; batch <= max_batch; batch *= 2)
+	{
+		opGraph::CompileOptions options;
+		options.batch = batch;
+		opGraph::Network network(graph, options);
+		const double ms = medianLatency(network, iterations);
+		const double throughput = batch * 1000.0 / ms;
+		if(batch == 1)
+		{
+			single = throughput;
+		}
+		std::cout << std::setw(5) << batch << "  " << std::setw(10) << ms << "  " << std::setw(8) << ms / batch << "  "
+				  << std::setw(8) << throughput << "  " << std::setw(9) << throughput / single << "x  "
+				  << network.memoryPlanner().plannedBytes() / 1048576.0 << std::endl;
+	}
+	return 0;
+}
@@ -0,0 +1,114 @@
+#include "network.h"
+#include <chrono>
+#include <arm_compute/runtime/Scheduler.h>
+
+#include <algorithm>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+using namespace arm_compute;
+using namespace std;
+
+//Tail of a ResNet bottleneck, conv -> BN -> add(shortcut) -> ReLU, at the four stage sizes of ResNet-50
+//Three lowerings of the same block:
+//  separate   BN, Add and an in-place ReLU, three passes over the output after the conv
+//  fused      BN, Add and ReLU in the fused epilogue, one pass
+//  folded     BN merged into the conv weights (the default), the epilogue is Add and ReLU in one pass
+//Only the layers after the conv are timed, the conv is the same in every lowering
+
+struct BlockShape{
+	int size;
+	int channels;
+};
+
+struct EpilogueCost{
+	double ms;
+	size_t bytes;
+	size_t layers;
+};
+
+static EpilogueCost measure(opGraph::Network &network, int iterations){
+	EpilogueCost cost = { 0, 0, 0 };
+	const vector<opGraph::Layer> &layers = network.layers();
+	for(size_t l = 0; l < layers.size(); l++)
+	{
+		if(layers[l].type == opGraph::OpType::Conv)
+		{
+			continue;
+		}
+		cost.layers++;
+		for(size_t i = 0; i < layers[l].inputs.size(); i++)
+		{
+			cost.bytes += layers[l].inputs[i]->info()->total_size();
+		}
+		for(size_t o = 0; o < layers[l].outputs.size(); o++)
+		{
+			cost.bytes += layers[l].outputs[o]->info()->total_size();
+		}
+	}
+
+	network.run();
+	vector<double> latency;
+	for(int i = 0; i < iterations; i++)
+	{
+		double ms = 0;
+		for(size_t l = 0; l < layers.size(); l++)
+		{
+			auto beginTime = std::chrono::steady_clock::now();
+			layers[l].run();
+			if(layers[l].type != opGraph::OpType::Conv)
+			{
+				ms += std::chrono::duration<double,std::milli>(std::chrono::steady_clock::now() - beginTime).count();
+			}
+		}
+		latency.push_back(ms);
+	}
+	std::sort(latency.begin(), latency.end());
+	cost.ms = latency[latency.size() / 2];
+	return cost;
+}
+
+int main (int argc, char **argv)
+{
+	if(argc > 3)
+	{
+		std::cout<<"Usage: ./bench_epilogue [numberThread(4)] [numberIteration(50)]"<<std::endl;
+		return 0;
+	}
+	arm_compute::Scheduler::get().set_num_threads(argc > 1 ? atoi(argv[1]) : 4);
+	const int iterations = std::max(argc > 2 ? atoi(argv[2]) : 50, 1);
+
+	const BlockShape shapes[] = { { 56, 256 }, { 28, 512 }, { 14, 1024 }, { 7, 2048 } };
+
+	std::cout << std::fixed << std::setprecision(3);
+	std::cout << "block           lowering   layers  epilogue ms  traffic MB  vs separate (time, traffic)" << std::endl;
+	for(const BlockShape &shape : shapes)
+	{
+		opGraph::Graph graph;
+		const int x = graph.input("input", shape.size, shape.size, shape.channels);
+		const int y = graph.bn(graph.conv(x, "conv2", shape.channels, 1, 1, 0), "bn2");
+		graph.setOutput(graph.add(y, x, "add", true));
+
+		opGraph::CompileOptions options;
+		options.fold_bn = false;
+		options.fuse_epilogue = false;
+		opGraph::Network separate(graph, options);
+		options.fuse_epilogue = true;
+		opGraph::Network fused(graph, options);
+		options.fold_bn = true;
+		opGraph::Network folded(graph, options);
+
+		const EpilogueCost base = measure(separate, iterations);
+		const EpilogueCost costs[] = { base, measure(fused, iterations), measure(folded, iterations) };
+		const char * names[] = { "separate", "fused", "folded" };
+		for(int i = 0; i < 3; i++)
+		{
+			std::cout << std::setw(4) << shape.size << "x" << shape.size << "x" << std::setw(4) << shape.channels << "    "
+					  << std::setw(8) << names[i] << "  " << std::setw(6) << costs[i].layers << "  "
+					  << std::setw(11) << costs[i].ms << "  " << std::setw(10) << costs[i].bytes / 1048576.0 << "  "
+					  << std::setw(6) << base.ms / costs[i].ms << "x, " << static_cast<double>(base.bytes) / costs[i].bytes << "x" << std::endl;
+		}
+	}
+	return 0;
+}
@@ -0,0 +1,116 @@
+#include "dataLoader.h"
+#include "arm_compute/runtime/Tensor.h"
+
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace arm_compute;
+using namespace utils;
+using namespace std;
+
+//Write a width x height binary PPM with a deterministic pattern
+static void writeFrame(const string &filename, int width, int height)
+{
+	ofstream fs(filename, ios::out | ios::binary | ios::trunc);
+	fs << "P6\n" << width << " " << height << "\n255\n";
+	vector<char> row(static_cast<size_t>(width) * 3);
+	for(int y = 0; y < height; y++)
+	{
+		for(size_t i = 0; i < row.size(); i++)
+		{
+			row[i] = static_cast<char>((i * 7 + static_cast<size_t>(y) * 13) & 0xFF);
+		}
+		fs.write(row.data(), row.size());
+	}
+}
+
+//Average ms per frame of open + fill + close, bytewise selects the former per-byte loop
+static double timeFill(const string &filename, Tensor &image, int iterations, bool bytewise)
+{
+	auto beginTime = std::chrono::steady_clock::now();
+	for(int i = 0; i < iterations; i++)
+	{
+		pmLoader ppm;
+		ppm.open(filename);
+		if(bytewise)
+		{
+			ppm.fill_image_bytewise(image);
+		}
+		else
+		{
+			ppm.fill_image(image);
+		}
+		ppm.close();
+	}
+	auto endTime = std::chrono::steady_clock::now();
+	return std::chrono::duration<double,std::milli>(endTime - beginTime).count() / iterations;
+}
+
+//Both paths read the same bytes, check the planar result against the file directly
+static bool checkPlanar(const string &filename, const Tensor &image, int width, int height)
+{
+	ifstream fs(filename, ios::in | ios::binary);
+	string magic;
+	int w = 0, h = 0, max_val = 0;
+	fs >> magic >> w >> h >> max_val;
+	fs.get();
+	vector<unsigned char> data(static_cast<size_t>(width) * height * 3);
+	fs.read(reinterpret_cast<char *>(data.data()), data.size());
+
+	const Strides &strides = image.info()->strides_in_bytes();
+	const uint8_t * base = image.buffer() + image.info()->offset_first_element_in_bytes();
+	for(int y = 0; y < height; y++)
+	{
+		for(int x = 0; x < width; x++)
+		{
+			for(int c = 0; c < 3; c++)
+			{
+				const float value = *reinterpret_cast<const float *>(base + x * strides[0] + y * strides[1] + c * strides[2]);
+				if(value != image_scale * data[(static_cast<size_t>(y) * width + x) * 3 + c])
+				{
+					return false;
+				}
+			}
+		}
+	}
+	return true;
+}
+
+int main (int argc, char **argv)
+{
+	if(argc > 2)
+	{
+		std::cout<<"Usage: ./bench_fill_image [iterations(20)]"<<std::endl;
+		return 0;
+	}
+	const int iterations = argc > 1 ? atoi(argv[1]) : 20;
+
+	const int sizes[2][2] = { { 224, 224 }, { 1920, 1080 } };
+	for(int s = 0; s < 2; s++)
+	{
+		const int width = sizes[s][0];
+		const int height = sizes[s][1];
+		const string filename = "/tmp/bench_fill_image_" + to_string(width) + "x" + to_string(height) + ".ppm";
+		writeFrame(filename, width, height);
+
+		Tensor image;
+		image.allocator()->init(TensorInfo(TensorShape(width, height, 3), Format::F32));
+		image.allocator()->allocate();
+
+		//One untimed pass each so the file sits in the page cache for both
+		timeFill(filename, image, 1, true);
+		const double bytewise = timeFill(filename, image, iterations, true);
+		timeFill(filename, image, 1, false);
+		const double rowwise = timeFill(filename, image, iterations, false);
+		const bool valid = checkPlanar(filename, image, width, height);
+
+		std::cout << width << "x" << height << ": per-byte " << bytewise << " ms/frame, row " << rowwise << " ms/frame, "
+				  << bytewise / rowwise << "x, planar output " << (valid ? "matches" : "MISMATCH") << std::endl;
+		remove(filename.c_str());
+	}
+	return 0;
+}
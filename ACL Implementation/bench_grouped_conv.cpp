@@ -0,0 +1,73 @@
+#include "network.h"
+#include <chrono>
+#include <arm_compute/runtime/Scheduler.h>
+
+#include <algorithm>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+using namespace arm_compute;
+using namespace std;
+
+//Grouped convolution on channel views against the split + dense convs + concat emulation
+//Every shape has 240 or 480 channels so that it divides by all the group counts
+
+struct ConvShape{
+	int size;
+	int channels;
+	int kernel;
+};
+
+static double medianLatency(opGraph::Network &network, int iterations){
+	network.run();
+	vector<double> latency;
+	for(int i = 0; i < iterations; i++)
+	{
+		auto beginTime = std::chrono::steady_clock::now();
+		network.run();
+		latency.push_back(std::chrono::duration<double,std::milli>(std::chrono::steady_clock::now() - beginTime).count());
+	}
+	std::sort(latency.begin(), latency.end());
+	return latency[latency.size() / 2];
+}
+
+int main (int argc, char **argv)
+{
+	if(argc > 3)
+	{
+		std::cout<<"Usage: ./bench_grouped_conv [numberThread(4)] [numberIteration(50)]"<<std::endl;
+		return 0;
+	}
+	arm_compute::Scheduler::get().set_num_threads(argc > 1 ? atoi(argv[1]) : 4);
+	const int iterations = std::max(argc > 2 ? atoi(argv[2]) : 50, 1);
+
+	const ConvShape shapes[] = { { 56, 240, 1 }, { 28, 240, 3 }, { 14, 480, 1 }, { 14, 480, 3 } };
+	const int groups[] = { 2, 3, 4, 8 };
+
+	std::cout << std::fixed << std::setprecision(3);
+	std::cout << "shape          groups  split+concat ms  views ms  speedup  activations MB (split, views)" << std::endl;
+	for(const ConvShape &shape : shapes)
+	{
+		for(int g : groups)
+		{
+			opGraph::Graph graph;
+			const int x = graph.input("input", shape.size, shape.size, shape.channels);
+			graph.setOutput(graph.conv(x, "conv", shape.channels, shape.kernel, 1, shape.kernel / 2, g, true));
+
+			opGraph::CompileOptions options;
+			options.grouped_views = false;
+			opGraph::Network emulated(graph, options);
+			options.grouped_views = true;
+			opGraph::Network views(graph, options);
+
+			const double emulated_ms = medianLatency(emulated, iterations);
+			const double views_ms = medianLatency(views, iterations);
+			std::cout << shape.size << "x" << shape.size << "x" << shape.channels << " k" << shape.kernel << "  "
+					  << std::setw(6) << g << "  " << std::setw(15) << emulated_ms << "  " << std::setw(8) << views_ms << "  "
+					  << std::setw(6) << emulated_ms / views_ms << "x  "
+					  << emulated.memoryPlanner().plannedBytes() / 1048576.0 << ", " << views.memoryPlanner().plannedBytes() / 1048576.0 << std::endl;
+		}
+	}
+	return 0;
+}
@@ -0,0 +1,457 @@
+#include "network.h"
+#include "modelZoo.h"
+#include <chrono>
+#include <arm_compute/runtime/Scheduler.h>
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace arm_compute;
+using namespace std;
+
+//Every operator of the synthetic wrappers on its own, over the layer shapes of the given models and a range of thread counts
+//The shapes are taken from the graphs as built, before any folding, so each BN, shuffle and grouped conv has its own entry
+//A grouped conv also gives the split and concat the network lowers it into when channel views are off
+//GFLOP/s counts multiply and add as two operations, GB/s the compulsory traffic: every input, output and parameter once
+//Results go to a CSV file, compare mode flags the cases that got slower between two of them
+
+struct OpCase{
+	opGraph::OpType type;
+	int w;
+	int h;
+	int c;					//input channels, the sum of parts for a concat
+	int kernel;
+	int stride;
+	int padding;
+	int channels;			//output channels of Conv and FC
+	int groups;				//Conv, ChannelShuffle and Split
+	std::vector<int> parts;	//channels of every Concat input
+	std::string model;		//first model with this shape
+};
+
+//One configured layer and everything it reads and writes
+struct Instance{
+	std::vector<std::unique_ptr<Tensor>> inputs;
+	std::vector<std::unique_ptr<Tensor>> outputs;
+	std::vector<std::unique_ptr<Tensor>> parameters;
+	std::unique_ptr<IFunction> function;
+
+	Instance()
+		: inputs(), outputs(), parameters(), function()
+	{
+	}
+};
+
+struct Result{
+	double ms;
+	double gflops;
+	double gbs;
+};
+
+static int outputSize(int input, int kernel, int stride, int padding){
+	return (input + 2 * padding - kernel) / stride + 1;
+}
+
+static string shapeKey(const OpCase &op){
+	std::ostringstream os;
+	switch(op.type)
+	{
+		case opGraph::OpType::Conv:
+		case opGraph::OpType::DWConv:
+			os << op.kernel << "x" << op.kernel << " s" << op.stride << " p" << op.padding << " " << op.w << "x" << op.h << "x" << op.c;
+			if(op.type == opGraph::OpType::Conv)
+			{
+				os << "->" << op.channels;
+			}
+			if(op.groups > 1)
+			{
+				os << " g" << op.groups;
+			}
+			break;
+		case opGraph::OpType::Concat:
+			os << op.w << "x" << op.h << "x";
+			for(size_t i = 0; i < op.parts.size(); i++)
+			{
+				os << (i > 0 ? "+" : "") << op.parts[i];
+			}
+			break;
+		case opGraph::OpType::FC:
+			os << op.c << "->" << op.channels;
+			break;
+		default:
+			os << op.w << "x" << op.h << "x" << op.c;
+			if(op.groups > 1)
+			{
+				os << " g" << op.groups;
+			}
+			break;
+	}
+	return os.str();
+}
+
+static void addCase(vector<OpCase> &cases, std::map<string, size_t> &seen, const OpCase &op){
+	const string key = string(opGraph::opName(op.type)) + " " + shapeKey(op);
+	if(seen.count(key) == 0)
+	{
+		seen[key] = cases.size();
+		cases.push_back(op);
+	}
+}
+
+static vector<OpCase> shapeTable(const vector<string> &models){
+	vector<OpCase> cases;
+	std::map<string, size_t> seen;
+	for(size_t m = 0; m < models.size(); m++)
+	{
+		opGraph::Graph graph;
+		opGraph::buildModel(graph, models[m]);
+		const vector<opGraph::Node> &nodes = graph.nodes();
+		for(size_t n = 0; n < nodes.size(); n++)
+		{
+			const opGraph::Node &node = nodes[n];
+			if(node.inputs.empty())
+			{
+				continue;
+			}
+			const opGraph::Edge &in = graph.edge(node.inputs[0]);
+			OpCase op = { node.type, in.w, in.h, in.c, node.kernel, node.stride, node.padding, node.channels, node.groups, {}, models[m] };
+			switch(node.type)
+			{
+				case opGraph::OpType::Conv:
+					addCase(cases, seen, op);
+					if(node.groups > 1)
+					{
+						//What the grouped conv becomes without channel views
+						OpCase split = op;
+						split.type = opGraph::OpType::Split;
+						addCase(cases, seen, split);
+						const opGraph::Edge &out = graph.edge(node.outputs[0]);
+						OpCase concat = { opGraph::OpType::Concat, out.w, out.h, out.c, 1, 1, 0, 0, 1, std::vector<int>(node.groups, out.c / node.groups), models[m] };
+						addCase(cases, seen, concat);
+					}
+					break;
+				case opGraph::OpType::Concat:
+					op.c = 0;
+					for(size_t i = 0; i < node.inputs.size(); i++)
+					{
+						op.parts.push_back(graph.edge(node.inputs[i]).c);
+						op.c += op.parts.back();
+					}
+					addCase(cases, seen, op);
+					break;
+				case opGraph::OpType::FC:
+					op.c = static_cast<int>(in.elements());
+					addCase(cases, seen, op);
+					break;
+				case opGraph::OpType::DWConv:
+				case opGraph::OpType::BN:
+				case opGraph::OpType::ChannelShuffle:
+				case opGraph::OpType::Split:
+				case opGraph::OpType::ReduceMean:
+					addCase(cases, seen, op);
+					break;
+				default:
+					break;
+			}
+		}
+	}
+	return cases;
+}
+
+static Tensor * newActivation(Instance &instance, int w, int h, int c, int batch){
+	instance.inputs.emplace_back(opWrapper::configure4DTensor(w, h, c, batch));
+	return instance.inputs.back().get();
+}
+
+static Tensor * newOutput(Instance &instance){
+	instance.outputs.emplace_back(new Tensor());
+	return instance.outputs.back().get();
+}
+
+static void zero(Tensor * tensor){
+	if(tensor->buffer() != nullptr)
+	{
+		memset(tensor->buffer(), 0, tensor->info()->total_size());
+	}
+}
+
+//The layer is lowered as Network does it, the inputs are allocated last so the layer could extend their padding
+static void configure(const OpCase &op, int batch, Instance &instance){
+	opWrapper::setParameterOwner(&instance.parameters);
+	const ActivationLayerInfo none;
+	switch(op.type)
+	{
+		case opGraph::OpType::Conv:
+		{
+			Tensor * input = newActivation(instance, op.w, op.h, op.c, batch);
+			Tensor * output = newOutput(instance);
+			if(op.groups == 1)
+			{
+				instance.function.reset(opWrapper::ConvolutionLayer(input, output, op.stride, op.padding, op.kernel, op.kernel, op.c, op.channels, none));
+				break;
+			}
+			output->allocator()->init(TensorInfo(TensorShape(outputSize(op.w, op.kernel, op.stride, op.padding), outputSize(op.h, op.kernel, op.stride, op.padding),
+															 op.channels, batch), 1, DataType::F32));
+			instance.function.reset(opWrapper::GroupedConvolutionLayer(input, output, op.stride, op.padding, op.kernel, op.kernel, op.groups, false, none));
+			break;
+		}
+		case opGraph::OpType::DWConv:
+		{
+			Tensor * input = newActivation(instance, op.w, op.h, op.c, batch);
+			instance.function.reset(opWrapper::DWConvolutionLayer(input, newOutput(instance), op.stride, op.padding, op.kernel, op.kernel, op.c, none));
+			break;
+		}
+		case opGraph::OpType::BN:
+		{
+			Tensor * input = newActivation(instance, op.w, op.h, op.c, batch);
+			instance.function.reset(opWrapper::BNLayer(input, newOutput(instance), op.c, none));
+			break;
+		}
+		case opGraph::OpType::ChannelShuffle:
+		{
+			Tensor * input = newActivation(instance, op.w, op.h, op.c, batch);
+			instance.function.reset(opWrapper::CSLayer(input, newOutput(instance), op.groups));
+			break;
+		}
+		case opGraph::OpType::Split:
+		{
+			Tensor * input = newActivation(instance, op.w, op.h, op.c, batch);
+			vector<ITensor *> outputs;
+			for(int g = 0; g < op.groups; g++)
+			{
+				outputs.push_back(newOutput(instance));
+			}
+			instance.function.reset(opWrapper::SplitLayer(input, outputs, 2));
+			//SplitLayer leaves the outputs to the caller
+			for(size_t o = 0; o < instance.outputs.size(); o++)
+			{
+				opWrapper::allocateOutput(instance.outputs[o].get());
+			}
+			break;
+		}
+		case opGraph::OpType::Concat:
+		{
+			vector<ITensor *> inputs;
+			for(size_t i = 0; i < op.parts.size(); i++)
+			{
+				inputs.push_back(newActivation(instance, op.w, op.h, op.parts[i], batch));
+			}
+			instance.function.reset(opWrapper::ConcatLayer(inputs, newOutput(instance)));
+			break;
+		}
+		case opGraph::OpType::ReduceMean:
+		{
+			Tensor * input = newActivation(instance, op.w, op.h, op.c, batch);
+			instance.function.reset(opWrapper::ReduceMeanLayer(input, newOutput(instance), Coordinates(0, 1)));
+			break;
+		}
+		case opGraph::OpType::FC:
+		{
+			Tensor * input = newActivation(instance, 1, 1, op.c, batch);
+			instance.function.reset(opWrapper::FullyConnectedLayer(input, newOutput(instance), op.c, op.channels));
+			break;
+		}
+		default:
+			ARM_COMPUTE_ERROR("%s is not benchmarked", opGraph::opName(op.type));
+	}
+	opWrapper::setParameterOwner(nullptr);
+	for(size_t i = 0; i < instance.inputs.size(); i++)
+	{
+		instance.inputs[i]->allocator()->allocate();
+		zero(instance.inputs[i].get());
+	}
+	//Synthetic parameters are never filled, keep denormals and NaN out of the timings
+	for(size_t p = 0; p < instance.parameters.size(); p++)
+	{
+		zero(instance.parameters[p].get());
+	}
+}
+
+static double flops(const OpCase &op, int batch){
+	const double images = batch;
+	switch(op.type)
+	{
+		case opGraph::OpType::Conv:
+		{
+			const double pixels = static_cast<double>(outputSize(op.w, op.kernel, op.stride, op.padding)) * outputSize(op.h, op.kernel, op.stride, op.padding);
+			return 2.0 * op.kernel * op.kernel * (op.c / op.groups) * op.channels * pixels * images;
+		}
+		case opGraph::OpType::DWConv:
+		{
+			const double pixels = static_cast<double>(outputSize(op.w, op.kernel, op.stride, op.padding)) * outputSize(op.h, op.kernel, op.stride, op.padding);
+			return 2.0 * op.kernel * op.kernel * op.c * pixels * images;
+		}
+		case opGraph::OpType::BN:
+			return 2.0 * op.w * op.h * op.c * images;
+		case opGraph::OpType::ReduceMean:
+			return static_cast<double>(op.w) * op.h * op.c * images;
+		case opGraph::OpType::FC:
+			return 2.0 * op.c * op.channels * images;
+		default:
+			return 0;
+	}
+}
+
+static size_t bytes(const vector<std::unique_ptr<Tensor>> &tensors){
+	size_t total = 0;
+	for(size_t t = 0; t < tensors.size(); t++)
+	{
+		total += tensors[t]->info()->tensor_shape().total_size() * tensors[t]->info()->element_size();
+	}
+	return total;
+}
+
+static Result measure(const OpCase &op, int batch, int iterations){
+	Instance instance;
+	configure(op, batch, instance);
+	const size_t traffic = bytes(instance.inputs) + bytes(instance.outputs) + bytes(instance.parameters);
+	//The first run prepares the weights and is not counted
+	instance.function->run();
+	vector<double> latency;
+	for(int i = 0; i < iterations; i++)
+	{
+		auto beginTime = std::chrono::steady_clock::now();
+		instance.function->run();
+		latency.push_back(std::chrono::duration<double,std::milli>(std::chrono::steady_clock::now() - beginTime).count());
+	}
+	std::sort(latency.begin(), latency.end());
+	const double ms = latency[latency.size() / 2];
+	Result result = { ms, flops(op, batch) / ms / 1e6, traffic / ms / 1e6 };
+	return result;
+}
+
+static vector<string> splitList(const string &list, char separator){
+	vector<string> items;
+	std::istringstream is(list);
+	string item;
+	while(std::getline(is, item, separator))
+	{
+		items.push_back(item);
+	}
+	return items;
+}
+
+//op,shape,threads,batch -> ms
+static std::map<string, double> readResults(const string &filename){
+	std::map<string, double> results;
+	std::ifstream fs(filename);
+	if(!fs.is_open())
+	{
+		std::cout << "Cannot read " << filename << std::endl;
+		return results;
+	}
+	string line;
+	std::getline(fs, line);
+	while(std::getline(fs, line))
+	{
+		const vector<string> fields = splitList(line, ',');
+		if(fields.size() < 5)
+		{
+			continue;
+		}
+		results[fields[0] + "," + fields[1] + "," + fields[2] + "," + fields[3]] = atof(fields[4].c_str());
+	}
+	return results;
+}
+
+//Exit status 1 when any case shared by both files is slower than threshold allows
+static int compare(const string &base_file, const string &new_file, double threshold){
+	const std::map<string, double> base = readResults(base_file);
+	const std::map<string, double> next = readResults(new_file);
+	int regressions = 0;
+	int improvements = 0;
+	int shared = 0;
+	std::cout << std::fixed << std::setprecision(3);
+	for(std::map<string, double>::const_iterator it = base.begin(); it != base.end(); ++it)
+	{
+		std::map<string, double>::const_iterator other = next.find(it->first);
+		if(other == next.end())
+		{
+			continue;
+		}
+		shared++;
+		const double change = other->second / it->second - 1;
+		if(change > threshold)
+		{
+			regressions++;
+			std::cout << "REGRESSION  ";
+		}
+		else if(change < -threshold)
+		{
+			improvements++;
+			std::cout << "improved    ";
+		}
+		else
+		{
+			continue;
+		}
+		std::cout << std::left << std::setw(56) << it->first << std::right << std::setw(10) << it->second << " -> " << std::setw(10) << other->second
+				  << " ms  " << std::showpos << change * 100 << std::noshowpos << "%" << std::endl;
+	}
+	std::cout << shared << " cases in both files, " << regressions << " slower and " << improvements << " faster by more than "
+			  << threshold * 100 << "%" << std::endl;
+	return regressions > 0 ? 1 : 0;
+}
+
+int main (int argc, char **argv)
+{
+	if(argc > 1 && string(argv[1]) == "compare")
+	{
+		if(argc < 4 || argc > 5)
+		{
+			std::cout<<"Usage: ./bench_ops compare [base.csv] [new.csv] [threshold(0.1)]"<<std::endl;
+			return 0;
+		}
+		return compare(argv[2], argv[3], argc > 4 ? atof(argv[4]) : 0.1);
+	}
+	if(argc > 6)
+	{
+		std::cout<<"Usage: ./bench_ops [threads(1,2,4)] [models(resnet50,shufflenetv1_g3_1.0x)] [results(bench_ops.csv)] [batch(1)] [numberIteration(20)]"<<std::endl;
+		std::cout<<"       ./bench_ops compare [base.csv] [new.csv] [threshold(0.1)]"<<std::endl;
+		return 0;
+	}
+	const vector<string> threads = splitList(argc > 1 ? argv[1] : "1,2,4", ',');
+	const vector<string> models = splitList(argc > 2 ? argv[2] : "resnet50,shufflenetv1_g3_1.0x", ',');
+	const string results = argc > 3 ? argv[3] : "bench_ops.csv";
+	const int batch = std::max(argc > 4 ? atoi(argv[4]) : 1, 1);
+	const int iterations = std::max(argc > 5 ? atoi(argv[5]) : 20, 1);
+
+	const vector<OpCase> cases = shapeTable(models);
+	std::ofstream fs(results, std::ios::out | std::ios::trunc);
+	if(!fs.is_open())
+	{
+		std::cout << "Cannot write " << results << std::endl;
+		return 1;
+	}
+	fs << "op,shape,threads,batch,ms,gflops,gbs,model" << std::endl;
+
+	std::cout << cases.size() << " layer shapes, batch " << batch << ", median of " << iterations << " runs" << std::endl;
+	std::cout << std::fixed << std::setprecision(3);
+	for(size_t t = 0; t < threads.size(); t++)
+	{
+		arm_compute::Scheduler::get().set_num_threads(std::max(atoi(threads[t].c_str()), 1));
+		const unsigned int num_threads = arm_compute::Scheduler::get().num_threads();
+		std::cout << std::endl << num_threads << " threads" << std::endl;
+		std::cout << "op              shape                                   ms     GFLOP/s     GB/s" << std::endl;
+		for(size_t i = 0; i < cases.size(); i++)
+		{
+			const string op = opGraph::opName(cases[i].type);
+			const string shape = shapeKey(cases[i]);
+			const Result result = measure(cases[i], batch, iterations);
+			std::cout << std::left << std::setw(16) << op << std::setw(32) << shape << std::right << std::setw(10) << result.ms
+					  << std::setw(12) << result.gflops << std::setw(9) << result.gbs << std::endl;
+			fs << op << "," << shape << "," << num_threads << "," << batch << "," << result.ms << "," << result.gflops << "," << result.gbs
+			   << "," << cases[i].model << std::endl;
+		}
+	}
+	std::cout << std::endl << "Results written to " << results << std::endl;
+	return 0;
+}
@@ -0,0 +1,65 @@
+#include "network.h"
+#include "modelZoo.h"
+#include <chrono>
+
+#include <cstdio>
+#include <iomanip>
+#include <iostream>
+#include <string>
+
+using namespace arm_compute;
+using namespace std;
+
+//Time to first inference: building the Network (parameters loaded, folded, shuffled, narrowed, functions configured
+//and prepared, which reshapes the convolution weights) plus the first run, from the NPY files or bundle and from the warm cache
+//A cold start writes the cache, a warm start reads it back
+
+static void startup(const opGraph::Graph &graph, const opGraph::CompileOptions &options, const string &label){
+	auto beginTime = std::chrono::steady_clock::now();
+	opGraph::Network network(graph, options);
+	auto builtTime = std::chrono::steady_clock::now();
+	network.run();
+	auto firstTime = std::chrono::steady_clock::now();
+	network.run();
+	auto secondTime = std::chrono::steady_clock::now();
+
+	const double build = std::chrono::duration<double,std::milli>(builtTime - beginTime).count();
+	const double first = std::chrono::duration<double,std::milli>(firstTime - builtTime).count();
+	const double second = std::chrono::duration<double,std::milli>(secondTime - firstTime).count();
+	std::cout << std::fixed << std::setprecision(3);
+	std::cout << label << "  build " << build << " ms, first run " << first << " ms, time to first inference " << build + first
+			  << " ms (steady run " << second << " ms)" << std::endl;
+	network.printPrepare(std::cout);
+}
+
+int main (int argc, char **argv)
+{
+	if(argc < 4 || argc > 7)
+	{
+		std::cout<<"Usage: ./bench_startup [data_path] [model(resnet50)] [cache] [mode(both|cold|warm)] [bundle] [fp16(0)]"<<std::endl;
+		return 0;
+	}
+	const string model = argv[2];
+	const string cache = argv[3];
+	const string mode = argc > 4 ? argv[4] : "both";
+
+	opGraph::Graph graph;
+	opGraph::buildModel(graph, model);
+
+	opGraph::CompileOptions options;
+	options.data_path = argv[1];
+	options.weight_bundle = argc > 5 ? argv[5] : "";
+	options.fp16 = argc > 6 && atoi(argv[6]) != 0;
+	options.warm_cache = cache;
+	if(mode != "warm")
+	{
+		//Cold: nothing prepared yet, the cache is written on the way
+		remove(cache.c_str());
+		startup(graph, options, "cold");
+	}
+	if(mode != "cold")
+	{
+		startup(graph, options, "warm");
+	}
+	return 0;
+}
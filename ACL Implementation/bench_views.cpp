@@ -0,0 +1,105 @@
+#include "network.h"
+#include "modelZoo.h"
+#include <chrono>
+#include <arm_compute/runtime/Scheduler.h>
+
+#include <algorithm>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <string>
+#include <vector>
+
+using namespace arm_compute;
+using namespace std;
+
+//Split and concat as copies against split outputs and concat inputs that are channel views (CompileOptions::split_concat_views)
+//A block is a node name without its last part, stage1_block0_concat is in stage1_block0 and layer1_split in layer1
+//Only the blocks holding a split or a concat are listed
+
+static string blockOf(const string &name){
+	const size_t sep = name.rfind('_');
+	return sep == string::npos ? name : name.substr(0, sep);
+}
+
+static double medianLatency(opGraph::Network &network, int iterations){
+	network.run();
+	vector<double> latency;
+	for(int i = 0; i < iterations; i++)
+	{
+		auto beginTime = std::chrono::steady_clock::now();
+		network.run();
+		latency.push_back(std::chrono::duration<double,std::milli>(std::chrono::steady_clock::now() - beginTime).count());
+	}
+	std::sort(latency.begin(), latency.end());
+	return latency[latency.size() / 2];
+}
+
+//Mean ms of every block over the iterations, layer by layer
+static std::map<string, double> blockLatency(opGraph::Network &network, int iterations){
+	std::map<string, double> blocks;
+	const vector<opGraph::Layer> &layers = network.layers();
+	for(int i = 0; i < iterations; i++)
+	{
+		for(size_t l = 0; l < layers.size(); l++)
+		{
+			auto beginTime = std::chrono::steady_clock::now();
+			layers[l].run();
+			const double ms = std::chrono::duration<double,std::milli>(std::chrono::steady_clock::now() - beginTime).count();
+			blocks[blockOf(network.graph().node(layers[l].node).name)] += ms / iterations;
+		}
+	}
+	return blocks;
+}
+
+int main (int argc, char **argv)
+{
+	if(argc > 4)
+	{
+		std::cout<<"Usage: ./bench_views [model(resnet50_s3_addchannel)] [numberThread(4)] [numberIteration(50)]"<<std::endl;
+		return 0;
+	}
+	const string model = argc > 1 ? argv[1] : "resnet50_s3_addchannel";
+	arm_compute::Scheduler::get().set_num_threads(argc > 2 ? atoi(argv[2]) : 4);
+	const int iterations = std::max(argc > 3 ? atoi(argv[3]) : 50, 1);
+
+	opGraph::Graph graph;
+	opGraph::buildModel(graph, model);
+
+	opGraph::CompileOptions options;
+	options.split_concat_views = false;
+	opGraph::Network copies(graph, options);
+	options.split_concat_views = true;
+	opGraph::Network views(graph, options);
+
+	std::cout << model << std::endl;
+	views.printViews(std::cout);
+	const double copies_mb = copies.memoryPlanner().plannedBytes() / 1048576.0;
+	const double views_mb = views.memoryPlanner().plannedBytes() / 1048576.0;
+	const double copies_ms = medianLatency(copies, iterations);
+	const double views_ms = medianLatency(views, iterations);
+	std::cout << std::fixed << std::setprecision(3);
+	std::cout << "activations MB: " << copies_mb << " copies, " << views_mb << " views, " << copies_mb - views_mb << " saved" << std::endl;
+	std::cout << "latency ms:     " << copies_ms << " copies, " << views_ms << " views, " << copies_ms / views_ms << "x" << std::endl;
+
+	//The graph after the load time passes, both networks hold the same one
+	std::map<string, bool> listed;
+	for(const opGraph::Node &node : views.graph().nodes())
+	{
+		if(node.type == opGraph::OpType::Split || node.type == opGraph::OpType::Concat)
+		{
+			listed[blockOf(node.name)] = true;
+		}
+	}
+	std::map<string, double> copies_blocks = blockLatency(copies, iterations);
+	std::map<string, double> views_blocks = blockLatency(views, iterations);
+	std::cout << std::endl << "block                      copies ms  views ms  saved ms" << std::endl;
+	for(const auto &block : listed)
+	{
+		const double c = copies_blocks[block.first];
+		const double v = views_blocks[block.first];
+		std::cout << std::left << std::setw(25) << block.first << std::right << std::setw(11) << c << "  " << std::setw(8) << v << "  "
+				  << std::setw(8) << c - v << std::endl;
+	}
+	return 0;
+}
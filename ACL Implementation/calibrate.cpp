@@ -0,0 +1,211 @@
+#include "network.h"
+#include "modelZoo.h"
+#include "inputPipeline.h"
+#include "dataLoader.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+#include <limits>
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace arm_compute;
+using namespace utils;
+using namespace std;
+
+//Offline QASYMM8 calibration: runs representative images through the folded F32 network, records the range
+//of every activation, then writes one bundle with the quantized weights, the S32 biases and the ranges
+//Load it with CompileOptions::quantize and weight_bundle, see check_quant for the accuracy against F32
+
+struct Range{
+	float min;
+	float max;
+
+	Range()
+		: min(std::numeric_limits<float>::max()), max(std::numeric_limits<float>::lowest())
+	{
+	}
+};
+
+static void observe(const ITensor * tensor, Range &range){
+	Window window;
+	window.use_tensor_dimensions(tensor->info()->tensor_shape());
+	window.set(Window::DimX, Window::Dimension(0, 1, 1));
+	const size_t width = tensor->info()->dimension(0);
+	execute_window_loop(window, [&](const Coordinates & id)
+	{
+		const float * row = reinterpret_cast<const float *>(tensor->ptr_to_element(id));
+		for(size_t x = 0; x < width; x++)
+		{
+			range.min = std::min(range.min, row[x]);
+			range.max = std::max(range.max, row[x]);
+		}
+	});
+}
+
+class Calibrator{
+public:
+	Calibrator(const opGraph::Network &network, const string &data_path, const vector<Range> &ranges)
+		: _network(network), _data_path(data_path), _ranges(ranges), _tensors(), _entries(), _float_bytes(0), _quantized_bytes(0)
+	{
+	}
+	Calibrator(const Calibrator &) = delete;
+	Calibrator &operator=(const Calibrator &) = delete;
+
+	//Quantize one weight tensor with its own range and its bias with scale input scale * weight scale
+	void addLayer(const string &weights_file, const string &biases_file, const string &bn, int bn_offset, unsigned int channel_dim, int input_edge){
+		unique_ptr<Tensor> weights(opWrapper::loadParameter(weights_file));
+		unique_ptr<Tensor> biases;
+		if(biases_file.empty())
+		{
+			biases.reset(opWrapper::configure1DTensor(weights->info()->dimension(channel_dim)));
+			biases->allocator()->allocate();
+			memset(biases->buffer(), 0, biases->info()->total_size());
+		}
+		else
+		{
+			biases.reset(opWrapper::loadParameter(biases_file));
+		}
+		if(!bn.empty())
+		{
+			opWrapper::foldBatchNorm(weights.get(), biases.get(), _data_path + bn, bn_offset, channel_dim);
+		}
+
+		Range range;
+		observe(weights.get(), range);
+		const QuantizationInfo weights_info = opWrapper::rangeQuantization(range.min, range.max);
+		const Range &input = _ranges[opGraph::quantizationSource(_network.graph(), input_edge)];
+		const float input_scale = opWrapper::rangeQuantization(input.min, input.max).uniform().scale;
+		const float bias_scale = input_scale * weights_info.uniform().scale;
+
+		Tensor * q_weights = newTensor(weights->info()->tensor_shape(), DataType::QASYMM8, weights_info);
+		const UniformQuantizationInfo w = weights_info.uniform();
+		Window window;
+		window.use_tensor_dimensions(weights->info()->tensor_shape());
+		execute_window_loop(window, [&](const Coordinates & id)
+		{
+			const float value = *reinterpret_cast<const float *>(weights->ptr_to_element(id));
+			const int q = static_cast<int>(std::round(value / w.scale)) + w.offset;
+			*q_weights->ptr_to_element(id) = static_cast<uint8_t>(std::max(0, std::min(255, q)));
+		});
+		Tensor * q_biases = newTensor(biases->info()->tensor_shape(), DataType::S32, QuantizationInfo(bias_scale, 0));
+		for(size_t c = 0; c < biases->info()->dimension(0); c++)
+		{
+			const float value = *reinterpret_cast<const float *>(biases->ptr_to_element(Coordinates(c)));
+			*reinterpret_cast<int32_t *>(q_biases->ptr_to_element(Coordinates(c))) = static_cast<int32_t>(std::round(value / bias_scale));
+		}
+
+		const string bias_key = biases_file.empty() ? opWrapper::biasFilename(weights_file) : biases_file;
+		_entries.push_back(make_pair(opWrapper::bundleKey(weights_file), q_weights));
+		_entries.push_back(make_pair(opWrapper::bundleKey(bias_key), q_biases));
+		_float_bytes += weights->info()->total_size() + biases->info()->total_size();
+		_quantized_bytes += q_weights->info()->total_size() + q_biases->info()->total_size();
+	}
+
+	void addRanges(){
+		const vector<opGraph::Edge> &edges = _network.graph().edges();
+		for(size_t i = 0; i < edges.size(); i++)
+		{
+			if(_ranges[i].min > _ranges[i].max)
+			{
+				continue;
+			}
+			Tensor * range = newTensor(TensorShape(2), DataType::F32, QuantizationInfo());
+			reinterpret_cast<float *>(range->buffer())[0] = _ranges[i].min;
+			reinterpret_cast<float *>(range->buffer())[1] = _ranges[i].max;
+			_entries.push_back(make_pair(opWrapper::rangeKey(edges[i].name), range));
+		}
+	}
+
+	void write(const string &filename){
+		opWrapper::writeWeightBundle(filename, _entries);
+		cout<<"Wrote "<<_entries.size()<<" tensors to "<<filename<<", parameters "<<_float_bytes / 1048576.0<<" MB in F32, "
+			<<_quantized_bytes / 1048576.0<<" MB quantized"<<endl;
+	}
+
+private:
+	Tensor * newTensor(const TensorShape &shape, DataType type, const QuantizationInfo &quantization){
+		_tensors.emplace_back(new Tensor());
+		_tensors.back()->allocator()->init(TensorInfo(shape, 1, type, quantization));
+		_tensors.back()->allocator()->allocate();
+		return _tensors.back().get();
+	}
+
+	const opGraph::Network &_network;
+	string _data_path;
+	const vector<Range> &_ranges;
+	vector<unique_ptr<Tensor>> _tensors;
+	vector<pair<string, const ITensor *>> _entries;
+	size_t _float_bytes;
+	size_t _quantized_bytes;
+};
+
+int main (int argc, char **argv)
+{
+	if(argc != 5)
+	{
+		std::cout<<"Usage: ./calibrate [data_path] [model(resnet50)] [images(directory of .ppm or one .ppm)] [quantized bundle]"<<std::endl;
+		return 0;
+	}
+	const string data_path = argv[1];
+	const string model = argv[2];
+	const vector<string> frames = opGraph::InputPipeline::listFrames(argv[3]);
+
+	opGraph::Graph graph;
+	opGraph::buildModel(graph, model);
+
+	//Every activation has to survive the run to be observed
+	opGraph::CompileOptions options;
+	options.data_path = data_path;
+	options.plan_memory = false;
+	opGraph::Network network(graph, options);
+	const vector<opGraph::Edge> &edges = network.graph().edges();
+
+	vector<Range> ranges(edges.size());
+	for(size_t f = 0; f < frames.size(); f++)
+	{
+		pmLoader ppm;
+		ppm.open(frames[f]);
+		ppm.fill_image(*network.input());
+		ppm.close();
+		network.run();
+		for(size_t e = 0; e < edges.size(); e++)
+		{
+			if(network.tensor(static_cast<int>(e))->buffer() != nullptr)
+			{
+				observe(network.tensor(static_cast<int>(e)), ranges[e]);
+			}
+		}
+	}
+	cout<<"Calibrated "<<edges.size()<<" activations on "<<frames.size()<<" images"<<endl;
+
+	//Same parameter files as Network::lower, after the same BN folding
+	Calibrator calibrator(network, data_path, ranges);
+	const vector<opGraph::Node> &nodes = network.graph().nodes();
+	for(size_t i = 0; i < nodes.size(); i++)
+	{
+		const opGraph::Node &node = nodes[i];
+		if(node.type == opGraph::OpType::Conv)
+		{
+			for(int g = 0; g < node.groups; g++)
+			{
+				const string name = node.groups == 1 ? node.name : node.name + "_g" + to_string(g);
+				calibrator.addLayer(data_path + name + "_weights_0.npy", "", node.bn, g * node.channels / node.groups, 3, node.inputs[0]);
+			}
+		}
+		else if(node.type == opGraph::OpType::DWConv)
+		{
+			calibrator.addLayer(data_path + node.name + "_weights_0.npy", "", node.bn, 0, 2, node.inputs[0]);
+		}
+		else if(node.type == opGraph::OpType::FC)
+		{
+			calibrator.addLayer(data_path + "classifier_weights_0.npy", data_path + "classifier_biases_0.npy", "", 0, 1, node.inputs[0]);
+		}
+	}
+	calibrator.addRanges();
+	calibrator.write(argv[4]);
+	return 0;
+}
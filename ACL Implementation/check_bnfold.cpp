@@ -0,0 +1,114 @@
+#include "network.h"
+#include "modelZoo.h"
+#include "dataLoader.h"
+
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <map>
+#include <string>
+
+using namespace arm_compute;
+using namespace utils;
+using namespace std;
+
+//Builds the same model with and without BN folding, runs both on one image
+//and compares every activation the two networks still have in common
+//With a weight bundle the folded network loads from it, which also checks the bundle against the NPY dumps
+static void fillInput(Tensor * input, const string &image){
+	pmLoader ppm;
+	ppm.open(image);
+	if(ppm.is_open())
+	{
+		ppm.fill_image(*input);
+		ppm.close();
+		return;
+	}
+	//No image, any fixed pattern will do as long as both networks see it
+	Window window;
+	window.use_tensor_dimensions(input->info()->tensor_shape());
+	execute_window_loop(window, [&](const Coordinates & id)
+	{
+		*reinterpret_cast<float *>(input->ptr_to_element(id)) = static_cast<float>((id[0] * 7 + id[1] * 13 + id[2] * 29) % 255);
+	});
+}
+
+//Largest absolute difference, relative to the largest reference magnitude
+static float relativeError(Tensor * reference, Tensor * folded){
+	float max_diff = 0.f;
+	float max_ref = 0.f;
+	Window window;
+	window.use_tensor_dimensions(reference->info()->tensor_shape());
+	execute_window_loop(window, [&](const Coordinates & id)
+	{
+		const float ref = *reinterpret_cast<float *>(reference->ptr_to_element(id));
+		const float val = *reinterpret_cast<float *>(folded->ptr_to_element(id));
+		max_diff = std::max(max_diff, std::fabs(ref - val));
+		max_ref = std::max(max_ref, std::fabs(ref));
+	});
+	return max_ref > 0.f ? max_diff / max_ref : max_diff;
+}
+
+int main (int argc, char **argv)
+{
+	if(argc < 2 || argc > 6)
+	{
+		std::cout<<"Usage: ./check_bnfold [data_path] [model(resnet50)] [image] [tolerance(1e-3)] [weight bundle]"<<std::endl;
+		return 0;
+	}
+	const string model = argc > 2 ? argv[2] : "resnet50";
+	const string image = argc > 3 ? argv[3] : "/root/Project/disInfer/go_kart.ppm";
+	const float tolerance = argc > 4 ? static_cast<float>(atof(argv[4])) : 1e-3f;
+
+	opGraph::Graph graph;
+	opGraph::buildModel(graph, model);
+
+	//Every intermediate tensor has to survive the run to be compared
+	opGraph::CompileOptions options;
+	options.data_path = argv[1];
+	options.plan_memory = false;
+	options.fold_bn = false;
+	auto beginTime = std::chrono::steady_clock::now();
+	opGraph::Network reference(graph, options);
+	auto midTime = std::chrono::steady_clock::now();
+	options.fold_bn = true;
+	options.weight_bundle = argc > 5 ? argv[5] : "";
+	opGraph::Network folded(graph, options);
+	auto endTime = std::chrono::steady_clock::now();
+	cout<<"Layers: "<<reference.layers().size()<<" unfused, "<<folded.layers().size()<<" folded"<<endl;
+	cout<<"Load time: "<<std::chrono::duration<double,std::milli>(midTime - beginTime).count()<<" ms unfused from NPY, "
+		<<std::chrono::duration<double,std::milli>(endTime - midTime).count()<<" ms folded"<<(argc > 5 ? " from the bundle" : "")<<endl;
+
+	fillInput(reference.input(), image);
+	fillInput(folded.input(), image);
+	reference.run();
+	folded.run();
+
+	std::map<string, int> edges;
+	for(size_t i = 0; i < reference.graph().edges().size(); i++)
+	{
+		edges[reference.graph().edges()[i].name] = static_cast<int>(i);
+	}
+
+	float worst = 0.f;
+	string worst_name;
+	for(size_t i = 0; i < folded.graph().edges().size(); i++)
+	{
+		std::map<string, int>::const_iterator it = edges.find(folded.graph().edges()[i].name);
+		if(it == edges.end())
+		{
+			continue;
+		}
+		const float error = relativeError(reference.tensor(it->second), folded.tensor(static_cast<int>(i)));
+		if(error > worst)
+		{
+			worst = error;
+			worst_name = it->first;
+		}
+	}
+	const float output_error = relativeError(reference.output(), folded.output());
+
+	cout<<"Worst activation: "<<worst_name<<" relative error "<<worst<<endl;
+	cout<<"Output relative error "<<output_error<<(output_error <= tolerance ? " OK" : " FAILED")<<endl;
+	return output_error <= tolerance ? 0 : 1;
+}
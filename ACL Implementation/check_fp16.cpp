@@ -0,0 +1,105 @@
+#include "network.h"
+#include "modelZoo.h"
+#include "inputPipeline.h"
+#include "dataLoader.h"
+#include <chrono>
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace arm_compute;
+using namespace utils;
+using namespace std;
+
+//Runs the F32 network and the F16 one on the same images
+//and reports top-1 agreement, output error, latency and activation memory
+
+//The output is a 1D vector of scores, the classifier never pads it
+static const float * scores(Tensor * output){
+	return reinterpret_cast<const float *>(output->buffer() + output->info()->offset_first_element_in_bytes());
+}
+
+static size_t argmax(Tensor * output){
+	const float * data = scores(output);
+	return static_cast<size_t>(std::max_element(data, data + output->info()->tensor_shape().total_size()) - data);
+}
+
+static double medianLatency(opGraph::Network &network, int iterations){
+	vector<double> latency;
+	for(int i = 0; i < iterations; i++)
+	{
+		auto beginTime = std::chrono::steady_clock::now();
+		network.run();
+		latency.push_back(std::chrono::duration<double,std::milli>(std::chrono::steady_clock::now() - beginTime).count());
+	}
+	std::sort(latency.begin(), latency.end());
+	return latency.empty() ? 0 : latency[latency.size() / 2];
+}
+
+int main (int argc, char **argv)
+{
+	if(argc < 4 || argc > 6)
+	{
+		std::cout<<"Usage: ./check_fp16 [data_path] [model(resnet50)] [images(directory of .ppm or one .ppm)] [numberIteration(20)] [bundle]"<<std::endl;
+		return 0;
+	}
+	const string model = argv[2];
+	const vector<string> frames = opGraph::InputPipeline::listFrames(argv[3]);
+	const int iterations = argc > 4 ? atoi(argv[4]) : 20;
+
+	opGraph::Graph graph;
+	opGraph::buildModel(graph, model);
+
+	opGraph::CompileOptions options;
+	options.data_path = argv[1];
+	options.weight_bundle = argc > 5 ? argv[5] : "";
+	opGraph::Network reference(graph, options);
+	options.fp16 = true;
+	opGraph::Network half(graph, options);
+	if(!half.halfPrecision())
+	{
+		cout<<"No FP16 arithmetic on this core, both networks ran in F32"<<endl;
+	}
+
+	size_t agree = 0;
+	double error = 0;
+	double magnitude = 0;
+	double worst = 0;
+	for(size_t f = 0; f < frames.size(); f++)
+	{
+		pmLoader ppm;
+		ppm.open(frames[f]);
+		ppm.fill_image(*reference.input());
+		ppm.close();
+		ppm.open(frames[f]);
+		ppm.fill_image(*half.input());
+		ppm.close();
+		reference.run();
+		half.run();
+
+		agree += argmax(reference.output()) == argmax(half.output());
+		const float * ref = scores(reference.output());
+		const float * h = scores(half.output());
+		for(size_t i = 0; i < reference.output()->info()->tensor_shape().total_size(); i++)
+		{
+			error += std::fabs(ref[i] - h[i]);
+			magnitude += std::fabs(ref[i]);
+			worst = std::max(worst, static_cast<double>(std::fabs(ref[i] - h[i])));
+		}
+	}
+
+	const double f32_ms = medianLatency(reference, iterations);
+	const double h_ms = medianLatency(half, iterations);
+	const size_t f32_bytes = reference.memoryPlanner().plannedBytes();
+	const size_t h_bytes = half.memoryPlanner().plannedBytes();
+
+	cout<<model<<" on "<<frames.size()<<" images"<<endl;
+	cout<<"Top-1 agreement "<<agree<<"/"<<frames.size()<<", mean relative output error "<<(magnitude > 0 ? error / magnitude : error)
+		<<", largest absolute error "<<worst<<endl;
+	cout<<"Latency "<<f32_ms<<" ms F32, "<<h_ms<<" ms F16 ("<<(h_ms > 0 ? f32_ms / h_ms : 0)<<"x)"<<endl;
+	cout<<"Activations "<<f32_bytes / 1048576.0<<" MB F32, "<<h_bytes / 1048576.0<<" MB F16"<<endl;
+	return 0;
+}
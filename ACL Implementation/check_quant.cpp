@@ -0,0 +1,98 @@
+#include "network.h"
+#include "modelZoo.h"
+#include "inputPipeline.h"
+#include "dataLoader.h"
+#include <chrono>
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace arm_compute;
+using namespace utils;
+using namespace std;
+
+//Runs the F32 network and the QASYMM8 one from a calibrated bundle on the same images
+//and reports top-1 agreement, output error, latency and activation memory
+
+//The output is a 1D vector of scores, the classifier never pads it
+static const float * scores(Tensor * output){
+	return reinterpret_cast<const float *>(output->buffer() + output->info()->offset_first_element_in_bytes());
+}
+
+static size_t argmax(Tensor * output){
+	const float * data = scores(output);
+	return static_cast<size_t>(std::max_element(data, data + output->info()->tensor_shape().total_size()) - data);
+}
+
+static double medianLatency(opGraph::Network &network, int iterations){
+	vector<double> latency;
+	for(int i = 0; i < iterations; i++)
+	{
+		auto beginTime = std::chrono::steady_clock::now();
+		network.run();
+		latency.push_back(std::chrono::duration<double,std::milli>(std::chrono::steady_clock::now() - beginTime).count());
+	}
+	std::sort(latency.begin(), latency.end());
+	return latency.empty() ? 0 : latency[latency.size() / 2];
+}
+
+int main (int argc, char **argv)
+{
+	if(argc < 5 || argc > 6)
+	{
+		std::cout<<"Usage: ./check_quant [data_path] [model(resnet50)] [images(directory of .ppm or one .ppm)] [quantized bundle] [numberIteration(20)]"<<std::endl;
+		return 0;
+	}
+	const string model = argv[2];
+	const vector<string> frames = opGraph::InputPipeline::listFrames(argv[3]);
+	const int iterations = argc > 5 ? atoi(argv[5]) : 20;
+
+	opGraph::Graph graph;
+	opGraph::buildModel(graph, model);
+
+	opGraph::CompileOptions options;
+	options.data_path = argv[1];
+	opGraph::Network reference(graph, options);
+	options.quantize = true;
+	options.weight_bundle = argv[4];
+	opGraph::Network quantized(graph, options);
+
+	size_t agree = 0;
+	double error = 0;
+	double magnitude = 0;
+	for(size_t f = 0; f < frames.size(); f++)
+	{
+		pmLoader ppm;
+		ppm.open(frames[f]);
+		ppm.fill_image(*reference.input());
+		ppm.close();
+		ppm.open(frames[f]);
+		ppm.fill_image(*quantized.input());
+		ppm.close();
+		reference.run();
+		quantized.run();
+
+		agree += argmax(reference.output()) == argmax(quantized.output());
+		const float * ref = scores(reference.output());
+		const float * q = scores(quantized.output());
+		for(size_t i = 0; i < reference.output()->info()->tensor_shape().total_size(); i++)
+		{
+			error += std::fabs(ref[i] - q[i]);
+			magnitude += std::fabs(ref[i]);
+		}
+	}
+
+	const double f32_ms = medianLatency(reference, iterations);
+	const double q_ms = medianLatency(quantized, iterations);
+	const size_t f32_bytes = reference.memoryPlanner().plannedBytes();
+	const size_t q_bytes = quantized.memoryPlanner().plannedBytes();
+
+	cout<<model<<" on "<<frames.size()<<" images"<<endl;
+	cout<<"Top-1 agreement "<<agree<<"/"<<frames.size()<<", mean relative output error "<<(magnitude > 0 ? error / magnitude : error)<<endl;
+	cout<<"Latency "<<f32_ms<<" ms F32, "<<q_ms<<" ms QASYMM8 ("<<(q_ms > 0 ? f32_ms / q_ms : 0)<<"x)"<<endl;
+	cout<<"Activations "<<f32_bytes / 1048576.0<<" MB F32, "<<q_bytes / 1048576.0<<" MB QASYMM8"<<endl;
+	return 0;
+}
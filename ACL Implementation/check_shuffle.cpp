@@ -0,0 +1,127 @@
+#include "network.h"
+#include "modelZoo.h"
+#include "dataLoader.h"
+#include <chrono>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace arm_compute;
+using namespace utils;
+using namespace std;
+
+//Builds the same model with the channel shuffles run explicitly and folded into their convolutions,
+//runs both on one image and checks that the outputs are bit-exact
+//Then checks at batch 2 that the grouped convolutions give the outputs of the split + concat emulation
+static void fillPattern(Tensor * input){
+	//Any fixed pattern will do as long as both networks see it, every image of a batch gets its own
+	Window window;
+	window.use_tensor_dimensions(input->info()->tensor_shape());
+	execute_window_loop(window, [&](const Coordinates & id)
+	{
+		*reinterpret_cast<float *>(input->ptr_to_element(id)) = static_cast<float>((id[0] * 7 + id[1] * 13 + id[2] * 29 + id[3] * 31) % 255);
+	});
+}
+
+static void fillInput(Tensor * input, const string &image){
+	pmLoader ppm;
+	ppm.open(image);
+	if(ppm.is_open())
+	{
+		ppm.fill_image(*input);
+		ppm.close();
+		return;
+	}
+	fillPattern(input);
+}
+
+//The output is a vector of scores per image, the classifier never pads it
+static size_t countMismatches(opGraph::Network &reference, opGraph::Network &network, size_t &count, float &worst){
+	count = reference.output()->info()->tensor_shape().total_size();
+	const float * ref = reinterpret_cast<const float *>(reference.output()->buffer() + reference.output()->info()->offset_first_element_in_bytes());
+	const float * val = reinterpret_cast<const float *>(network.output()->buffer() + network.output()->info()->offset_first_element_in_bytes());
+	size_t mismatches = 0;
+	worst = 0.f;
+	for(size_t i = 0; i < count; i++)
+	{
+		if(memcmp(&ref[i], &val[i], sizeof(float)) != 0)
+		{
+			mismatches++;
+			worst = std::max(worst, std::fabs(ref[i] - val[i]));
+		}
+	}
+	return mismatches;
+}
+
+static double medianLatency(opGraph::Network &network, int iterations){
+	vector<double> latency;
+	for(int i = 0; i < iterations; i++)
+	{
+		auto beginTime = std::chrono::steady_clock::now();
+		network.run();
+		latency.push_back(std::chrono::duration<double,std::milli>(std::chrono::steady_clock::now() - beginTime).count());
+	}
+	std::sort(latency.begin(), latency.end());
+	return latency.empty() ? 0 : latency[latency.size() / 2];
+}
+
+int main (int argc, char **argv)
+{
+	if(argc < 2 || argc > 6)
+	{
+		std::cout<<"Usage: ./check_shuffle [data_path] [model(shufflenetv1_g3_1.0x)] [image] [numberIteration(20)] [weight bundle]"<<std::endl;
+		return 0;
+	}
+	const string model = argc > 2 ? argv[2] : "shufflenetv1_g3_1.0x";
+	const string image = argc > 3 ? argv[3] : "/root/Project/disInfer/go_kart.ppm";
+	const int iterations = argc > 4 ? atoi(argv[4]) : 20;
+
+	opGraph::Graph graph;
+	opGraph::buildModel(graph, model);
+
+	opGraph::CompileOptions options;
+	options.data_path = argv[1];
+	options.weight_bundle = argc > 5 ? argv[5] : "";
+	options.fold_shuffle = false;
+	opGraph::Network reference(graph, options);
+	options.fold_shuffle = true;
+	opGraph::Network folded(graph, options);
+	cout<<"Layers: "<<reference.layers().size()<<" with explicit shuffles, "<<folded.layers().size()<<" folded"<<endl;
+
+	fillInput(reference.input(), image);
+	fillInput(folded.input(), image);
+	reference.run();
+	folded.run();
+
+	size_t count = 0;
+	float worst = 0.f;
+	const size_t mismatches = countMismatches(reference, folded, count, worst);
+
+	const double reference_ms = medianLatency(reference, iterations);
+	const double folded_ms = medianLatency(folded, iterations);
+	cout<<"Latency "<<reference_ms<<" ms explicit, "<<folded_ms<<" ms folded"<<endl;
+	cout<<"Activations "<<reference.memoryPlanner().plannedBytes() / 1048576.0<<" MB explicit, "
+		<<folded.memoryPlanner().plannedBytes() / 1048576.0<<" MB folded"<<endl;
+	cout<<mismatches<<"/"<<count<<" outputs differ, largest difference "<<worst<<(mismatches == 0 ? " BIT-EXACT" : " FAILED")<<endl;
+
+	//Channel views of a batch are only taken where the kernels keep the batch apart, elsewhere the grouped convs fall back
+	options.batch = 2;
+	options.grouped_views = false;
+	opGraph::Network emulated(graph, options);
+	options.grouped_views = true;
+	opGraph::Network views(graph, options);
+	fillPattern(emulated.input());
+	fillPattern(views.input());
+	emulated.run();
+	views.run();
+	size_t batch_count = 0;
+	float batch_worst = 0.f;
+	const size_t batch_mismatches = countMismatches(emulated, views, batch_count, batch_worst);
+	cout<<"Batch 2: "<<batch_mismatches<<"/"<<batch_count<<" outputs differ from the split + concat emulation, largest difference "
+		<<batch_worst<<(batch_mismatches == 0 ? " BIT-EXACT" : " FAILED")<<endl;
+	return mismatches == 0 && batch_mismatches == 0 ? 0 : 1;
+}
@@ -0,0 +1,270 @@
+#include "convTuner.h"
+#include "memoryPlanner.h"
+#include "arm_compute/core/Error.h"
+#include "arm_compute/core/Utils.h"
+#include "arm_compute/runtime/NEON/NEFunctions.h"
+#include "arm_compute/runtime/Scheduler.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <memory>
+#include <sstream>
+
+namespace opWrapper{
+
+	static ConvTuner * g_tuner = nullptr;
+
+	static const ConvolutionMethod candidates[] = { ConvolutionMethod::GEMM, ConvolutionMethod::WINOGRAD, ConvolutionMethod::DIRECT };
+
+	const char * methodName(ConvolutionMethod method){
+		switch(method)
+		{
+			case ConvolutionMethod::GEMM:
+				return "GEMM";
+			case ConvolutionMethod::WINOGRAD:
+				return "WINOGRAD";
+			case ConvolutionMethod::DIRECT:
+				return "DIRECT";
+			default:
+				return "FFT";
+		}
+	}
+
+	static bool parseMethod(const std::string &name, ConvolutionMethod &method){
+		for(size_t i = 0; i < sizeof(candidates) / sizeof(candidates[0]); i++)
+		{
+			if(name == methodName(candidates[i]))
+			{
+				method = candidates[i];
+				return true;
+			}
+		}
+		return false;
+	}
+
+	ConvTuner::ConvTuner(const std::string &filename, bool tune, int iterations)
+		: _filename(filename), _tune(tune), _iterations(std::max(iterations, 1)), _changed(false), _methods(), _measured()
+	{
+		std::ifstream fs(filename);
+		std::string line;
+		while(std::getline(fs, line))
+		{
+			//The key has spaces, the method is the last word
+			const size_t space = line.find_last_of(' ');
+			ConvolutionMethod method = ConvolutionMethod::GEMM;
+			if(line.empty() || line[0] == '#' || space == std::string::npos || !parseMethod(line.substr(space + 1), method))
+			{
+				continue;
+			}
+			_methods[line.substr(0, space)] = method;
+		}
+	}
+
+	bool ConvTuner::find(const std::string &key, ConvolutionMethod &method) const{
+		std::map<std::string, ConvolutionMethod>::const_iterator it = _methods.find(key);
+		if(it == _methods.end())
+		{
+			return false;
+		}
+		method = it->second;
+		return true;
+	}
+
+	void ConvTuner::record(const std::string &key, ConvolutionMethod method, const std::vector<std::pair<ConvolutionMethod, double>> &times){
+		_methods[key] = method;
+		_measured.emplace_back(key, times);
+		_changed = true;
+	}
+
+	void ConvTuner::save() const{
+		if(!_changed)
+		{
+			return;
+		}
+		std::ofstream fs(_filename, std::ios::out | std::ios::trunc);
+		if(!fs.is_open())
+		{
+			ARM_COMPUTE_ERROR("Cannot write the tuning file %s", _filename.c_str());
+		}
+		fs << "#kernel in->out channels, input size, stride, padding, type, batch, threads, then the fastest method" << std::endl;
+		for(std::map<std::string, ConvolutionMethod>::const_iterator it = _methods.begin(); it != _methods.end(); ++it)
+		{
+			fs << it->first << " " << methodName(it->second) << std::endl;
+		}
+	}
+
+	void ConvTuner::print(std::ostream &os) const{
+		os << std::fixed << std::setprecision(3);
+		os << _measured.size() << " convolution shapes tuned, median ms of " << _iterations << " runs" << std::endl;
+		for(size_t i = 0; i < _measured.size(); i++)
+		{
+			ConvolutionMethod best = ConvolutionMethod::GEMM;
+			find(_measured[i].first, best);
+			os << std::left << std::setw(40) << _measured[i].first << std::right;
+			for(size_t c = 0; c < _measured[i].second.size(); c++)
+			{
+				os << "  " << methodName(_measured[i].second[c].first) << " " << _measured[i].second[c].second;
+			}
+			os << "  -> " << methodName(best) << std::endl;
+		}
+	}
+
+	void setConvTuner(ConvTuner * tuner){
+		g_tuner = tuner;
+	}
+
+	ConvTuner * convTuner(){
+		return g_tuner;
+	}
+
+	//Batch and threads are part of the key, the fastest method changes with both
+	static std::string shapeKey(const ITensorInfo * input, const ITensorInfo * weights, const PadStrideInfo &conv_info){
+		std::ostringstream os;
+		os << weights->dimension(0) << "x" << weights->dimension(1) << " " << weights->dimension(2) << "->" << weights->dimension(3)
+		   << " " << input->dimension(0) << "x" << input->dimension(1) << " s" << conv_info.stride().first << " p" << conv_info.pad().first
+		   << " " << string_from_data_type(input->data_type()) << " n" << input->dimension(3)
+		   << " t" << Scheduler::get().num_threads();
+		return os.str();
+	}
+
+	static bool supports(ConvolutionMethod method, const ITensorInfo * input, const ITensorInfo * weights, const ITensorInfo * biases,
+						 const ITensorInfo * output, const PadStrideInfo &conv_info, const ActivationLayerInfo &act_info){
+		switch(method)
+		{
+			case ConvolutionMethod::GEMM:
+				return bool(NEGEMMConvolutionLayer::validate(input, weights, biases, output, conv_info, WeightsInfo(), Size2D(1U, 1U), act_info));
+			case ConvolutionMethod::WINOGRAD:
+				return bool(NEWinogradConvolutionLayer::validate(input, weights, biases, output, conv_info, act_info));
+			case ConvolutionMethod::DIRECT:
+				return bool(NEDirectConvolutionLayer::validate(input, weights, biases, output, conv_info, act_info));
+			default:
+				return false;
+		}
+	}
+
+	static IFunction * configureMethod(ConvolutionMethod method, ITensor * input, const ITensor * weights, const ITensor * biases, ITensor * output,
+									   const PadStrideInfo &conv_info, const ActivationLayerInfo &act_info,
+									   std::shared_ptr<IMemoryManager> memory_manager){
+		switch(method)
+		{
+			case ConvolutionMethod::GEMM:
+			{
+				NEGEMMConvolutionLayer * conv = new NEGEMMConvolutionLayer(memory_manager);
+				conv->configure(input, weights, biases, output, conv_info, WeightsInfo(), Size2D(1U, 1U), act_info);
+				return conv;
+			}
+			case ConvolutionMethod::WINOGRAD:
+			{
+				NEWinogradConvolutionLayer * conv = new NEWinogradConvolutionLayer(memory_manager);
+				conv->configure(input, weights, biases, output, conv_info, act_info);
+				return conv;
+			}
+			case ConvolutionMethod::DIRECT:
+			{
+				NEDirectConvolutionLayer * conv = new NEDirectConvolutionLayer(memory_manager);
+				conv->configure(input, weights, biases, output, conv_info, act_info);
+				return conv;
+			}
+			default:
+				ARM_COMPUTE_ERROR("%s is not a tuning candidate", methodName(method));
+				return nullptr;
+		}
+	}
+
+	static void initLike(Tensor &tensor, const ITensorInfo * info){
+		tensor.allocator()->init(TensorInfo(info->tensor_shape(), 1, info->data_type(), info->quantization_info()));
+	}
+
+	static void allocateZeroed(Tensor &tensor){
+		tensor.allocator()->allocate();
+		memset(tensor.buffer(), 0, tensor.info()->total_size());
+	}
+
+	//Median ms of one method on scratch tensors of the same shapes, with its own workspaces
+	//The first run prepares the weights and is not counted
+	static double timeMethod(ConvolutionMethod method, const ITensorInfo * input, const ITensorInfo * weights, const ITensorInfo * biases,
+							 const ITensorInfo * output, const PadStrideInfo &conv_info, const ActivationLayerInfo &act_info, int iterations){
+		Tensor in;
+		Tensor w;
+		Tensor b;
+		Tensor out;
+		initLike(in, input);
+		initLike(w, weights);
+		if(biases != nullptr)
+		{
+			initLike(b, biases);
+		}
+		if(output->total_size() != 0)
+		{
+			initLike(out, output);
+		}
+		std::unique_ptr<IFunction> conv(configureMethod(method, &in, &w, biases != nullptr ? &b : nullptr, &out, conv_info, act_info, nullptr));
+		allocateZeroed(in);
+		allocateZeroed(w);
+		if(biases != nullptr)
+		{
+			allocateZeroed(b);
+		}
+		allocateZeroed(out);
+		conv->run();
+
+		std::vector<double> times;
+		for(int i = 0; i < iterations; i++)
+		{
+			auto beginTime = std::chrono::steady_clock::now();
+			conv->run();
+			times.push_back(std::chrono::duration<double,std::milli>(std::chrono::steady_clock::now() - beginTime).count());
+		}
+		std::sort(times.begin(), times.end());
+		return times[times.size() / 2];
+	}
+
+	IFunction * newConvolution(ITensor * input, const ITensor * weights, const ITensor * biases, ITensor * output,
+							   const PadStrideInfo &conv_info, const ActivationLayerInfo &act_info){
+		ConvolutionMethod method = ConvolutionMethod::GEMM;
+		bool chosen = false;
+		if(g_tuner != nullptr)
+		{
+			const ITensorInfo * bias_info = biases != nullptr ? biases->info() : nullptr;
+			const std::string key = shapeKey(input->info(), weights->info(), conv_info);
+			if(g_tuner->find(key, method))
+			{
+				//A file tuned with another ACL build may name a method this one rejects
+				chosen = supports(method, input->info(), weights->info(), bias_info, output->info(), conv_info, act_info);
+			}
+			else if(g_tuner->tuning())
+			{
+				std::vector<std::pair<ConvolutionMethod, double>> times;
+				for(size_t i = 0; i < sizeof(candidates) / sizeof(candidates[0]); i++)
+				{
+					if(supports(candidates[i], input->info(), weights->info(), bias_info, output->info(), conv_info, act_info))
+					{
+						times.emplace_back(candidates[i], timeMethod(candidates[i], input->info(), weights->info(), bias_info, output->info(),
+																	 conv_info, act_info, g_tuner->iterations()));
+					}
+				}
+				if(!times.empty())
+				{
+					method = std::min_element(times.begin(), times.end(), [](const std::pair<ConvolutionMethod, double> &a,
+																			   const std::pair<ConvolutionMethod, double> &b)
+					{
+						return a.second < b.second;
+					})->first;
+					g_tuner->record(key, method, times);
+					chosen = true;
+				}
+			}
+		}
+		if(!chosen)
+		{
+			NEConvolutionLayer * conv = new NEConvolutionLayer(memoryManager());
+			conv->configure(input, weights, biases, output, conv_info, WeightsInfo(), Size2D(1U, 1U), act_info);
+			return conv;
+		}
+		return configureMethod(method, input, weights, biases, output, conv_info, act_info, memoryManager());
+	}
+
+ }
@@ -0,0 +1,62 @@
+#ifndef OPCONVTUNER
+#define OPCONVTUNER
+
+#include "arm_compute/runtime/IFunction.h"
+#include "arm_compute/core/ITensor.h"
+#include "arm_compute/core/Types.h"
+
+#include <map>
+#include <ostream>
+#include <string>
+#include <vector>
+
+using namespace arm_compute;
+
+namespace opWrapper{
+
+	//Convolution method per layer shape and thread count, measured on this machine and kept in a text file
+	//Every line is a shape key followed by the method, e.g. "3x3 64->64 56x56 s1 p1 F32 n1 t4 WINOGRAD"
+	//NEConvolutionLayer picks its method from the shapes alone, the tuner times GEMM, Winograd and direct
+	//on scratch tensors of the real shapes and keeps the fastest
+	class ConvTuner{
+	public:
+		//The file is read when it exists, tune measures the shapes it does not hold yet
+		ConvTuner(const std::string &filename, bool tune, int iterations = 5);
+		ConvTuner(const ConvTuner &) = delete;
+		ConvTuner &operator=(const ConvTuner &) = delete;
+
+		bool tuning() const { return _tune; }
+		int iterations() const { return _iterations; }
+		//False when the shape was never tuned
+		bool find(const std::string &key, ConvolutionMethod &method) const;
+		//times holds the median ms of every candidate that could run the shape
+		void record(const std::string &key, ConvolutionMethod method, const std::vector<std::pair<ConvolutionMethod, double>> &times);
+		//Only writes when a shape was added
+		void save() const;
+		//The shapes measured in this session, with every candidate
+		void print(std::ostream &os) const;
+
+	private:
+		std::string _filename;
+		bool _tune;
+		int _iterations;
+		bool _changed;
+		std::map<std::string, ConvolutionMethod> _methods;
+		std::vector<std::pair<std::string, std::vector<std::pair<ConvolutionMethod, double>>>> _measured;
+	};
+
+	//Tuner used by the convolution factories, nullptr leaves the choice to NEConvolutionLayer
+	void setConvTuner(ConvTuner * tuner);
+	ConvTuner * convTuner();
+
+	//A configured convolution of the method tuned for its shape (measured now when the tuner is tuning),
+	//NEConvolutionLayer when there is no tuner or the shape is not known. The weights do not need to be loaded yet
+	IFunction * newConvolution(ITensor * input, const ITensor * weights, const ITensor * biases, ITensor * output,
+							   const PadStrideInfo &conv_info, const ActivationLayerInfo &act_info);
+
+	const char * methodName(ConvolutionMethod method);
+
+ }
+
+
+#endif
@@ -9,6 +9,11 @@
 #include <cstdlib>
 #include <memory>
 #include <string>
+#include <vector>
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#endif
 
 /** Image loader interface */
 
@@ -93,6 +98,52 @@ private:
     const uint8_t *_data;
 };
 	
+/** Scale applied to every 8-bit colour value by fill_image */
+constexpr float image_scale = 0.003921f;
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+/** Widen 16 bytes to floats, scale them and store them at dst */
+inline void convert_u8x16(uint8x16_t v, float *dst, float32x4_t scale)
+{
+    const uint16x8_t lo = vmovl_u8(vget_low_u8(v));
+    const uint16x8_t hi = vmovl_u8(vget_high_u8(v));
+    vst1q_f32(dst + 0, vmulq_f32(vcvtq_f32_u32(vmovl_u16(vget_low_u16(lo))), scale));
+    vst1q_f32(dst + 4, vmulq_f32(vcvtq_f32_u32(vmovl_u16(vget_high_u16(lo))), scale));
+    vst1q_f32(dst + 8, vmulq_f32(vcvtq_f32_u32(vmovl_u16(vget_low_u16(hi))), scale));
+    vst1q_f32(dst + 12, vmulq_f32(vcvtq_f32_u32(vmovl_u16(vget_high_u16(hi))), scale));
+}
+#endif
+
+/** Split one row of interleaved RGB bytes into three float rows
+ *
+ * @param[in]  src   Interleaved row, 3 * width bytes
+ * @param[out] r     Red row, width floats
+ * @param[out] g     Green row, width floats
+ * @param[out] b     Blue row, width floats
+ * @param[in]  width Number of pixels
+ */
+inline void deinterleave_rgb_row(const uint8_t *src, float *r, float *g, float *b, int width)
+{
+    int x = 0;
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+    // vld3 does the deinterleave, 16 pixels per iteration
+    const float32x4_t scale = vdupq_n_f32(image_scale);
+    for(; x <= width - 16; x += 16)
+    {
+        const uint8x16x3_t rgb = vld3q_u8(src + 3 * x);
+        convert_u8x16(rgb.val[0], r + x, scale);
+        convert_u8x16(rgb.val[1], g + x, scale);
+        convert_u8x16(rgb.val[2], b + x, scale);
+    }
+#endif
+    for(; x < width; x++)
+    {
+        r[x] = image_scale * src[3 * x + 0];
+        g[x] = image_scale * src[3 * x + 1];
+        b[x] = image_scale * src[3 * x + 2];
+    }
+}
+
 class IImageLoader11
 {
 public:
@@ -141,38 +192,61 @@ public:
 	
     /** Fill an image with the content of the currently open image file.
      *
-     * @note If the image is a CLImage, the function maps and unmaps the image
+     * Whole rows are read with get_row() and deinterleaved straight into the three planes of the (W, H, C) tensor,
+     * every value scaled to [0, 1]. The tensor strides are honoured, so a padded input can be filled in place.
      *
      * @param[in,out] image Image to fill (Must be allocated, and of matching dimensions with the opened image file).
+     * @param[in]     batch Image of a (W, H, C, N) batch to fill, the others are left alone.
      */
     template <typename T>
-    void fill_image(T &image)
+    void fill_image(T &image, unsigned int batch = 0)
     {
         ARM_COMPUTE_ERROR_ON(!is_open());
         ARM_COMPUTE_ERROR_ON(image.info()->dimension(0) != _width || image.info()->dimension(1) != _height || image.info()->dimension(2) != 3);
+        ARM_COMPUTE_ERROR_ON(batch >= image.info()->dimension(3));
         ARM_COMPUTE_ERROR_ON_FORMAT_NOT_IN(&image, Format::U8, Format::RGB888, Format::F32);
         ARM_COMPUTE_ERROR_ON(_feeder.get() == nullptr);
-		//size_t stride = 0;
-		
+
         try
         {
-            // Map buffer if creating a CLTensor/GCTensor
-            //map(image, true);
             // Validate feeding data
             validate_info(image.info());
-			
-			//Window window;
-			//window.set(Window::DimX, Window::Dimension(0, _width, 1));
-			//window.set(Window::DimY, Window::Dimension(0, _height, 1));
-			//window.set(Window::DimZ, Window::Dimension(0, 3, 1));
-			//stride = 4;
-			
-			//std::cout<<image.info()->strides_in_bytes()[0]<<std::endl;
-			//std::cout<<image.info()->strides_in_bytes()[1]<<std::endl;
-			//std::cout<<image.info()->strides_in_bytes()[2]<<std::endl;
-					
-            //Iterator out(&image, window);
-			
+
+            const Strides &strides = image.info()->strides_in_bytes();
+            uint8_t       *base    = image.buffer() + image.info()->offset_first_element_in_bytes() + batch * strides[3];
+            std::vector<uint8_t> row(static_cast<size_t>(_width) * 3);
+
+            for(int y = 0; y < _height; y++)
+            {
+                _feeder->get_row(row.data(), row.size());
+                uint8_t *line = base + y * strides[1];
+                deinterleave_rgb_row(row.data(),
+                                     reinterpret_cast<float *>(line),
+                                     reinterpret_cast<float *>(line + strides[2]),
+                                     reinterpret_cast<float *>(line + 2 * strides[2]),
+                                     _width);
+            }
+        }
+        catch(const std::ifstream::failure &e)
+        {
+            ARM_COMPUTE_ERROR("Loading image file: %s", e.what());
+        }
+    }
+    /** Former per-byte fill: one virtual get() per byte, width-outer order, interleaved RGB floats written linearly.
+     *
+     * @note Only kept as the baseline of bench_fill_image, the layout it writes is not the one the first conv reads.
+     *
+     * @param[in,out] image Image to fill (Must be allocated, and of matching dimensions with the opened image file).
+     */
+    template <typename T>
+    void fill_image_bytewise(T &image)
+    {
+        ARM_COMPUTE_ERROR_ON(!is_open());
+        ARM_COMPUTE_ERROR_ON(_feeder.get() == nullptr);
+        try
+        {
+            validate_info(image.info());
+
 			unsigned char red   = 0;
 			unsigned char green = 0;
 			unsigned char blue  = 0;
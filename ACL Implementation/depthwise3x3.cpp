@@ -0,0 +1,252 @@
+#include "depthwise3x3.h"
+#include "fusedEpilogue.h"
+#include "arm_compute/core/Error.h"
+#include "arm_compute/core/Helpers.h"
+#include "arm_compute/core/Window.h"
+#include "arm_compute/runtime/NEON/NEScheduler.h"
+
+#include <algorithm>
+#include <limits>
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#elif defined(__AVX2__) && defined(__FMA__)
+#include <immintrin.h>
+#endif
+
+namespace opWrapper{
+
+	bool isDepthwise3x3(const ITensor * input, const ITensor * weights, int stride, int padding, const ActivationLayerInfo &act_info){
+		if(input->info()->data_type() != DataType::F32 || weights->info()->data_type() != DataType::F32
+		   || input->info()->data_layout() != DataLayout::NCHW)
+		{
+			return false;
+		}
+		if(weights->info()->dimension(0) != 3 || weights->info()->dimension(1) != 3 || padding != 1 || (stride != 1 && stride != 2))
+		{
+			return false;
+		}
+		if(!act_info.enabled())
+		{
+			return true;
+		}
+		switch(act_info.activation())
+		{
+			case ActivationLayerInfo::ActivationFunction::RELU:
+			case ActivationLayerInfo::ActivationFunction::BOUNDED_RELU:
+			case ActivationLayerInfo::ActivationFunction::LU_BOUNDED_RELU:
+				return true;
+			default:
+				return false;
+		}
+	}
+
+	//Output column of a row from the three taps of every input row, the taps outside the row are the padding
+	static inline float column(const float * const * rows, const float * k, int ix, int in_w, float bias){
+		float sum = bias;
+		for(int kx = 0; kx < 3; kx++)
+		{
+			if(ix + kx >= 0 && ix + kx < in_w)
+			{
+				sum += k[kx] * rows[0][ix + kx] + k[3 + kx] * rows[1][ix + kx] + k[6 + kx] * rows[2][ix + kx];
+			}
+		}
+		return sum;
+	}
+
+#if !(defined(__ARM_NEON) || defined(__ARM_NEON__)) && defined(__AVX2__) && defined(__FMA__)
+	//p[0], p[2] .. p[14] and p[1], p[3] .. p[15]
+	static inline void deinterleave(const float * p, __m256 &even, __m256 &odd){
+		const __m256 a = _mm256_loadu_ps(p);
+		const __m256 b = _mm256_loadu_ps(p + 8);
+		//Within each half a0 a2 b0 b2 | a4 a6 b4 b6, the 64-bit pairs are put back in order after
+		even = _mm256_castpd_ps(_mm256_permute4x64_pd(_mm256_castps_pd(_mm256_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0))), _MM_SHUFFLE(3, 1, 2, 0)));
+		odd = _mm256_castpd_ps(_mm256_permute4x64_pd(_mm256_castps_pd(_mm256_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1))), _MM_SHUFFLE(3, 1, 2, 0)));
+	}
+#endif
+
+	//One output row, k holds the 9 weights of the channel row by row
+	static void depthwiseRow(const float * const * rows, const float * k, float * out, int in_w, int out_w, int stride,
+							 float bias, float lower, float upper){
+		int x = 1;
+#if defined(__ARM_NEON) || defined(__ARM_NEON__) || (defined(__AVX2__) && defined(__FMA__))
+		//Columns 1 to end - 1 have all their taps inside the row
+		const int end = stride == 1 ? in_w - 1 : in_w / 2;
+#endif
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+		const float32x4_t vbias = vdupq_n_f32(bias);
+		const float32x4_t vlower = vdupq_n_f32(lower);
+		const float32x4_t vupper = vdupq_n_f32(upper);
+		float32x4_t w[9];
+		for(int i = 0; i < 9; i++)
+		{
+			w[i] = vdupq_n_f32(k[i]);
+		}
+		if(stride == 1)
+		{
+			for(; x + 4 <= end; x += 4)
+			{
+				float32x4_t acc = vbias;
+				for(int ky = 0; ky < 3; ky++)
+				{
+					const float * r = rows[ky] + x - 1;
+					acc = vmlaq_f32(acc, vld1q_f32(r), w[3 * ky]);
+					acc = vmlaq_f32(acc, vld1q_f32(r + 1), w[3 * ky + 1]);
+					acc = vmlaq_f32(acc, vld1q_f32(r + 2), w[3 * ky + 2]);
+				}
+				vst1q_f32(out + x, vminq_f32(vmaxq_f32(acc, vlower), vupper));
+			}
+		}
+		else
+		{
+			//The second load reads up to column 2x + 8
+			for(; x + 4 <= end && 2 * x + 9 <= in_w; x += 4)
+			{
+				float32x4_t acc = vbias;
+				for(int ky = 0; ky < 3; ky++)
+				{
+					const float * r = rows[ky] + 2 * x - 1;
+					const float32x4x2_t left = vld2q_f32(r);
+					const float32x4x2_t right = vld2q_f32(r + 2);
+					acc = vmlaq_f32(acc, left.val[0], w[3 * ky]);
+					acc = vmlaq_f32(acc, left.val[1], w[3 * ky + 1]);
+					acc = vmlaq_f32(acc, right.val[0], w[3 * ky + 2]);
+				}
+				vst1q_f32(out + x, vminq_f32(vmaxq_f32(acc, vlower), vupper));
+			}
+		}
+#elif defined(__AVX2__) && defined(__FMA__)
+		const __m256 vbias = _mm256_set1_ps(bias);
+		const __m256 vlower = _mm256_set1_ps(lower);
+		const __m256 vupper = _mm256_set1_ps(upper);
+		__m256 w[9];
+		for(int i = 0; i < 9; i++)
+		{
+			w[i] = _mm256_set1_ps(k[i]);
+		}
+		if(stride == 1)
+		{
+			for(; x + 8 <= end; x += 8)
+			{
+				__m256 acc = vbias;
+				for(int ky = 0; ky < 3; ky++)
+				{
+					const float * r = rows[ky] + x - 1;
+					acc = _mm256_fmadd_ps(_mm256_loadu_ps(r), w[3 * ky], acc);
+					acc = _mm256_fmadd_ps(_mm256_loadu_ps(r + 1), w[3 * ky + 1], acc);
+					acc = _mm256_fmadd_ps(_mm256_loadu_ps(r + 2), w[3 * ky + 2], acc);
+				}
+				_mm256_storeu_ps(out + x, _mm256_min_ps(_mm256_max_ps(acc, vlower), vupper));
+			}
+		}
+		else
+		{
+			//The second pair of loads reads up to column 2x + 16
+			for(; x + 8 <= end && 2 * x + 17 <= in_w; x += 8)
+			{
+				__m256 acc = vbias;
+				for(int ky = 0; ky < 3; ky++)
+				{
+					const float * r = rows[ky] + 2 * x - 1;
+					__m256 even, odd, right, unused;
+					deinterleave(r, even, odd);
+					deinterleave(r + 2, right, unused);
+					acc = _mm256_fmadd_ps(even, w[3 * ky], acc);
+					acc = _mm256_fmadd_ps(odd, w[3 * ky + 1], acc);
+					acc = _mm256_fmadd_ps(right, w[3 * ky + 2], acc);
+				}
+				_mm256_storeu_ps(out + x, _mm256_min_ps(_mm256_max_ps(acc, vlower), vupper));
+			}
+		}
+#endif
+		for(; x < out_w; x++)
+		{
+			out[x] = std::min(std::max(column(rows, k, x * stride - 1, in_w, bias), lower), upper);
+		}
+		out[0] = std::min(std::max(column(rows, k, -1, in_w, bias), lower), upper);
+	}
+
+	NEDepthwise3x3Kernel::NEDepthwise3x3Kernel()
+		: _input(nullptr), _weights(nullptr), _biases(nullptr), _output(nullptr), _stride(1),
+		  _lower(-std::numeric_limits<float>::infinity()), _upper(std::numeric_limits<float>::infinity()), _zeros()
+	{
+	}
+
+	void NEDepthwise3x3Kernel::configure(const ITensor * input, const ITensor * weights, const ITensor * biases, ITensor * output,
+										 int stride, const ActivationLayerInfo &act_info){
+		if(!isDepthwise3x3(input, weights, stride, 1, act_info))
+		{
+			ARM_COMPUTE_ERROR("The depthwise 3x3 kernel needs F32, 3x3 weights, padding 1, stride 1 or 2 and a clamping activation");
+		}
+		const ITensorInfo * in = input->info();
+		if(weights->info()->dimension(2) != in->dimension(2) || (biases != nullptr && biases->info()->dimension(0) != in->dimension(2)))
+		{
+			ARM_COMPUTE_ERROR("The depthwise weights and biases need one kernel per input channel");
+		}
+		_input = input;
+		_weights = weights;
+		_biases = biases;
+		_output = output;
+		_stride = stride;
+		clampBounds(act_info, _lower, _upper);
+		_zeros.assign(in->dimension(0), 0.f);
+		const int out_w = (in->dimension(0) - 1) / stride + 1;
+		const int out_h = (in->dimension(1) - 1) / stride + 1;
+		const TensorShape shape(out_w, out_h, in->dimension(2), in->dimension(3));
+		auto_init_if_empty(*output->info(), shape, 1, DataType::F32);
+		if(output->info()->tensor_shape().total_size() != shape.total_size())
+		{
+			ARM_COMPUTE_ERROR("The output does not have the shape of the depthwise layer");
+		}
+		Window window;
+		window.set(Window::DimX, Window::Dimension(0, in->dimension(2) * in->dimension(3), 1));
+		INEKernel::configure(window);
+	}
+
+	void NEDepthwise3x3Kernel::run(const Window &window, const ThreadInfo &info){
+		ARM_COMPUTE_UNUSED(info);
+		const ITensorInfo * in = _input->info();
+		const ITensorInfo * out = _output->info();
+		const int in_w = in->dimension(0);
+		const int in_h = in->dimension(1);
+		const int channels = in->dimension(2);
+		const int out_w = out->dimension(0);
+		const int out_h = out->dimension(1);
+		const float * weights = reinterpret_cast<const float *>(_weights->buffer() + _weights->info()->offset_first_element_in_bytes());
+		const float * biases = _biases != nullptr ? reinterpret_cast<const float *>(_biases->buffer() + _biases->info()->offset_first_element_in_bytes()) : nullptr;
+		for(int p = window.x().start(); p < window.x().end(); p++)
+		{
+			const int c = p % channels;
+			const int n = p / channels;
+			const uint8_t * src = _input->buffer() + in->offset_first_element_in_bytes() + c * in->strides_in_bytes()[2] + n * in->strides_in_bytes()[3];
+			uint8_t * dst = _output->buffer() + out->offset_first_element_in_bytes() + c * out->strides_in_bytes()[2] + n * out->strides_in_bytes()[3];
+			const float bias = biases != nullptr ? biases[c] : 0.f;
+			for(int y = 0; y < out_h; y++)
+			{
+				const float * rows[3];
+				for(int ky = 0; ky < 3; ky++)
+				{
+					const int iy = y * _stride - 1 + ky;
+					rows[ky] = iy < 0 || iy >= in_h ? _zeros.data() : reinterpret_cast<const float *>(src + iy * in->strides_in_bytes()[1]);
+				}
+				depthwiseRow(rows, weights + 9 * c, reinterpret_cast<float *>(dst + y * out->strides_in_bytes()[1]), in_w, out_w, _stride,
+							 bias, _lower, _upper);
+			}
+		}
+	}
+
+	Depthwise3x3::Depthwise3x3()
+		: _kernel()
+	{
+	}
+
+	void Depthwise3x3::configure(const ITensor * input, const ITensor * weights, const ITensor * biases, ITensor * output,
+								 int stride, const ActivationLayerInfo &act_info){
+		_kernel.configure(input, weights, biases, output, stride, act_info);
+	}
+
+	void Depthwise3x3::run(){
+		NEScheduler::get().schedule(&_kernel, Window::DimX);
+	}
+
+ }
@@ -0,0 +1,62 @@
+#ifndef OPDEPTHWISE3X3
+#define OPDEPTHWISE3X3
+
+#include "arm_compute/core/NEON/INEKernel.h"
+#include "arm_compute/core/Types.h"
+#include "arm_compute/runtime/IFunction.h"
+
+#include <vector>
+
+using namespace arm_compute;
+
+namespace opWrapper{
+
+	//True when Depthwise3x3 can run the layer: F32 input and weights, 3x3 kernels, padding 1, stride 1 or 2
+	//and no activation or a clamping one. Every depthwise layer of ShuffleNetV1 is of this kind
+	bool isDepthwise3x3(const ITensor * input, const ITensor * weights, int stride, int padding, const ActivationLayerInfo &act_info);
+
+	//Depthwise 3x3 convolution with padding 1 on NCHW F32, one plane per index of the window
+	//An output row is summed from its three input rows in registers and stored once, the rows in the padding read zeros
+	//Stride 2 splits the even and odd columns with vld2q on NEON and with two loads and a shuffle on AVX2 + FMA,
+	//the border columns and the tail are scalar. The kernel asks for no padding, channel views can be read and written
+	class NEDepthwise3x3Kernel : public INEKernel{
+	public:
+		NEDepthwise3x3Kernel();
+		NEDepthwise3x3Kernel(const NEDepthwise3x3Kernel &) = delete;
+		NEDepthwise3x3Kernel &operator=(const NEDepthwise3x3Kernel &) = delete;
+
+		const char * name() const override { return "NEDepthwise3x3Kernel"; }
+		//weights are (3, 3, channels) or (3, 3, channels, 1) without padding, biases may be nullptr
+		//An empty output is initialised here
+		void configure(const ITensor * input, const ITensor * weights, const ITensor * biases, ITensor * output,
+					   int stride, const ActivationLayerInfo &act_info);
+		void run(const Window &window, const ThreadInfo &info) override;
+
+	private:
+		const ITensor * _input;
+		const ITensor * _weights;
+		const ITensor * _biases;
+		ITensor * _output;
+		int _stride;
+		float _lower;
+		float _upper;
+		std::vector<float> _zeros;	//one input row of padding
+	};
+
+	//Runs the kernel on the scheduler, split over the planes
+	class Depthwise3x3 : public IFunction{
+	public:
+		Depthwise3x3();
+
+		void configure(const ITensor * input, const ITensor * weights, const ITensor * biases, ITensor * output,
+					   int stride, const ActivationLayerInfo &act_info);
+		void run() override;
+
+	private:
+		NEDepthwise3x3Kernel _kernel;
+	};
+
+ }
+
+
+#endif
@@ -0,0 +1,278 @@
+#include "distributed.h"
+#include "arm_compute/core/Error.h"
+#include "arm_compute/core/Window.h"
+#include "arm_compute/core/Helpers.h"
+
+#include <cerrno>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+namespace opGraph{
+
+	//Large enough for most boundary tensors, so a sender rarely waits for its peer to reach the matching recv
+	static const int socket_buffer = 4 << 20;
+
+	Communicator::Communicator(int rank, const std::vector<int> &sockets)
+		: _rank(rank), _sockets(sockets), _staging(), _bytes_sent(0)
+	{
+		if(rank < 0 || rank >= static_cast<int>(sockets.size()))
+		{
+			ARM_COMPUTE_ERROR("Rank out of range");
+		}
+	}
+
+	Communicator::~Communicator(){
+		for(size_t i = 0; i < _sockets.size(); i++)
+		{
+			if(_sockets[i] >= 0)
+			{
+				close(_sockets[i]);
+			}
+		}
+	}
+
+	void Communicator::write(int peer, const uint8_t * data, size_t size){
+		while(size > 0)
+		{
+			const ssize_t n = ::send(_sockets.at(peer), data, size, 0);
+			if(n < 0 && errno == EINTR)
+			{
+				continue;
+			}
+			if(n <= 0)
+			{
+				ARM_COMPUTE_ERROR("Rank %d cannot send to rank %d: %s", _rank, peer, strerror(errno));
+			}
+			data += n;
+			size -= n;
+		}
+	}
+
+	void Communicator::read(int peer, uint8_t * data, size_t size){
+		while(size > 0)
+		{
+			const ssize_t n = ::recv(_sockets.at(peer), data, size, 0);
+			if(n < 0 && errno == EINTR)
+			{
+				continue;
+			}
+			if(n == 0)
+			{
+				ARM_COMPUTE_ERROR("Rank %d closed the connection to rank %d", peer, _rank);
+			}
+			if(n < 0)
+			{
+				ARM_COMPUTE_ERROR("Rank %d cannot receive from rank %d: %s", _rank, peer, strerror(errno));
+			}
+			data += n;
+			size -= n;
+		}
+	}
+
+	void Communicator::send(int peer, const ITensor * tensor){
+		const ITensorInfo * info = tensor->info();
+		const size_t size = info->tensor_shape().total_size() * info->element_size();
+		if(info->padding().empty())
+		{
+			write(peer, tensor->buffer() + info->offset_first_element_in_bytes(), size);
+		}
+		else
+		{
+			//Pack the rows of the valid region, one row is the whole X dimension
+			const size_t row = info->dimension(0) * info->element_size();
+			_staging.resize(size);
+			uint8_t * dst = _staging.data();
+			Window window;
+			window.use_tensor_dimensions(info->tensor_shape());
+			window.set(Window::DimX, Window::Dimension(0, 1, 1));
+			execute_window_loop(window, [&](const Coordinates & id)
+			{
+				memcpy(dst, tensor->ptr_to_element(id), row);
+				dst += row;
+			});
+			write(peer, _staging.data(), size);
+		}
+		_bytes_sent += size;
+	}
+
+	void Communicator::recv(int peer, ITensor * tensor){
+		const ITensorInfo * info = tensor->info();
+		const size_t size = info->tensor_shape().total_size() * info->element_size();
+		if(info->padding().empty())
+		{
+			read(peer, tensor->buffer() + info->offset_first_element_in_bytes(), size);
+			return;
+		}
+		const size_t row = info->dimension(0) * info->element_size();
+		_staging.resize(size);
+		read(peer, _staging.data(), size);
+		const uint8_t * src = _staging.data();
+		Window window;
+		window.use_tensor_dimensions(info->tensor_shape());
+		window.set(Window::DimX, Window::Dimension(0, 1, 1));
+		execute_window_loop(window, [&](const Coordinates & id)
+		{
+			memcpy(tensor->ptr_to_element(id), src, row);
+			src += row;
+		});
+	}
+
+	int placeNode(const Node &node, int num_ranks){
+		return node.group < 0 ? 0 : node.group % num_ranks;
+	}
+
+	void savePlacement(const std::string &filename, const Graph &graph, const std::vector<int> &rank_of, int num_ranks,
+					   const std::string &comment){
+		std::ofstream fs(filename, std::ios::out | std::ios::trunc);
+		if(!fs.is_open())
+		{
+			ARM_COMPUTE_ERROR("Cannot write the placement %s", filename.c_str());
+		}
+		fs << "#" << comment << std::endl;
+		fs << "ranks " << num_ranks << std::endl;
+		for(const Node &node : graph.nodes())
+		{
+			fs << node.name << " " << rank_of.at(node.id) << std::endl;
+		}
+	}
+
+	std::function<int(const Node &)> loadPlacement(const std::string &filename, int num_ranks){
+		std::ifstream fs(filename);
+		if(!fs.is_open())
+		{
+			ARM_COMPUTE_ERROR("Cannot read the placement %s", filename.c_str());
+		}
+		std::map<std::string, int> ranks;
+		int planned = -1;
+		std::string line;
+		while(std::getline(fs, line))
+		{
+			std::istringstream is(line);
+			std::string name;
+			int rank = -1;
+			if(line.empty() || line[0] == '#' || !(is >> name >> rank))
+			{
+				continue;
+			}
+			if(name == "ranks")
+			{
+				planned = rank;
+			}
+			else if(rank < 0 || rank >= num_ranks)
+			{
+				ARM_COMPUTE_ERROR("%s puts %s on rank %d of %d", filename.c_str(), name.c_str(), rank, num_ranks);
+			}
+			else
+			{
+				ranks[name] = rank;
+			}
+		}
+		if(planned != num_ranks)
+		{
+			ARM_COMPUTE_ERROR("%s was planned for %d ranks, not %d", filename.c_str(), planned, num_ranks);
+		}
+		return [ranks, num_ranks](const Node &node)
+		{
+			const std::map<std::string, int>::const_iterator it = ranks.find(node.name);
+			return it == ranks.end() ? placeNode(node, num_ranks) : it->second;
+		};
+	}
+
+	static int runRank(int rank, const std::vector<int> &sockets, const std::function<int(Communicator &)> &body){
+		try
+		{
+			Communicator comm(rank, sockets);
+			return body(comm);
+		}
+		catch(const std::exception &e)
+		{
+			std::cerr << "Rank " << rank << ": " << e.what() << std::endl;
+			return 1;
+		}
+	}
+
+	std::vector<std::vector<int>> socketMesh(int num_ranks){
+		std::vector<std::vector<int>> sockets(num_ranks, std::vector<int>(num_ranks, -1));
+		for(int i = 0; i < num_ranks; i++)
+		{
+			for(int j = i + 1; j < num_ranks; j++)
+			{
+				int pair[2];
+				if(socketpair(AF_UNIX, SOCK_STREAM, 0, pair) != 0)
+				{
+					ARM_COMPUTE_ERROR("socketpair failed: %s", strerror(errno));
+				}
+				for(int k = 0; k < 2; k++)
+				{
+					setsockopt(pair[k], SOL_SOCKET, SO_SNDBUF, &socket_buffer, sizeof(socket_buffer));
+					setsockopt(pair[k], SOL_SOCKET, SO_RCVBUF, &socket_buffer, sizeof(socket_buffer));
+				}
+				sockets[i][j] = pair[0];
+				sockets[j][i] = pair[1];
+			}
+		}
+		return sockets;
+	}
+
+	int launchLocal(int num_ranks, const std::function<int(Communicator &)> &body){
+		if(num_ranks < 1)
+		{
+			ARM_COMPUTE_ERROR("At least one rank is needed");
+		}
+		std::vector<std::vector<int>> sockets = socketMesh(num_ranks);
+
+		//Every rank keeps its own row of the mesh and closes the others
+		const auto keepRow = [&](int rank)
+		{
+			for(int i = 0; i < num_ranks; i++)
+			{
+				for(int j = 0; j < num_ranks; j++)
+				{
+					if(i != rank && sockets[i][j] >= 0)
+					{
+						close(sockets[i][j]);
+					}
+				}
+			}
+		};
+
+		std::vector<pid_t> children;
+		for(int rank = 1; rank < num_ranks; rank++)
+		{
+			const pid_t pid = fork();
+			if(pid < 0)
+			{
+				ARM_COMPUTE_ERROR("fork failed: %s", strerror(errno));
+			}
+			if(pid == 0)
+			{
+				keepRow(rank);
+				const int code = runRank(rank, sockets[rank], body);
+				std::cout.flush();
+				_exit(code);
+			}
+			children.push_back(pid);
+		}
+
+		keepRow(0);
+		int result = runRank(0, sockets[0], body);
+		for(size_t i = 0; i < children.size(); i++)
+		{
+			int status = 0;
+			waitpid(children[i], &status, 0);
+			if(result == 0 && (!WIFEXITED(status) || WEXITSTATUS(status) != 0))
+			{
+				std::cerr << "Rank " << i + 1 << " failed" << std::endl;
+				result = 1;
+			}
+		}
+		return result;
+	}
+
+ }
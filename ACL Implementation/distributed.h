@@ -0,0 +1,67 @@
+#ifndef OPDISTRIBUTED
+#define OPDISTRIBUTED
+
+#include "graph.h"
+#include "arm_compute/core/ITensor.h"
+
+#include <functional>
+#include <string>
+#include <vector>
+
+using namespace arm_compute;
+
+namespace opGraph{
+
+	//Point to point links between the ranks of one inference, one stream socket per pair of ranks
+	//Transfers are blocking, every rank issues them in the global schedule order so they always pair up
+	class Communicator{
+	public:
+		//sockets[peer] is the connection to that rank, -1 for the rank itself
+		Communicator(int rank, const std::vector<int> &sockets);
+		~Communicator();
+		Communicator(const Communicator &) = delete;
+		Communicator &operator=(const Communicator &) = delete;
+
+		int rank() const { return _rank; }
+		int size() const { return static_cast<int>(_sockets.size()); }
+
+		//Only the valid region is sent, the padding of the two sides may differ
+		void send(int peer, const ITensor * tensor);
+		void recv(int peer, ITensor * tensor);
+		//Payload bytes sent by this rank since it was created
+		size_t bytesSent() const { return _bytes_sent; }
+
+	private:
+		void write(int peer, const uint8_t * data, size_t size);
+		void read(int peer, uint8_t * data, size_t size);
+
+		int _rank;
+		std::vector<int> _sockets;
+		std::vector<uint8_t> _staging;
+		size_t _bytes_sent;
+	};
+
+	//Rank that runs a node: decoupled groups are dealt round robin, everything the groups share stays on rank 0
+	int placeNode(const Node &node, int num_ranks);
+
+	//Placement files, written by plan_partition: a "ranks N" line then one "node rank" line per node of Network::graph()
+	//Nodes are named rather than numbered so the file survives options that change which nodes the passes remove
+	//rank_of is indexed by node id, comment goes on the first line
+	void savePlacement(const std::string &filename, const Graph &graph, const std::vector<int> &rank_of, int num_ranks,
+					   const std::string &comment);
+	//For CompileOptions::place, nodes the file does not name fall back to placeNode()
+	//Fails when the file was planned for another number of ranks
+	std::function<int(const Node &)> loadPlacement(const std::string &filename, int num_ranks);
+
+	//Full mesh of Unix socket pairs, mesh[i][j] is the end rank i uses to talk to rank j (-1 on the diagonal)
+	std::vector<std::vector<int>> socketMesh(int num_ranks);
+
+	//Stand-in for mpiexec on one board: forks num_ranks - 1 children connected to the parent
+	//by a full mesh of Unix socket pairs, runs body on every rank and waits for all of them
+	//Returns 0 when every rank returned 0
+	int launchLocal(int num_ranks, const std::function<int(Communicator &)> &body);
+
+ }
+
+
+#endif
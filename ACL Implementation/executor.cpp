@@ -0,0 +1,192 @@
+#include "executor.h"
+#include <arm_compute/runtime/Scheduler.h>
+
+#include <algorithm>
+
+namespace opGraph{
+
+	//Bytes a tensor may touch, padding included: its whole allocation, or for a channel view of a split or concat
+	//the planes of its channels. A view shares the buffer of its parent, its first element is a whole number of planes in
+	static void extent(const ITensor * tensor, const uint8_t * &begin, const uint8_t * &end){
+		const ITensorInfo * info = tensor->info();
+		begin = tensor->buffer();
+		end = begin + info->total_size();
+		const size_t plane = info->strides_in_bytes()[2];
+		if(info->num_dimensions() < 3 || plane == 0)
+		{
+			return;
+		}
+		begin += info->offset_first_element_in_bytes() / plane * plane;
+		end = std::min(end, begin + (info->dimension(3) - 1) * info->strides_in_bytes()[3] + info->dimension(2) * plane);
+	}
+
+	//Two tensors conflict when the bytes they may touch overlap
+	static bool overlaps(const ITensor * a, const ITensor * b){
+		if(a == b)
+		{
+			return true;
+		}
+		if(a->buffer() == nullptr || b->buffer() == nullptr)
+		{
+			return false;
+		}
+		const uint8_t * a_begin = nullptr;
+		const uint8_t * a_end = nullptr;
+		const uint8_t * b_begin = nullptr;
+		const uint8_t * b_end = nullptr;
+		extent(a, a_begin, a_end);
+		extent(b, b_begin, b_end);
+		return a_begin < b_end && b_begin < a_end;
+	}
+
+	static bool conflicts(const std::vector<ITensor *> &x, const std::vector<ITensor *> &y){
+		for(size_t i = 0; i < x.size(); i++)
+		{
+			for(size_t j = 0; j < y.size(); j++)
+			{
+				if(overlaps(x[i], y[j]))
+				{
+					return true;
+				}
+			}
+		}
+		return false;
+	}
+
+	static bool isLink(const Layer &layer){
+		return layer.type == OpType::Send || layer.type == OpType::Recv;
+	}
+
+	Executor::Executor(Network &network, int workers)
+		: _network(network), _successors(), _predecessors(), _pending(), _ready(), _remaining(0), _stop(false),
+		  _mutex(), _wake(), _done(), _threads()
+	{
+		const std::vector<Layer> &layers = _network.layers();
+		_successors.resize(layers.size());
+		_predecessors.assign(layers.size(), 0);
+		int last_link = -1;
+		for(size_t j = 0; j < layers.size(); j++)
+		{
+			for(size_t i = 0; i < j; i++)
+			{
+				//Read after write, write after read, write after write
+				if(conflicts(layers[i].outputs, layers[j].inputs) || conflicts(layers[i].inputs, layers[j].outputs)
+				   || conflicts(layers[i].outputs, layers[j].outputs))
+				{
+					_successors[i].push_back(j);
+					_predecessors[j]++;
+				}
+			}
+			//Transfers keep the global order every rank relies on to pair them up
+			if(isLink(layers[j]))
+			{
+				if(last_link >= 0 && std::find(_successors[last_link].begin(), _successors[last_link].end(), j) == _successors[last_link].end())
+				{
+					_successors[last_link].push_back(j);
+					_predecessors[j]++;
+				}
+				last_link = static_cast<int>(j);
+			}
+		}
+
+		for(int w = 0; w < std::max(workers, 1); w++)
+		{
+			_threads.emplace_back(&Executor::work, this);
+		}
+	}
+
+	Executor::~Executor(){
+		{
+			std::lock_guard<std::mutex> lock(_mutex);
+			_stop = true;
+		}
+		_wake.notify_all();
+		for(size_t t = 0; t < _threads.size(); t++)
+		{
+			_threads[t].join();
+		}
+	}
+
+	size_t Executor::dependencies() const{
+		size_t count = 0;
+		for(size_t i = 0; i < _successors.size(); i++)
+		{
+			count += _successors[i].size();
+		}
+		return count;
+	}
+
+	size_t Executor::depth() const{
+		//Successors always come later in the schedule, one pass in order is enough
+		std::vector<size_t> level(_successors.size(), 1);
+		size_t deepest = 0;
+		for(size_t i = 0; i < _successors.size(); i++)
+		{
+			deepest = std::max(deepest, level[i]);
+			for(size_t s = 0; s < _successors[i].size(); s++)
+			{
+				level[_successors[i][s]] = std::max(level[_successors[i][s]], level[i] + 1);
+			}
+		}
+		return deepest;
+	}
+
+	void Executor::run(){
+		if(_successors.empty())
+		{
+			return;
+		}
+		const Scheduler::Type previous = Scheduler::get_type();
+		Scheduler::set(Scheduler::Type::ST);
+		{
+			std::lock_guard<std::mutex> lock(_mutex);
+			_pending = _predecessors;
+			_remaining = _successors.size();
+			for(size_t i = 0; i < _pending.size(); i++)
+			{
+				if(_pending[i] == 0)
+				{
+					_ready.push(i);
+				}
+			}
+		}
+		_wake.notify_all();
+		{
+			std::unique_lock<std::mutex> lock(_mutex);
+			_done.wait(lock, [this] { return _remaining == 0; });
+		}
+		Scheduler::set(previous);
+	}
+
+	void Executor::work(){
+		const std::vector<Layer> &layers = _network.layers();
+		std::unique_lock<std::mutex> lock(_mutex);
+		while(true)
+		{
+			_wake.wait(lock, [this] { return _stop || !_ready.empty(); });
+			if(_stop)
+			{
+				return;
+			}
+			const size_t i = _ready.top();
+			_ready.pop();
+			lock.unlock();
+			layers[i].run();
+			lock.lock();
+
+			for(size_t s = 0; s < _successors[i].size(); s++)
+			{
+				if(--_pending[_successors[i][s]] == 0)
+				{
+					_ready.push(_successors[i][s]);
+					_wake.notify_one();
+				}
+			}
+			if(--_remaining == 0)
+			{
+				_done.notify_all();
+			}
+		}
+	}
+
+ }
@@ -0,0 +1,55 @@
+#ifndef OPEXECUTOR
+#define OPEXECUTOR
+
+#include "network.h"
+
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+namespace opGraph{
+
+	//Dependency-aware replacement of Network::run: layers start as soon as the layers they depend on are done,
+	//so independent branches (the shortcut of a downsampling block, the paths of the decoupled groups) overlap
+	//Two layers depend on each other when one writes memory the other reads or writes, compared by address,
+	//which also covers the activations the memory planner lets share one region
+	class Executor{
+	public:
+		//Build the network with workspace_pools = workers, otherwise convs running together queue for one workspace
+		Executor(Network &network, int workers);
+		~Executor();
+		Executor(const Executor &) = delete;
+		Executor &operator=(const Executor &) = delete;
+
+		//One inference, returns when every layer ran
+		//The kernels use the single threaded scheduler meanwhile, the CPP pool is not reentrant
+		void run();
+
+		int workers() const { return static_cast<int>(_threads.size()); }
+		size_t dependencies() const;
+		//Layers on the longest dependency chain, layers().size() / depth() bounds the available parallelism
+		size_t depth() const;
+
+	private:
+		void work();
+
+		Network &_network;
+		std::vector<std::vector<size_t>> _successors;
+		std::vector<int> _predecessors;		//number of layers each layer waits for
+		std::vector<int> _pending;			//countdown of the current run
+		std::priority_queue<size_t, std::vector<size_t>, std::greater<size_t>> _ready;	//earliest in the schedule first
+		size_t _remaining;
+		bool _stop;
+		std::mutex _mutex;
+		std::condition_variable _wake;
+		std::condition_variable _done;
+		std::vector<std::thread> _threads;
+	};
+
+ }
+
+
+#endif
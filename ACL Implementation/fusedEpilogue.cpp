@@ -0,0 +1,173 @@
+#include "fusedEpilogue.h"
+#include "arm_compute/core/Error.h"
+#include "arm_compute/core/Helpers.h"
+#include "arm_compute/core/Window.h"
+#include "arm_compute/runtime/NEON/NEScheduler.h"
+
+#include <algorithm>
+#include <limits>
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#elif defined(__AVX2__) && defined(__FMA__)
+#include <immintrin.h>
+#endif
+
+namespace opWrapper{
+
+	//One row of one channel, 8 values per iteration
+	static void epilogueRow(const float * in, const float * res, float * out, int width, float scale, float shift, float lower, float upper){
+		int x = 0;
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+		const float32x4_t vscale = vdupq_n_f32(scale);
+		const float32x4_t vshift = vdupq_n_f32(shift);
+		const float32x4_t vlower = vdupq_n_f32(lower);
+		const float32x4_t vupper = vdupq_n_f32(upper);
+		for(; x <= width - 8; x += 8)
+		{
+			float32x4_t a = vaddq_f32(vmlaq_f32(vshift, vld1q_f32(in + x), vscale), vld1q_f32(res + x));
+			float32x4_t b = vaddq_f32(vmlaq_f32(vshift, vld1q_f32(in + x + 4), vscale), vld1q_f32(res + x + 4));
+			vst1q_f32(out + x, vminq_f32(vmaxq_f32(a, vlower), vupper));
+			vst1q_f32(out + x + 4, vminq_f32(vmaxq_f32(b, vlower), vupper));
+		}
+#elif defined(__AVX2__) && defined(__FMA__)
+		const __m256 vscale = _mm256_set1_ps(scale);
+		const __m256 vshift = _mm256_set1_ps(shift);
+		const __m256 vlower = _mm256_set1_ps(lower);
+		const __m256 vupper = _mm256_set1_ps(upper);
+		for(; x <= width - 8; x += 8)
+		{
+			const __m256 v = _mm256_add_ps(_mm256_fmadd_ps(_mm256_loadu_ps(in + x), vscale, vshift), _mm256_loadu_ps(res + x));
+			_mm256_storeu_ps(out + x, _mm256_min_ps(_mm256_max_ps(v, vlower), vupper));
+		}
+#endif
+		for(; x < width; x++)
+		{
+			out[x] = std::min(std::max(in[x] * scale + shift + res[x], lower), upper);
+		}
+	}
+
+	//F16 rows are computed in F32, the conversions are in the base AArch64 instruction set unlike F16 arithmetic
+	static void epilogueRow(const half * in, const half * res, half * out, int width, float scale, float shift, float lower, float upper){
+		int x = 0;
+#if defined(__aarch64__)
+		const float32x4_t vscale = vdupq_n_f32(scale);
+		const float32x4_t vshift = vdupq_n_f32(shift);
+		const float32x4_t vlower = vdupq_n_f32(lower);
+		const float32x4_t vupper = vdupq_n_f32(upper);
+		const float16_t * in16 = reinterpret_cast<const float16_t *>(in);
+		const float16_t * res16 = reinterpret_cast<const float16_t *>(res);
+		float16_t * out16 = reinterpret_cast<float16_t *>(out);
+		for(; x <= width - 4; x += 4)
+		{
+			const float32x4_t v = vaddq_f32(vmlaq_f32(vshift, vcvt_f32_f16(vld1_f16(in16 + x)), vscale), vcvt_f32_f16(vld1_f16(res16 + x)));
+			vst1_f16(out16 + x, vcvt_f16_f32(vminq_f32(vmaxq_f32(v, vlower), vupper)));
+		}
+#endif
+		for(; x < width; x++)
+		{
+			const float v = static_cast<float>(in[x]) * scale + shift + static_cast<float>(res[x]);
+			out[x] = half(std::min(std::max(v, lower), upper));
+		}
+	}
+
+	void clampBounds(const ActivationLayerInfo &act_info, float &lower, float &upper){
+		lower = -std::numeric_limits<float>::infinity();
+		upper = std::numeric_limits<float>::infinity();
+		if(!act_info.enabled())
+		{
+			return;
+		}
+		switch(act_info.activation())
+		{
+			case ActivationLayerInfo::ActivationFunction::RELU:
+				lower = 0.f;
+				break;
+			case ActivationLayerInfo::ActivationFunction::BOUNDED_RELU:
+				lower = 0.f;
+				upper = act_info.a();
+				break;
+			case ActivationLayerInfo::ActivationFunction::LU_BOUNDED_RELU:
+				lower = act_info.b();
+				upper = act_info.a();
+				break;
+			default:
+				ARM_COMPUTE_ERROR("Only clamping activations can be fused, run other activations on their own");
+		}
+	}
+
+	NEFusedEpilogueKernel::NEFusedEpilogueKernel()
+		: _input(nullptr), _residual(nullptr), _output(nullptr), _scale(nullptr), _shift(nullptr),
+		  _lower(-std::numeric_limits<float>::infinity()), _upper(std::numeric_limits<float>::infinity())
+	{
+	}
+
+	void NEFusedEpilogueKernel::configure(const ITensor * input, const ITensor * residual, ITensor * output,
+										  const float * scale, const float * shift, const ActivationLayerInfo &act_info){
+		const ITensorInfo * info = input->info();
+		if(info->data_type() != DataType::F32 && info->data_type() != DataType::F16)
+		{
+			ARM_COMPUTE_ERROR("The fused epilogue only runs on F32 and F16");
+		}
+		if(residual->info()->data_type() != info->data_type() || output->info()->data_type() != info->data_type()
+		   || residual->info()->tensor_shape().total_size() != info->tensor_shape().total_size()
+		   || output->info()->tensor_shape().total_size() != info->tensor_shape().total_size())
+		{
+			ARM_COMPUTE_ERROR("The residual and the output of the fused epilogue must match its input");
+		}
+		_input = input;
+		_residual = residual;
+		_output = output;
+		_scale = scale;
+		_shift = shift;
+		clampBounds(act_info, _lower, _upper);
+		INEKernel::configure(calculate_max_window(*output->info(), Steps()));
+	}
+
+	void NEFusedEpilogueKernel::run(const Window &window, const ThreadInfo &info){
+		ARM_COMPUTE_UNUSED(info);
+		//The rows are walked here, the window loop only visits (y, channel, batch)
+		Window rows(window);
+		rows.set(Window::DimX, Window::Dimension(0, 1, 1));
+		const int width = window.x().end() - window.x().start();
+		Iterator in(_input, rows);
+		Iterator res(_residual, rows);
+		Iterator out(_output, rows);
+		if(_input->info()->data_type() == DataType::F16)
+		{
+			execute_window_loop(rows, [&](const Coordinates & id)
+			{
+				epilogueRow(reinterpret_cast<const half *>(in.ptr()), reinterpret_cast<const half *>(res.ptr()), reinterpret_cast<half *>(out.ptr()),
+							width, _scale[id[2]], _shift[id[2]], _lower, _upper);
+			}, in, res, out);
+			return;
+		}
+		execute_window_loop(rows, [&](const Coordinates & id)
+		{
+			epilogueRow(reinterpret_cast<const float *>(in.ptr()), reinterpret_cast<const float *>(res.ptr()), reinterpret_cast<float *>(out.ptr()),
+						width, _scale[id[2]], _shift[id[2]], _lower, _upper);
+		}, in, res, out);
+	}
+
+	FusedEpilogue::FusedEpilogue()
+		: _scale(), _shift(), _kernel()
+	{
+	}
+
+	void FusedEpilogue::configure(const ITensor * input, const ITensor * residual, ITensor * output,
+								  const std::vector<float> &scale, const std::vector<float> &shift, const ActivationLayerInfo &act_info){
+		const size_t channels = input->info()->dimension(2);
+		if((!scale.empty() || !shift.empty()) && (scale.size() != channels || shift.size() != channels))
+		{
+			ARM_COMPUTE_ERROR("One scale and one shift per channel");
+		}
+		_scale = scale.empty() ? std::vector<float>(channels, 1.f) : scale;
+		_shift = shift.empty() ? std::vector<float>(channels, 0.f) : shift;
+		_kernel.configure(input, residual, output, _scale.data(), _shift.data(), act_info);
+	}
+
+	void FusedEpilogue::run(){
+		NEScheduler::get().schedule(&_kernel, Window::DimY);
+	}
+
+ }
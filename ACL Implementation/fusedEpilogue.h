@@ -0,0 +1,64 @@
+#ifndef OPFUSEDEPILOGUE
+#define OPFUSEDEPILOGUE
+
+#include "arm_compute/core/NEON/INEKernel.h"
+#include "arm_compute/core/Types.h"
+#include "arm_compute/runtime/IFunction.h"
+
+#include <vector>
+
+using namespace arm_compute;
+
+namespace opWrapper{
+
+	//Bounds of the activations that are a clamp: RELU, BOUNDED_RELU and LU_BOUNDED_RELU, no activation clamps to +-infinity
+	//Fails on any other activation
+	void clampBounds(const ActivationLayerInfo &act_info, float &lower, float &upper);
+
+	//output = act(input * scale[c] + shift[c] + residual) in one pass over NCHW F32 or F16 tensors of the same shape
+	//This is the tail of a residual block: the BN that could not be folded, the shortcut add and the ReLU
+	//Rows are read with a scalar tail, the kernel asks for no padding
+	class NEFusedEpilogueKernel : public INEKernel{
+	public:
+		NEFusedEpilogueKernel();
+		NEFusedEpilogueKernel(const NEFusedEpilogueKernel &) = delete;
+		NEFusedEpilogueKernel &operator=(const NEFusedEpilogueKernel &) = delete;
+
+		const char * name() const override { return "NEFusedEpilogueKernel"; }
+		//scale and shift hold one value per channel and must outlive the kernel
+		//Only RELU, BOUNDED_RELU and LU_BOUNDED_RELU can be applied, they are a clamp of the sum
+		void configure(const ITensor * input, const ITensor * residual, ITensor * output,
+					   const float * scale, const float * shift, const ActivationLayerInfo &act_info);
+		void run(const Window &window, const ThreadInfo &info) override;
+
+	private:
+		const ITensor * _input;
+		const ITensor * _residual;
+		ITensor * _output;
+		const float * _scale;
+		const float * _shift;
+		float _lower;
+		float _upper;
+	};
+
+	//Owns the per-channel scale and shift of the kernel, an empty scale is the identity
+	class FusedEpilogue : public IFunction{
+	public:
+		FusedEpilogue();
+		FusedEpilogue(const FusedEpilogue &) = delete;
+		FusedEpilogue &operator=(const FusedEpilogue &) = delete;
+
+		void configure(const ITensor * input, const ITensor * residual, ITensor * output,
+					   const std::vector<float> &scale, const std::vector<float> &shift, const ActivationLayerInfo &act_info);
+		void run() override;
+
+	private:
+		std::vector<float> _scale;
+		std::vector<float> _shift;
+		NEFusedEpilogueKernel _kernel;
+	};
+
+ }
+
+
+#endif
@@ -0,0 +1,592 @@
+#include "graph.h"
+#include "arm_compute/core/Error.h"
+
+#include <algorithm>
+#include <queue>
+#include <functional>
+
+namespace opGraph{
+
+	const char * opName(OpType type){
+		switch(type)
+		{
+			case OpType::Input:				return "Input";
+			case OpType::Conv:				return "Conv";
+			case OpType::DWConv:			return "DWConv";
+			case OpType::BN:				return "BN";
+			case OpType::Activation:		return "Activation";
+			case OpType::MaxPool:			return "MaxPool";
+			case OpType::AvgPool:			return "AvgPool";
+			case OpType::Add:				return "Add";
+			case OpType::ChannelShuffle:	return "ChannelShuffle";
+			case OpType::Split:				return "Split";
+			case OpType::Concat:			return "Concat";
+			case OpType::ReduceMean:		return "ReduceMean";
+			case OpType::FC:				return "FC";
+			case OpType::Send:				return "Send";
+			case OpType::Recv:				return "Recv";
+			case OpType::Quantize:			return "Quantize";
+			case OpType::Dequantize:		return "Dequantize";
+			case OpType::Cast:				return "Cast";
+			default:						return "Unknown";
+		}
+	}
+
+	Graph::Graph()
+		: _nodes(), _edges(), _input(-1), _output(-1), _group(-1)
+	{
+	}
+
+	int Graph::addNode(OpType type, const std::string &name, const std::vector<int> &inputs, int num_outputs){
+		Node node;
+		node.id = static_cast<int>(_nodes.size());
+		node.type = type;
+		node.name = name;
+		node.inputs = inputs;
+		node.group = _group;
+
+		for(size_t i = 0; i < inputs.size(); i++)
+		{
+			if(inputs[i] < 0 || inputs[i] >= static_cast<int>(_edges.size()))
+			{
+				ARM_COMPUTE_ERROR("Unknown input edge");
+			}
+			_edges[inputs[i]].consumers.push_back(node.id);
+		}
+		for(int i = 0; i < num_outputs; i++)
+		{
+			Edge edge;
+			edge.id = static_cast<int>(_edges.size());
+			edge.name = num_outputs == 1 ? name + "_out" : name + "_out" + std::to_string(i);
+			edge.producer = node.id;
+			node.outputs.push_back(edge.id);
+			_edges.push_back(edge);
+		}
+		_nodes.push_back(node);
+		return node.id;
+	}
+
+	int Graph::input(const std::string &name, int w, int h, int c){
+		if(_input != -1)
+		{
+			ARM_COMPUTE_ERROR("Graph already has an input");
+		}
+		const int id = addNode(OpType::Input, name, std::vector<int>(), 1);
+		Edge &edge = _edges[_nodes[id].outputs[0]];
+		edge.w = w;
+		edge.h = h;
+		edge.c = c;
+		_input = edge.id;
+		return edge.id;
+	}
+
+	int Graph::conv(int in, const std::string &name, int channels, int kernel, int stride, int padding, int groups, bool relu){
+		const int id = addNode(OpType::Conv, name, std::vector<int>{ in }, 1);
+		Node &node = _nodes[id];
+		node.channels = channels;
+		node.kernel = kernel;
+		node.stride = stride;
+		node.padding = padding;
+		node.groups = groups;
+		node.relu = relu;
+		inferShape(node);
+		return node.outputs[0];
+	}
+
+	int Graph::dwconv(int in, const std::string &name, int kernel, int stride, int padding, bool relu){
+		const int id = addNode(OpType::DWConv, name, std::vector<int>{ in }, 1);
+		Node &node = _nodes[id];
+		node.channels = _edges[in].c;
+		node.kernel = kernel;
+		node.stride = stride;
+		node.padding = padding;
+		node.groups = _edges[in].c;
+		node.relu = relu;
+		inferShape(node);
+		return node.outputs[0];
+	}
+
+	int Graph::bn(int in, const std::string &name, bool relu){
+		const int id = addNode(OpType::BN, name, std::vector<int>{ in }, 1);
+		_nodes[id].relu = relu;
+		inferShape(_nodes[id]);
+		return _nodes[id].outputs[0];
+	}
+
+	int Graph::relu(int in, const std::string &name){
+		const int id = addNode(OpType::Activation, name, std::vector<int>{ in }, 1);
+		_nodes[id].relu = true;
+		inferShape(_nodes[id]);
+		return _nodes[id].outputs[0];
+	}
+
+	int Graph::maxpool(int in, const std::string &name, int kernel, int stride, int padding){
+		const int id = addNode(OpType::MaxPool, name, std::vector<int>{ in }, 1);
+		Node &node = _nodes[id];
+		node.kernel = kernel;
+		node.stride = stride;
+		node.padding = padding;
+		inferShape(node);
+		return node.outputs[0];
+	}
+
+	int Graph::avgpool(int in, const std::string &name, int kernel, int stride, int padding){
+		const int id = addNode(OpType::AvgPool, name, std::vector<int>{ in }, 1);
+		Node &node = _nodes[id];
+		node.kernel = kernel;
+		node.stride = stride;
+		node.padding = padding;
+		inferShape(node);
+		return node.outputs[0];
+	}
+
+	int Graph::add(int in1, int in2, const std::string &name, bool relu){
+		const int id = addNode(OpType::Add, name, std::vector<int>{ in1, in2 }, 1);
+		_nodes[id].relu = relu;
+		inferShape(_nodes[id]);
+		return _nodes[id].outputs[0];
+	}
+
+	int Graph::shuffle(int in, const std::string &name, int groups){
+		const int id = addNode(OpType::ChannelShuffle, name, std::vector<int>{ in }, 1);
+		_nodes[id].groups = groups;
+		inferShape(_nodes[id]);
+		return _nodes[id].outputs[0];
+	}
+
+	std::vector<int> Graph::split(int in, const std::string &name, int groups){
+		const int id = addNode(OpType::Split, name, std::vector<int>{ in }, groups);
+		_nodes[id].groups = groups;
+		inferShape(_nodes[id]);
+		return _nodes[id].outputs;
+	}
+
+	int Graph::concat(const std::vector<int> &ins, const std::string &name){
+		const int id = addNode(OpType::Concat, name, ins, 1);
+		inferShape(_nodes[id]);
+		return _nodes[id].outputs[0];
+	}
+
+	int Graph::reduceMean(int in, const std::string &name){
+		const int id = addNode(OpType::ReduceMean, name, std::vector<int>{ in }, 1);
+		inferShape(_nodes[id]);
+		return _nodes[id].outputs[0];
+	}
+
+	int Graph::fc(int in, const std::string &name, int channels){
+		const int id = addNode(OpType::FC, name, std::vector<int>{ in }, 1);
+		_nodes[id].channels = channels;
+		inferShape(_nodes[id]);
+		return _nodes[id].outputs[0];
+	}
+
+	void Graph::setGroup(int group){
+		_group = group;
+	}
+
+	void Graph::setOutput(int edge){
+		if(edge < 0 || edge >= static_cast<int>(_edges.size()))
+		{
+			ARM_COMPUTE_ERROR("Unknown output edge");
+		}
+		_output = edge;
+	}
+
+	//Output size of a sliding window, same rounding as DimensionRoundingType::FLOOR
+	static int windowOutput(int in, int kernel, int stride, int padding){
+		return (in + 2 * padding - kernel) / stride + 1;
+	}
+
+	void Graph::inferShape(const Node &node){
+		if(node.type == OpType::Input)
+		{
+			return;
+		}
+		const Edge &in = _edges[node.inputs[0]];
+		switch(node.type)
+		{
+			case OpType::Conv:
+			case OpType::DWConv:
+			case OpType::MaxPool:
+			case OpType::AvgPool:
+			{
+				Edge &out = _edges[node.outputs[0]];
+				out.w = windowOutput(in.w, node.kernel, node.stride, node.padding);
+				out.h = windowOutput(in.h, node.kernel, node.stride, node.padding);
+				out.c = node.type == OpType::Conv ? node.channels : in.c;
+				if(node.type == OpType::Conv && (node.groups < 1 || in.c % node.groups != 0 || node.channels % node.groups != 0))
+				{
+					ARM_COMPUTE_ERROR("Convolution channels are not divisible by the number of groups");
+				}
+				break;
+			}
+			case OpType::BN:
+			case OpType::Activation:
+			{
+				Edge &out = _edges[node.outputs[0]];
+				out.w = in.w;
+				out.h = in.h;
+				out.c = in.c;
+				break;
+			}
+			case OpType::Add:
+			{
+				const Edge &in2 = _edges[node.inputs[1]];
+				if(in.w != in2.w || in.h != in2.h || in.c != in2.c)
+				{
+					ARM_COMPUTE_ERROR("Add inputs have different shapes");
+				}
+				Edge &out = _edges[node.outputs[0]];
+				out.w = in.w;
+				out.h = in.h;
+				out.c = in.c;
+				break;
+			}
+			case OpType::ChannelShuffle:
+			{
+				if(node.groups < 1 || in.c % node.groups != 0)
+				{
+					ARM_COMPUTE_ERROR("Channel shuffle groups do not divide the channels");
+				}
+				Edge &out = _edges[node.outputs[0]];
+				out.w = in.w;
+				out.h = in.h;
+				out.c = in.c;
+				break;
+			}
+			case OpType::Split:
+			{
+				if(node.groups < 1 || in.c % node.groups != 0)
+				{
+					ARM_COMPUTE_ERROR("Split groups do not divide the channels");
+				}
+				for(size_t i = 0; i < node.outputs.size(); i++)
+				{
+					Edge &out = _edges[node.outputs[i]];
+					out.w = in.w;
+					out.h = in.h;
+					out.c = in.c / node.groups;
+				}
+				break;
+			}
+			case OpType::Concat:
+			{
+				Edge &out = _edges[node.outputs[0]];
+				out.w = in.w;
+				out.h = in.h;
+				out.c = 0;
+				for(size_t i = 0; i < node.inputs.size(); i++)
+				{
+					if(_edges[node.inputs[i]].w != in.w || _edges[node.inputs[i]].h != in.h)
+					{
+						ARM_COMPUTE_ERROR("Concat inputs have different sizes");
+					}
+					out.c += _edges[node.inputs[i]].c;
+				}
+				break;
+			}
+			case OpType::ReduceMean:
+			{
+				Edge &out = _edges[node.outputs[0]];
+				out.w = 1;
+				out.h = 1;
+				out.c = in.c;
+				break;
+			}
+			case OpType::FC:
+			{
+				Edge &out = _edges[node.outputs[0]];
+				out.w = node.channels;
+				out.h = 1;
+				out.c = 1;
+				break;
+			}
+			default:
+				ARM_COMPUTE_ERROR("Unsupported node type");
+		}
+	}
+
+	void Graph::bypass(int id){
+		Node &node = _nodes.at(id);
+		if(node.inputs.size() != 1 || node.outputs.size() != 1)
+		{
+			ARM_COMPUTE_ERROR("Only single input, single output nodes can be fused");
+		}
+		Edge &in = _edges[node.inputs[0]];
+		if(in.consumers.size() != 1 || in.id == _input || in.id == _output)
+		{
+			ARM_COMPUTE_ERROR("Input of a fused node must only feed that node");
+		}
+
+		Node &producer = _nodes[in.producer];
+		for(size_t o = 0; o < producer.outputs.size(); o++)
+		{
+			if(producer.outputs[o] == in.id)
+			{
+				producer.outputs[o] = node.outputs[0];
+			}
+		}
+		_edges[node.outputs[0]].producer = producer.id;
+
+		//Dead entries are dropped by compact()
+		node.id = -1;
+		in.id = -1;
+	}
+
+	void Graph::compact(){
+		std::vector<int> node_map(_nodes.size(), -1);
+		std::vector<int> edge_map(_edges.size(), -1);
+		std::vector<Node> nodes;
+		std::vector<Edge> edges;
+		for(size_t i = 0; i < _nodes.size(); i++)
+		{
+			if(_nodes[i].id >= 0)
+			{
+				node_map[i] = static_cast<int>(nodes.size());
+				nodes.push_back(_nodes[i]);
+			}
+		}
+		for(size_t i = 0; i < _edges.size(); i++)
+		{
+			if(_edges[i].id >= 0)
+			{
+				edge_map[i] = static_cast<int>(edges.size());
+				edges.push_back(_edges[i]);
+			}
+		}
+
+		for(size_t i = 0; i < nodes.size(); i++)
+		{
+			nodes[i].id = static_cast<int>(i);
+			for(size_t e = 0; e < nodes[i].inputs.size(); e++)
+			{
+				nodes[i].inputs[e] = edge_map[nodes[i].inputs[e]];
+			}
+			for(size_t e = 0; e < nodes[i].outputs.size(); e++)
+			{
+				nodes[i].outputs[e] = edge_map[nodes[i].outputs[e]];
+			}
+		}
+		for(size_t i = 0; i < edges.size(); i++)
+		{
+			edges[i].id = static_cast<int>(i);
+			edges[i].producer = node_map[edges[i].producer];
+			std::vector<int> consumers;
+			for(size_t c = 0; c < edges[i].consumers.size(); c++)
+			{
+				if(node_map[edges[i].consumers[c]] >= 0)
+				{
+					consumers.push_back(node_map[edges[i].consumers[c]]);
+				}
+			}
+			edges[i].consumers = consumers;
+		}
+
+		_input = _input < 0 ? -1 : edge_map[_input];
+		_output = _output < 0 ? -1 : edge_map[_output];
+		_nodes = nodes;
+		_edges = edges;
+	}
+
+	void Graph::fuseIntoProducer(int id){
+		bypass(id);
+		compact();
+	}
+
+	int Graph::foldBatchNorm(){
+		int folded = 0;
+		for(size_t i = 0; i < _nodes.size(); i++)
+		{
+			Node &bn = _nodes[i];
+			if(bn.type != OpType::BN)
+			{
+				continue;
+			}
+			const Edge &in = _edges[bn.inputs[0]];
+			if(in.producer < 0 || in.consumers.size() != 1 || in.id == _output)
+			{
+				continue;
+			}
+			Node &conv = _nodes[in.producer];
+			//A ReLU between the conv and the BN is not affine, leave the pair alone
+			if((conv.type != OpType::Conv && conv.type != OpType::DWConv) || conv.relu || !conv.bn.empty())
+			{
+				continue;
+			}
+			conv.bn = bn.name;
+			conv.relu = bn.relu;
+			bypass(bn.id);
+			folded++;
+		}
+		compact();
+		return folded;
+	}
+
+	int Graph::foldBatchNormIntoAdd(){
+		int folded = 0;
+		for(size_t i = 0; i < _nodes.size(); i++)
+		{
+			const Node &bn = _nodes[i];
+			if(bn.type != OpType::BN || bn.relu)
+			{
+				continue;
+			}
+			Edge &out = _edges[bn.outputs[0]];
+			if(out.consumers.size() != 1 || out.id == _output)
+			{
+				continue;
+			}
+			Node &add = _nodes[out.consumers[0]];
+			if(add.type != OpType::Add || !add.bn.empty())
+			{
+				continue;
+			}
+			//The BN side becomes the first input, the add reads the BN input directly
+			if(add.inputs[0] != out.id)
+			{
+				std::swap(add.inputs[0], add.inputs[1]);
+			}
+			Edge &in = _edges[bn.inputs[0]];
+			add.inputs[0] = in.id;
+			std::replace(in.consumers.begin(), in.consumers.end(), bn.id, add.id);
+			add.bn = bn.name;
+
+			//Dead entries are dropped by compact()
+			out.id = -1;
+			_nodes[i].id = -1;
+			folded++;
+		}
+		compact();
+		return folded;
+	}
+
+	int Graph::foldChannelShuffle(bool grouped_producers){
+		int folded = 0;
+		for(size_t i = 0; i < _nodes.size(); i++)
+		{
+			const Node &shuffle = _nodes[i];
+			if(shuffle.type != OpType::ChannelShuffle)
+			{
+				continue;
+			}
+			std::vector<int> chain;
+			bool found = false;
+			int edge = shuffle.inputs[0];
+			while(true)
+			{
+				const Edge &e = _edges[edge];
+				if(e.producer < 0 || e.consumers.size() != 1 || e.id == _input || e.id == _output)
+				{
+					break;
+				}
+				const Node &producer = _nodes[e.producer];
+				if(producer.shuffle != 0)
+				{
+					break;
+				}
+				if(producer.type == OpType::DWConv || producer.type == OpType::Activation)
+				{
+					chain.push_back(producer.id);
+					edge = producer.inputs[0];
+					continue;
+				}
+				found = producer.type == OpType::Conv && (producer.groups == 1 || (grouped_producers && producer.groups == shuffle.groups));
+				chain.push_back(producer.id);
+				break;
+			}
+			if(!found)
+			{
+				continue;
+			}
+			for(size_t c = 0; c < chain.size(); c++)
+			{
+				if(_nodes[chain[c]].type != OpType::Activation)
+				{
+					_nodes[chain[c]].shuffle = shuffle.groups;
+				}
+			}
+			bypass(shuffle.id);
+			folded++;
+		}
+		compact();
+		return folded;
+	}
+
+	std::vector<int> Graph::schedule() const{
+		//Kahn's algorithm, the min-heap keeps the builder order whenever it is legal
+		std::vector<int> pending(_nodes.size(), 0);
+		for(size_t i = 0; i < _nodes.size(); i++)
+		{
+			pending[i] = static_cast<int>(_nodes[i].inputs.size());
+		}
+		std::priority_queue<int, std::vector<int>, std::greater<int>> ready;
+		for(size_t i = 0; i < _nodes.size(); i++)
+		{
+			if(pending[i] == 0)
+			{
+				ready.push(static_cast<int>(i));
+			}
+		}
+
+		std::vector<int> order;
+		while(!ready.empty())
+		{
+			const int id = ready.top();
+			ready.pop();
+			order.push_back(id);
+			for(size_t o = 0; o < _nodes[id].outputs.size(); o++)
+			{
+				const Edge &edge = _edges[_nodes[id].outputs[o]];
+				for(size_t c = 0; c < edge.consumers.size(); c++)
+				{
+					//A node may read the same edge twice (x + x), it is listed once per input
+					if(--pending[edge.consumers[c]] == 0)
+					{
+						ready.push(edge.consumers[c]);
+					}
+				}
+			}
+		}
+		if(order.size() != _nodes.size())
+		{
+			ARM_COMPUTE_ERROR("Graph has a cycle");
+		}
+		return order;
+	}
+
+	void Graph::inferShapes(){
+		const std::vector<int> order = schedule();
+		for(size_t i = 0; i < order.size(); i++)
+		{
+			inferShape(_nodes[order[i]]);
+		}
+	}
+
+	void Graph::print(std::ostream &os) const{
+		const std::vector<int> order = schedule();
+		for(size_t i = 0; i < order.size(); i++)
+		{
+			const Node &node = _nodes[order[i]];
+			os << node.name << " [" << opName(node.type) << "]";
+			if(!node.bn.empty())
+			{
+				os << " +" << node.bn;
+			}
+			if(node.shuffle > 0)
+			{
+				os << " shuffled " << node.shuffle;
+			}
+			if(node.group >= 0)
+			{
+				os << " group " << node.group;
+			}
+			for(size_t o = 0; o < node.outputs.size(); o++)
+			{
+				const Edge &edge = _edges[node.outputs[o]];
+				os << " -> " << edge.w << "x" << edge.h << "x" << edge.c;
+			}
+			os << std::endl;
+		}
+	}
+
+ }
@@ -0,0 +1,146 @@
+#ifndef OPGRAPH
+#define OPGRAPH
+
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace opGraph{
+
+	//The operators we know how to lower onto the opWrapper layers
+	enum class OpType{
+		Input,
+		Conv,
+		DWConv,
+		BN,
+		Activation,
+		MaxPool,
+		AvgPool,
+		Add,
+		ChannelShuffle,
+		Split,
+		Concat,
+		ReduceMean,
+		FC,
+		//Runtime only, the layers that move a tensor between ranks are never part of a Graph
+		Send,
+		Recv,
+		//Runtime only, the F32 boundary of a QASYMM8 network
+		Quantize,
+		Dequantize,
+		//Runtime only, F16 to F32 and back around the layers a F16 network keeps in F32
+		Cast
+	};
+
+	const char * opName(OpType type);
+
+	//An edge is one activation tensor flowing between two nodes
+	//Shapes are kept in ACL order (W, H, C) so they can be compared with TensorInfo directly
+	struct Edge{
+		int id;
+		std::string name;
+		int w;
+		int h;
+		int c;
+		int producer;
+		std::vector<int> consumers;
+
+		Edge()
+			: id(-1), name(), w(0), h(0), c(0), producer(-1), consumers()
+		{
+		}
+		size_t elements() const { return static_cast<size_t>(w) * h * c; }
+	};
+
+	//A node is one layer, it is lowered onto one (or a few) opWrapper calls
+	struct Node{
+		int id;
+		OpType type;
+		std::string name;
+		std::vector<int> inputs;
+		std::vector<int> outputs;
+		int kernel;
+		int stride;
+		int padding;
+		int channels;	//output channels of Conv and FC
+		int groups;		//grouped Conv, ChannelShuffle and Split
+		bool relu;		//activation fused at the end of the node
+		int group;		//decoupled channel group the node belongs to, -1 if it sees every channel
+		std::string bn;	//BN folded into a Conv or DWConv, its parameters are merged into the weights and a bias at load time,
+						//or into an Add, which applies it to its first input
+		int shuffle;	//a ChannelShuffle with this many groups is folded in, the node writes its channels in shuffled order
+
+		Node()
+			: id(-1), type(OpType::Input), name(), inputs(), outputs(), kernel(1), stride(1), padding(0),
+			  channels(0), groups(1), relu(false), group(-1), bn(), shuffle(0)
+		{
+		}
+	};
+
+	class Graph{
+	public:
+		Graph();
+
+		//Builder interface, every call returns the id of the produced edge
+		int input(const std::string &name, int w, int h, int c);
+		int conv(int in, const std::string &name, int channels, int kernel, int stride, int padding, int groups = 1, bool relu = false);
+		int dwconv(int in, const std::string &name, int kernel, int stride, int padding, bool relu = false);
+		int bn(int in, const std::string &name, bool relu = false);
+		int relu(int in, const std::string &name);
+		int maxpool(int in, const std::string &name, int kernel, int stride, int padding);
+		int avgpool(int in, const std::string &name, int kernel, int stride, int padding);
+		int add(int in1, int in2, const std::string &name, bool relu = false);
+		int shuffle(int in, const std::string &name, int groups);
+		std::vector<int> split(int in, const std::string &name, int groups);
+		int concat(const std::vector<int> &ins, const std::string &name);
+		int reduceMean(int in, const std::string &name);
+		int fc(int in, const std::string &name, int channels);
+
+		//Nodes created after this call are tagged with the given decoupled group (-1 to clear)
+		void setGroup(int group);
+		void setOutput(int edge);
+
+		int inputEdge() const { return _input; }
+		int outputEdge() const { return _output; }
+		const std::vector<Node> & nodes() const { return _nodes; }
+		const std::vector<Edge> & edges() const { return _edges; }
+		const Node & node(int id) const { return _nodes.at(id); }
+		const Edge & edge(int id) const { return _edges.at(id); }
+
+		//Remove a single input, single output node, the producer of its input writes the node output directly
+		//Node and edge ids are renumbered, creation order is kept
+		void fuseIntoProducer(int id);
+		//Fold every BN that directly follows a Conv or a DWConv into it, returns the number of BN removed
+		int foldBatchNorm();
+		//Fold every BN left after foldBatchNorm whose only consumer is an Add into that Add, which applies it
+		//to its first input. The BN input is moved there, returns the number of BN removed
+		int foldBatchNormIntoAdd();
+		//Fold every ChannelShuffle into the Conv that mixes its channels, walking up through DWConv and ReLU
+		//which only see one channel at a time. The Conv writes its channels in shuffled order: a dense one through
+		//permuted weights, a grouped one (grouped_producers, needs channel views) by interleaving its groups.
+		//The DWConv in between get permuted weights. Returns the number of shuffles removed
+		int foldChannelShuffle(bool grouped_producers);
+
+		//Topological order of the node ids, ties are broken by creation order
+		std::vector<int> schedule() const;
+		//Recompute every edge shape from the input following the schedule
+		void inferShapes();
+		void print(std::ostream &os) const;
+
+	private:
+		int addNode(OpType type, const std::string &name, const std::vector<int> &inputs, int num_outputs);
+		void inferShape(const Node &node);
+		void bypass(int id);
+		void compact();
+
+		std::vector<Node> _nodes;
+		std::vector<Edge> _edges;
+		int _input;
+		int _output;
+		int _group;
+	};
+
+ }
+
+
+#endif
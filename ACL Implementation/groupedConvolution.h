@@ -0,0 +1,127 @@
+#ifndef OPGROUPEDCONVOLUTION
+#define OPGROUPEDCONVOLUTION
+
+#include "arm_compute/runtime/IFunction.h"
+#include "arm_compute/runtime/SubTensor.h"
+
+#include <memory>
+#include <vector>
+
+using namespace arm_compute;
+
+namespace opWrapper{
+
+	//Every step-th channel of an NCHW parent starting at first, a slice SubTensor cannot express
+	//It starts as a tensor info of its own so the kernels can ask for padding while they are configured,
+	//extendParent() passes that padding on and bind() takes the strides from the parent once it is allocated
+	class ChannelView : public ITensor{
+	public:
+		ChannelView(ITensor * parent, unsigned int first, unsigned int channels, unsigned int step)
+			: _parent(parent), _first(first), _step(step), _info()
+		{
+			TensorShape shape = parent->info()->tensor_shape();
+			shape.set(2, channels);
+			_info = TensorInfo(shape, 1, parent->info()->data_type(), parent->info()->quantization_info());
+		}
+		ChannelView(const ChannelView &) = delete;
+		ChannelView &operator=(const ChannelView &) = delete;
+
+		ITensorInfo * info() const override { return &_info; }
+		ITensorInfo * info() override { return &_info; }
+		uint8_t * buffer() const override { return _parent->buffer(); }
+
+		//After the kernels writing the view are configured, before the parent is allocated
+		void extendParent(){
+			_parent->info()->extend_padding(_info.padding());
+		}
+		//The parent padding is final once it is allocated, every row of the view is a row of the parent
+		void bind(){
+			const ITensorInfo * parent = _parent->info();
+			Strides strides = parent->strides_in_bytes();
+			strides.set(2, parent->strides_in_bytes()[2] * _step);
+			const size_t offset = parent->offset_first_element_in_bytes() + _first * parent->strides_in_bytes()[2];
+			const QuantizationInfo quantization = _info.quantization_info();
+			_info.init(_info.tensor_shape(), 1, _info.data_type(), strides, offset, parent->total_size());
+			_info.set_quantization_info(quantization);
+			_info.set_is_resizable(false);
+		}
+
+	private:
+		ITensor * _parent;
+		unsigned int _first;
+		unsigned int _step;
+		mutable TensorInfo _info;
+	};
+
+	//Convolution with groups > 1: one dense convolution per group, each reading and writing
+	//a channel slice of the parent tensors through a SubTensor view, so no split or concat buffer exists
+	//The views extend the padding of their parents, which must not be allocated before every group is configured
+	//With step > 1 the groups write interleaved channels, which is how a channel shuffle after the conv is folded in
+	class GroupedConvolution : public IFunction{
+	public:
+		GroupedConvolution()
+			: _views(), _strided(), _convs(), _bound(false)
+		{
+		}
+		GroupedConvolution(const GroupedConvolution &) = delete;
+		GroupedConvolution &operator=(const GroupedConvolution &) = delete;
+
+		//Channels first, first + step, ... of an NCHW tensor (channels of them), owned by this function
+		ITensor * view(ITensor * parent, unsigned int first, unsigned int channels, unsigned int step = 1){
+			if(step > 1)
+			{
+				_strided.push_back(new ChannelView(parent, first, channels, step));
+				_views.emplace_back(_strided.back());
+				return _views.back().get();
+			}
+			TensorShape shape = parent->info()->tensor_shape();
+			shape.set(2, channels);
+			Coordinates coords;
+			coords.set(2, first);
+			_views.emplace_back(new SubTensor(parent, shape, coords, true));
+			return _views.back().get();
+		}
+		//Once every group is configured
+		void extendParents(){
+			for(size_t v = 0; v < _strided.size(); v++)
+			{
+				_strided[v]->extendParent();
+			}
+		}
+		void add(IFunction * conv){ _convs.emplace_back(conv); }
+		size_t groups() const { return _convs.size(); }
+
+		//Reshapes the weights of every group, run() does it on its own otherwise
+		void prepare() override{
+			for(size_t g = 0; g < _convs.size(); g++)
+			{
+				_convs[g]->prepare();
+			}
+		}
+
+		void run() override{
+			if(!_bound)
+			{
+				for(size_t v = 0; v < _strided.size(); v++)
+				{
+					_strided[v]->bind();
+				}
+				_bound = true;
+			}
+			for(size_t g = 0; g < _convs.size(); g++)
+			{
+				_convs[g]->run();
+			}
+		}
+
+	private:
+		std::vector<std::unique_ptr<ITensor>> _views;
+		std::vector<ChannelView *> _strided;	//owned by _views
+		std::vector<std::unique_ptr<IFunction>> _convs;
+		bool _bound;
+	};
+
+ }
+
+
+#endif
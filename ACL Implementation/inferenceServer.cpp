@@ -0,0 +1,331 @@
+#include "inferenceServer.h"
+#include "arm_compute/core/Error.h"
+
+#include <algorithm>
+#include <cstring>
+#include <iomanip>
+#include <poll.h>
+#include <sstream>
+#include <sys/un.h>
+
+namespace opGraph{
+
+	static double percentile(const std::vector<double> &sorted, double p){
+		if(sorted.empty())
+		{
+			return 0;
+		}
+		const size_t index = static_cast<size_t>(p * (sorted.size() - 1) + 0.5);
+		return sorted[std::min(index, sorted.size() - 1)];
+	}
+
+	//Requests the latency percentiles are computed over, a long-lived server keeps no more
+	static const size_t latency_window = 1 << 16;
+
+	//Skip the payload of a message whose payload is not used
+	static bool discard(int fd, size_t size){
+		uint8_t buffer[4096];
+		while(size > 0)
+		{
+			const size_t n = std::min(size, sizeof(buffer));
+			if(!readAll(fd, buffer, n))
+			{
+				return false;
+			}
+			size -= n;
+		}
+		return true;
+	}
+
+	InferenceServer::InferenceServer(Network &network, const std::string &socket_path, double max_wait_ms)
+		: _network(network), _socket_path(socket_path), _max_wait(max_wait_ms), _image_size(0), _classes(0), _listen(-1),
+		  _stop_requested(false), _mutex(), _arrived(), _done(), _queue(), _stop(false), _connections(), _fds(), _finished(),
+		  _latency(), _requests(0), _fill(network.batch() + 1, 0), _queue_wait(0), _run(0)
+	{
+		const ITensorInfo * input = network.input()->info();
+		_image_size = input->dimension(0) * input->dimension(1) * input->dimension(2);
+		_classes = network.output()->info()->dimension(0);
+
+		sockaddr_un address;
+		memset(&address, 0, sizeof(address));
+		address.sun_family = AF_UNIX;
+		if(socket_path.size() >= sizeof(address.sun_path))
+		{
+			ARM_COMPUTE_ERROR("Socket path %s is too long", socket_path.c_str());
+		}
+		strncpy(address.sun_path, socket_path.c_str(), sizeof(address.sun_path) - 1);
+		//A previous server that was killed leaves its socket file behind
+		unlink(socket_path.c_str());
+		_listen = socket(AF_UNIX, SOCK_STREAM, 0);
+		if(_listen < 0 || bind(_listen, reinterpret_cast<sockaddr *>(&address), sizeof(address)) != 0 || listen(_listen, 64) != 0)
+		{
+			ARM_COMPUTE_ERROR("Cannot listen on %s: %s", socket_path.c_str(), strerror(errno));
+		}
+	}
+
+	InferenceServer::~InferenceServer(){
+		if(_listen >= 0)
+		{
+			close(_listen);
+			unlink(_socket_path.c_str());
+		}
+	}
+
+	void InferenceServer::serve(){
+		std::thread batch_thread(&InferenceServer::batcher, this);
+		while(!_stop_requested.load())
+		{
+			reap();
+			//Wake up now and then to notice stop()
+			pollfd pfd = { _listen, POLLIN, 0 };
+			if(poll(&pfd, 1, 200) <= 0)
+			{
+				continue;
+			}
+			const int fd = accept(_listen, nullptr, nullptr);
+			if(fd < 0)
+			{
+				continue;
+			}
+			std::lock_guard<std::mutex> lock(_mutex);
+			_fds.push_back(fd);
+			_connections.emplace_back(&InferenceServer::connection, this, fd);
+		}
+
+		{
+			std::lock_guard<std::mutex> lock(_mutex);
+			_stop = true;
+			//Unblocks the connections still reading a request
+			for(size_t i = 0; i < _fds.size(); i++)
+			{
+				shutdown(_fds[i], SHUT_RDWR);
+			}
+		}
+		_arrived.notify_all();
+		batch_thread.join();
+		_done.notify_all();
+		for(size_t i = 0; i < _connections.size(); i++)
+		{
+			_connections[i].join();
+		}
+		for(size_t i = 0; i < _fds.size(); i++)
+		{
+			close(_fds[i]);
+		}
+		_connections.clear();
+		_fds.clear();
+		_finished.clear();
+	}
+
+	void InferenceServer::reap(){
+		std::vector<std::thread> threads;
+		{
+			std::lock_guard<std::mutex> lock(_mutex);
+			for(size_t f = 0; f < _finished.size(); f++)
+			{
+				const size_t i = std::find(_fds.begin(), _fds.end(), _finished[f]) - _fds.begin();
+				threads.push_back(std::move(_connections[i]));
+				close(_fds[i]);
+				_connections.erase(_connections.begin() + i);
+				_fds.erase(_fds.begin() + i);
+			}
+			_finished.clear();
+		}
+		for(size_t i = 0; i < threads.size(); i++)
+		{
+			threads[i].join();
+		}
+	}
+
+	void InferenceServer::connection(int fd){
+		ServerHeader header;
+		while(receiveHeader(fd, header))
+		{
+			//Info and Stats take no payload, one sent anyway is skipped so the next header is read where it starts
+			if((header.type == static_cast<uint32_t>(MessageType::Info) || header.type == static_cast<uint32_t>(MessageType::Stats))
+			   && !discard(fd, header.size))
+			{
+				break;
+			}
+			if(header.type == static_cast<uint32_t>(MessageType::Info))
+			{
+				const ITensorInfo * input = _network.input()->info();
+				const ServerInfo info = { static_cast<uint32_t>(input->dimension(0)), static_cast<uint32_t>(input->dimension(1)),
+										  static_cast<uint32_t>(input->dimension(2)), static_cast<uint32_t>(_classes),
+										  static_cast<uint32_t>(_network.batch()) };
+				if(!sendMessage(fd, MessageType::Info, 0, &info, sizeof(info)))
+				{
+					break;
+				}
+				continue;
+			}
+			if(header.type == static_cast<uint32_t>(MessageType::Stats))
+			{
+				std::ostringstream os;
+				printStats(os);
+				const std::string text = os.str();
+				if(!sendMessage(fd, MessageType::Stats, 0, text.data(), text.size()))
+				{
+					break;
+				}
+				continue;
+			}
+			if(header.type != static_cast<uint32_t>(MessageType::Infer) || header.size != _image_size * sizeof(float))
+			{
+				sendMessage(fd, static_cast<MessageType>(header.type), 1, nullptr, 0);
+				break;
+			}
+
+			Request request;
+			request.image.resize(_image_size);
+			if(!readAll(fd, request.image.data(), header.size))
+			{
+				break;
+			}
+			{
+				std::unique_lock<std::mutex> lock(_mutex);
+				if(_stop)
+				{
+					break;
+				}
+				request.arrival = Clock::now();
+				_queue.push_back(&request);
+				_arrived.notify_one();
+				//Once taken the request belongs to the batcher until it is done
+				_done.wait(lock, [&] { return request.done || (_stop && !request.taken); });
+				if(!request.done)
+				{
+					_queue.erase(std::remove(_queue.begin(), _queue.end(), &request), _queue.end());
+					break;
+				}
+			}
+			if(!sendMessage(fd, MessageType::Infer, 0, request.scores.data(), request.scores.size() * sizeof(float)))
+			{
+				break;
+			}
+		}
+		//The accept loop joins this thread and closes the socket
+		std::lock_guard<std::mutex> lock(_mutex);
+		_finished.push_back(fd);
+	}
+
+	void InferenceServer::batcher(){
+		const size_t capacity = static_cast<size_t>(_network.batch());
+		const Clock::duration max_wait = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double, std::milli>(_max_wait));
+		while(true)
+		{
+			std::vector<Request *> batch;
+			{
+				std::unique_lock<std::mutex> lock(_mutex);
+				_arrived.wait(lock, [this] { return !_queue.empty() || _stop; });
+				if(_stop)
+				{
+					return;
+				}
+				//The deadline belongs to the oldest image, later ones wait less
+				const Clock::time_point deadline = _queue.front()->arrival + max_wait;
+				_arrived.wait_until(lock, deadline, [&] { return _queue.size() >= capacity || _stop; });
+				if(_stop)
+				{
+					return;
+				}
+				while(!_queue.empty() && batch.size() < capacity)
+				{
+					_queue.front()->taken = true;
+					batch.push_back(_queue.front());
+					_queue.pop_front();
+				}
+			}
+			runBatch(batch);
+		}
+	}
+
+	void InferenceServer::runBatch(const std::vector<Request *> &batch){
+		const Clock::time_point begin = Clock::now();
+		Tensor * input = _network.input();
+		const ITensorInfo * info = input->info();
+		const Strides &strides = info->strides_in_bytes();
+		const size_t width = info->dimension(0);
+		const size_t height = info->dimension(1);
+		const size_t channels = info->dimension(2);
+		for(size_t b = 0; b < batch.size(); b++)
+		{
+			//Row by row, the input may be padded
+			uint8_t * base = input->buffer() + info->offset_first_element_in_bytes() + b * strides[3];
+			const float * image = batch[b]->image.data();
+			for(size_t c = 0; c < channels; c++)
+			{
+				for(size_t y = 0; y < height; y++)
+				{
+					memcpy(base + c * strides[2] + y * strides[1], image + (c * height + y) * width, width * sizeof(float));
+				}
+			}
+		}
+
+		_network.run();
+
+		const ITensorInfo * out = _network.output()->info();
+		const uint8_t * scores = _network.output()->buffer() + out->offset_first_element_in_bytes();
+		for(size_t b = 0; b < batch.size(); b++)
+		{
+			const float * row = reinterpret_cast<const float *>(scores + b * out->strides_in_bytes()[1]);
+			batch[b]->scores.assign(row, row + _classes);
+		}
+
+		const Clock::time_point end = Clock::now();
+		{
+			std::lock_guard<std::mutex> lock(_mutex);
+			for(size_t b = 0; b < batch.size(); b++)
+			{
+				const double latency = std::chrono::duration<double, std::milli>(end - batch[b]->arrival).count();
+				if(_latency.size() < latency_window)
+				{
+					_latency.push_back(latency);
+				}
+				else
+				{
+					_latency[_requests % latency_window] = latency;
+				}
+				_requests++;
+				_queue_wait += std::chrono::duration<double, std::milli>(begin - batch[b]->arrival).count();
+				batch[b]->done = true;
+			}
+			_fill[batch.size()]++;
+			_run += std::chrono::duration<double, std::milli>(end - begin).count();
+		}
+		_done.notify_all();
+	}
+
+	void InferenceServer::printStats(std::ostream &os) const{
+		std::lock_guard<std::mutex> lock(_mutex);
+		std::vector<double> sorted(_latency);
+		std::sort(sorted.begin(), sorted.end());
+		size_t batches = 0;
+		for(size_t n = 0; n < _fill.size(); n++)
+		{
+			batches += _fill[n];
+		}
+		const size_t requests = _requests;
+		const size_t capacity = _fill.size() - 1;
+
+		os << std::fixed << std::setprecision(3);
+		os << requests << " requests in " << batches << " batches of up to " << capacity << ", max wait " << _max_wait << " ms" << std::endl;
+		if(requests == 0)
+		{
+			return;
+		}
+		os << "latency ms of the last " << sorted.size() << " requests  p50 " << percentile(sorted, 0.5) << "  p90 " << percentile(sorted, 0.9) << "  p99 " << percentile(sorted, 0.99)
+		   << "  max " << sorted.back() << std::endl;
+		os << "queue wait " << _queue_wait / requests << " ms/request, network " << _run / batches << " ms/batch" << std::endl;
+		os << "batch fill " << 100.0 * requests / (batches * capacity) << "%, images per batch:";
+		for(size_t n = 1; n < _fill.size(); n++)
+		{
+			if(_fill[n] > 0)
+			{
+				os << " " << n << "x" << _fill[n];
+			}
+		}
+		os << std::endl;
+	}
+
+ }
@@ -0,0 +1,88 @@
+#ifndef OPINFERENCESERVER
+#define OPINFERENCESERVER
+
+#include "network.h"
+#include "serverProtocol.h"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace opGraph{
+
+	//Long-lived inference on a Unix socket, see serverProtocol.h for the messages
+	//One thread per connection reads the images, a single batcher coalesces them into the batch the network was built with:
+	//a batch runs as soon as it is full or the oldest image in it waited max_wait_ms. Slots a partial batch does not use
+	//keep the previous images, their scores are never sent
+	class InferenceServer{
+	public:
+		InferenceServer(Network &network, const std::string &socket_path, double max_wait_ms);
+		~InferenceServer();
+		InferenceServer(const InferenceServer &) = delete;
+		InferenceServer &operator=(const InferenceServer &) = delete;
+
+		//Accept connections until stop(), then finish the batch in flight and close every connection
+		void serve();
+		//Only stores a flag, safe to call from a signal handler
+		void stop() { _stop_requested.store(true); }
+
+		//Request latency percentiles (arrival of the image to its scores being ready), queueing and batch fill
+		void printStats(std::ostream &os) const;
+
+	private:
+		typedef std::chrono::steady_clock Clock;
+
+		struct Request{
+			std::vector<float> image;
+			std::vector<float> scores;
+			Clock::time_point arrival;
+			bool taken;		//in a batch, the batcher writes the scores even when the server stops
+			bool done;
+
+			Request()
+				: image(), scores(), arrival(), taken(false), done(false)
+			{
+			}
+		};
+
+		void batcher();
+		void connection(int fd);
+		//Join the connection threads that returned and close their sockets
+		void reap();
+		void runBatch(const std::vector<Request *> &batch);
+
+		Network &_network;
+		std::string _socket_path;
+		double _max_wait;
+		size_t _image_size;		//F32 values of one image
+		size_t _classes;
+		int _listen;
+		std::atomic<bool> _stop_requested;
+
+		mutable std::mutex _mutex;
+		std::condition_variable _arrived;
+		std::condition_variable _done;
+		std::deque<Request *> _queue;
+		bool _stop;
+		std::vector<std::thread> _connections;
+		std::vector<int> _fds;
+		std::vector<int> _finished;		//sockets of the connections that returned, not reaped yet
+
+		//Statistics, guarded by _mutex
+		std::vector<double> _latency;	//ring of the latest requests, the percentiles are over it
+		size_t _requests;
+		std::vector<size_t> _fill;		//number of batches run with each number of images
+		double _queue_wait;
+		double _run;
+	};
+
+ }
+
+
+#endif
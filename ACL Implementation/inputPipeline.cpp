@@ -0,0 +1,150 @@
+#include "inputPipeline.h"
+#include "dataLoader.h"
+#include "memoryPlanner.h"
+#include "arm_compute/core/Error.h"
+
+#include <algorithm>
+#include <chrono>
+#include <dirent.h>
+#include <iostream>
+
+namespace opGraph{
+
+	typedef std::chrono::steady_clock Clock;
+
+	static double elapsed(const Clock::time_point &begin){
+		return std::chrono::duration<double, std::milli>(Clock::now() - begin).count();
+	}
+
+	InputPipeline::InputPipeline(const std::vector<std::string> &frames, const TensorInfo &info, size_t depth, int repeat)
+		: _frames(frames), _repeat(repeat), _slots(), _mutex(), _filled(), _freed(), _ready(0), _free(depth), _read(0),
+		  _holding(false), _finished(false), _stop(false), _consumed(0), _stall(0), _decoder_wait(0), _decode(0), _thread()
+	{
+		if(depth < 1)
+		{
+			ARM_COMPUTE_ERROR("The ring needs at least one slot");
+		}
+		for(size_t i = 0; i < depth; i++)
+		{
+			//Same strides and padding as the network input, so a slot can stand in for it
+			_slots.emplace_back(new Tensor());
+			_slots.back()->allocator()->init(info);
+			_slots.back()->allocator()->allocate();
+		}
+		_thread = std::thread(&InputPipeline::decode, this);
+	}
+
+	InputPipeline::~InputPipeline(){
+		{
+			std::lock_guard<std::mutex> lock(_mutex);
+			_stop = true;
+		}
+		_freed.notify_all();
+		_thread.join();
+	}
+
+	void InputPipeline::decode(){
+		size_t write = 0;
+		try
+		{
+			for(int r = 0; r < _repeat; r++)
+			{
+				for(size_t f = 0; f < _frames.size(); f++)
+				{
+					{
+						std::unique_lock<std::mutex> lock(_mutex);
+						const Clock::time_point begin = Clock::now();
+						_freed.wait(lock, [this] { return _free > 0 || _stop; });
+						_decoder_wait += elapsed(begin);
+						if(_stop)
+						{
+							return;
+						}
+						_free--;
+					}
+
+					//The slot is ours until it is handed out, decode without the lock
+					const Clock::time_point begin = Clock::now();
+					utils::pmLoader ppm;
+					ppm.open(_frames[f]);
+					if(!ppm.is_open())
+					{
+						ARM_COMPUTE_ERROR("Cannot open frame %s", _frames[f].c_str());
+					}
+					ppm.fill_image(*_slots[write]);
+					ppm.close();
+
+					{
+						std::lock_guard<std::mutex> lock(_mutex);
+						_decode += elapsed(begin);
+						_ready++;
+					}
+					_filled.notify_one();
+					write = (write + 1) % _slots.size();
+				}
+			}
+		}
+		catch(const std::exception &e)
+		{
+			//A bad frame ends the stream instead of terminating the process from this thread
+			std::cerr << "Input pipeline stopped: " << e.what() << std::endl;
+		}
+		{
+			std::lock_guard<std::mutex> lock(_mutex);
+			_finished = true;
+		}
+		_filled.notify_all();
+	}
+
+	bool InputPipeline::next(Tensor * input){
+		std::unique_lock<std::mutex> lock(_mutex);
+		if(_holding)
+		{
+			_holding = false;
+			_free++;
+			_freed.notify_one();
+		}
+
+		const Clock::time_point begin = Clock::now();
+		_filled.wait(lock, [this] { return _ready > 0 || _finished; });
+		_stall += elapsed(begin);
+		if(_ready == 0)
+		{
+			return false;
+		}
+
+		Tensor * slot = _slots[_read].get();
+		_ready--;
+		_read = (_read + 1) % _slots.size();
+		_holding = true;
+		_consumed++;
+		lock.unlock();
+
+		//The kernels read the input through buffer() on every run, swapping the region is enough
+		opWrapper::importMemory(input, slot->buffer());
+		return true;
+	}
+
+	std::vector<std::string> InputPipeline::listFrames(const std::string &path){
+		std::vector<std::string> frames;
+		DIR * dir = opendir(path.c_str());
+		if(dir == nullptr)
+		{
+			frames.push_back(path);
+			return frames;
+		}
+		const std::string prefix = path[path.size() - 1] == '/' ? path : path + "/";
+		for(struct dirent * entry = readdir(dir); entry != nullptr; entry = readdir(dir))
+		{
+			const std::string name = entry->d_name;
+			if(name.size() > 4 && name.compare(name.size() - 4, 4, ".ppm") == 0)
+			{
+				frames.push_back(prefix + name);
+			}
+		}
+		closedir(dir);
+		std::sort(frames.begin(), frames.end());
+		return frames;
+	}
+
+ }
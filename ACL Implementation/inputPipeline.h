@@ -0,0 +1,65 @@
+#ifndef OPINPUTPIPELINE
+#define OPINPUTPIPELINE
+
+#include "arm_compute/runtime/Tensor.h"
+
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace arm_compute;
+
+namespace opGraph{
+
+	//Decodes a stream of PPM frames on a background thread into a ring of preallocated tensors
+	//The consumer swaps each decoded slot into the network input with import_memory, no copy is made
+	class InputPipeline{
+	public:
+		//info is the network input as configured (with its padding), depth is the number of slots in the ring
+		InputPipeline(const std::vector<std::string> &frames, const TensorInfo &info, size_t depth = 2, int repeat = 1);
+		~InputPipeline();
+		InputPipeline(const InputPipeline &) = delete;
+		InputPipeline &operator=(const InputPipeline &) = delete;
+
+		//Point input at the next decoded frame, blocks while the decoder is behind
+		//Returns false at the end of the stream, the previous frame is released first
+		bool next(Tensor * input);
+
+		size_t frames() const { return _consumed; }
+		//Time next() spent waiting for the decoder and time the decoder spent waiting for a free slot, in ms
+		double stallTime() const { return _stall; }
+		double decoderWaitTime() const { return _decoder_wait; }
+		double decodeTime() const { return _decode; }
+
+		//Every .ppm of a directory in name order, or the file itself
+		static std::vector<std::string> listFrames(const std::string &path);
+
+	private:
+		void decode();
+
+		std::vector<std::string> _frames;
+		int _repeat;
+		std::vector<std::unique_ptr<Tensor>> _slots;
+		std::mutex _mutex;
+		std::condition_variable _filled;
+		std::condition_variable _freed;
+		size_t _ready;			//decoded slots not handed out yet
+		size_t _free;			//slots the decoder may write
+		size_t _read;			//next slot handed to the consumer
+		bool _holding;			//the consumer still uses the slot before _read
+		bool _finished;
+		bool _stop;
+		size_t _consumed;
+		double _stall;
+		double _decoder_wait;
+		double _decode;
+		std::thread _thread;
+	};
+
+ }
+
+
+#endif
@@ -0,0 +1,140 @@
+#include "serverProtocol.h"
+#include <chrono>
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <sys/un.h>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+//Closed-loop load for run_server: every client keeps one request in flight, waiting think ms between them
+//More clients than the server batch fill its batches, fewer show the cost of the max wait deadline
+
+static int connectTo(const string &socket_path){
+	sockaddr_un address;
+	memset(&address, 0, sizeof(address));
+	address.sun_family = AF_UNIX;
+	strncpy(address.sun_path, socket_path.c_str(), sizeof(address.sun_path) - 1);
+	const int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+	if(fd >= 0 && connect(fd, reinterpret_cast<sockaddr *>(&address), sizeof(address)) != 0)
+	{
+		close(fd);
+		return -1;
+	}
+	return fd;
+}
+
+//Reply to a request without payload, the payload is returned in reply
+static bool query(int fd, opGraph::MessageType type, vector<char> &reply){
+	opGraph::ServerHeader header;
+	if(!opGraph::sendMessage(fd, type, 0, nullptr, 0) || !opGraph::receiveHeader(fd, header) || header.status != 0)
+	{
+		return false;
+	}
+	reply.resize(header.size);
+	return header.size == 0 || opGraph::readAll(fd, reply.data(), header.size);
+}
+
+int main (int argc, char **argv)
+{
+	if(argc > 5)
+	{
+		std::cout<<"Usage: ./load_client [socket(/tmp/opgraph.sock)] [clients(8)] [requests per client(50)] [think ms(0)]"<<std::endl;
+		return 0;
+	}
+	const string socket_path = argc > 1 ? argv[1] : "/tmp/opgraph.sock";
+	const int clients = std::max(argc > 2 ? atoi(argv[2]) : 8, 1);
+	const int requests = std::max(argc > 3 ? atoi(argv[3]) : 50, 1);
+	const int think = argc > 4 ? atoi(argv[4]) : 0;
+
+	const int control = connectTo(socket_path);
+	vector<char> reply;
+	if(control < 0 || !query(control, opGraph::MessageType::Info, reply) || reply.size() != sizeof(opGraph::ServerInfo))
+	{
+		std::cout << "No server on " << socket_path << std::endl;
+		return 1;
+	}
+	opGraph::ServerInfo info;
+	memcpy(&info, reply.data(), sizeof(info));
+	std::cout << "Server input " << info.width << "x" << info.height << "x" << info.channels << ", " << info.classes
+			  << " classes, batches of up to " << info.max_batch << std::endl;
+
+	//Every client sends a different constant image, the contents do not change the cost
+	const size_t image_size = static_cast<size_t>(info.width) * info.height * info.channels;
+	mutex lock;
+	vector<double> latency;
+	int failures = 0;			//clients that stopped on an error
+	int failed_requests = 0;	//the request that failed and those the client could not send after it
+	auto beginTime = std::chrono::steady_clock::now();
+	vector<thread> threads;
+	for(int c = 0; c < clients; c++)
+	{
+		threads.emplace_back([&, c]()
+		{
+			const vector<float> image(image_size, static_cast<float>(c) / clients);
+			vector<float> scores(info.classes);
+			vector<double> own;
+			const int fd = connectTo(socket_path);
+			bool ok = fd >= 0;
+			for(int r = 0; ok && r < requests; r++)
+			{
+				auto sent = std::chrono::steady_clock::now();
+				opGraph::ServerHeader header;
+				ok = opGraph::sendMessage(fd, opGraph::MessageType::Infer, 0, image.data(), image.size() * sizeof(float))
+					 && opGraph::receiveHeader(fd, header) && header.status == 0 && header.size == scores.size() * sizeof(float)
+					 && opGraph::readAll(fd, scores.data(), header.size);
+				//A failed request returns early, its time would skew the percentiles
+				if(ok)
+				{
+					own.push_back(std::chrono::duration<double,std::milli>(std::chrono::steady_clock::now() - sent).count());
+				}
+				if(think > 0)
+				{
+					std::this_thread::sleep_for(std::chrono::milliseconds(think));
+				}
+			}
+			if(fd >= 0)
+			{
+				close(fd);
+			}
+			std::lock_guard<mutex> guard(lock);
+			latency.insert(latency.end(), own.begin(), own.end());
+			failures += ok ? 0 : 1;
+			failed_requests += requests - static_cast<int>(own.size());
+		});
+	}
+	for(size_t t = 0; t < threads.size(); t++)
+	{
+		threads[t].join();
+	}
+	const double elapsed = std::chrono::duration<double,std::milli>(std::chrono::steady_clock::now() - beginTime).count();
+
+	std::sort(latency.begin(), latency.end());
+	std::cout << std::fixed << std::setprecision(3);
+	std::cout << latency.size() << " requests from " << clients << " clients in " << elapsed << " ms, "
+			  << latency.size() * 1000.0 / elapsed << " images/s";
+	if(failures > 0)
+	{
+		std::cout << ", " << failed_requests << " requests failed on " << failures << " clients";
+	}
+	std::cout << std::endl;
+	if(!latency.empty())
+	{
+		std::cout << "client latency ms  p50 " << latency[latency.size() / 2] << "  p90 " << latency[latency.size() * 9 / 10]
+				  << "  p99 " << latency[latency.size() * 99 / 100] << "  max " << latency.back() << std::endl;
+	}
+
+	if(query(control, opGraph::MessageType::Stats, reply))
+	{
+		std::cout << "Server:" << std::endl << string(reply.begin(), reply.end());
+	}
+	close(control);
+	return failures == 0 ? 0 : 1;
+}
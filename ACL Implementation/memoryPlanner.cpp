@@ -0,0 +1,256 @@
+#include "memoryPlanner.h"
+#include "arm_compute/core/Error.h"
+
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <unistd.h>
+
+namespace opWrapper{
+
+	static MemoryPlanner * g_planner = nullptr;
+	static std::shared_ptr<IMemoryManager> g_memory_manager = nullptr;
+	static std::vector<std::unique_ptr<Tensor>> * g_parameter_owner = nullptr;
+
+	static size_t alignUp(size_t value, size_t alignment){
+		return (value + alignment - 1) / alignment * alignment;
+	}
+
+	size_t assignOffsets(std::vector<Lifetime> &lifetimes, size_t alignment){
+		std::vector<size_t> order(lifetimes.size());
+		for(size_t i = 0; i < order.size(); i++)
+		{
+			order[i] = i;
+		}
+		std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b)
+		{
+			return lifetimes[a].size > lifetimes[b].size;
+		});
+
+		size_t arena = 0;
+		std::vector<size_t> placed;
+		for(size_t i = 0; i < order.size(); i++)
+		{
+			Lifetime &cur = lifetimes[order[i]];
+			const size_t size = alignUp(cur.size, alignment);
+
+			//Tensors already placed whose lifetime overlaps the current one, sorted by offset
+			std::vector<size_t> live;
+			for(size_t p = 0; p < placed.size(); p++)
+			{
+				const Lifetime &other = lifetimes[placed[p]];
+				if(other.first <= cur.last && cur.first <= other.last)
+				{
+					live.push_back(placed[p]);
+				}
+			}
+			std::sort(live.begin(), live.end(), [&](size_t a, size_t b)
+			{
+				return lifetimes[a].offset < lifetimes[b].offset;
+			});
+
+			//Smallest gap that fits, otherwise after the last live tensor
+			size_t best = static_cast<size_t>(-1);
+			size_t best_gap = static_cast<size_t>(-1);
+			size_t prev_end = 0;
+			for(size_t l = 0; l < live.size(); l++)
+			{
+				const Lifetime &other = lifetimes[live[l]];
+				if(other.offset > prev_end)
+				{
+					const size_t gap = other.offset - prev_end;
+					if(gap >= size && gap < best_gap)
+					{
+						best = prev_end;
+						best_gap = gap;
+					}
+				}
+				prev_end = std::max(prev_end, other.offset + alignUp(other.size, alignment));
+			}
+			cur.offset = best != static_cast<size_t>(-1) ? best : prev_end;
+			arena = std::max(arena, cur.offset + size);
+			placed.push_back(order[i]);
+		}
+		return arena;
+	}
+
+	MemoryPlanner::MemoryPlanner()
+		: _tensors(), _lifetimes(), _index(), _views(), _parent(), _arena(), _arena_size(0)
+	{
+	}
+
+	void MemoryPlanner::manage(Tensor * tensor){
+		if(isManaged(tensor) || isView(tensor))
+		{
+			return;
+		}
+		_index[tensor] = _tensors.size();
+		_tensors.push_back(tensor);
+		_lifetimes.push_back(Lifetime());
+	}
+
+	bool MemoryPlanner::isManaged(Tensor * tensor) const{
+		return _index.find(tensor) != _index.end();
+	}
+
+	void MemoryPlanner::view(Tensor * view, Tensor * parent, unsigned int first){
+		if(isView(parent) || isManaged(view))
+		{
+			ARM_COMPUTE_ERROR("A view must be declared before it is managed and cannot be the parent of another view");
+		}
+		_views.push_back(View{ view, parent, first });
+		_parent[view] = parent;
+	}
+
+	bool MemoryPlanner::isView(ITensor * tensor) const{
+		return _parent.find(tensor) != _parent.end();
+	}
+
+	void MemoryPlanner::use(ITensor * tensor, int step){
+		std::map<ITensor *, Tensor *>::const_iterator parent = _parent.find(tensor);
+		if(parent != _parent.end())
+		{
+			tensor = parent->second;
+		}
+		std::map<ITensor *, size_t>::const_iterator it = _index.find(tensor);
+		if(it == _index.end())
+		{
+			//Weights and tensors allocated outside the planner
+			return;
+		}
+		Lifetime &lifetime = _lifetimes[it->second];
+		lifetime.first = lifetime.first < 0 ? step : std::min(lifetime.first, step);
+		lifetime.last = std::max(lifetime.last, step);
+	}
+
+	void MemoryPlanner::allocate(){
+		//NEON kernels read whole vectors, keep every tensor on a cache line boundary
+		const size_t alignment = 64;
+		for(size_t v = 0; v < _views.size(); v++)
+		{
+			if(!isManaged(_views[v].parent))
+			{
+				ARM_COMPUTE_ERROR("The parent of a view is not planned");
+			}
+			_views[v].parent->info()->extend_padding(_views[v].tensor->info()->padding());
+		}
+		for(size_t i = 0; i < _tensors.size(); i++)
+		{
+			if(_lifetimes[i].first < 0)
+			{
+				ARM_COMPUTE_ERROR("Managed tensor is never used by a layer");
+			}
+			_lifetimes[i].size = _tensors[i]->info()->total_size();
+		}
+		_arena_size = assignOffsets(_lifetimes, alignment);
+
+		_arena.resize(_arena_size + alignment);
+		uint8_t * base = _arena.data();
+		base += (alignment - reinterpret_cast<uintptr_t>(base) % alignment) % alignment;
+		for(size_t i = 0; i < _tensors.size(); i++)
+		{
+			importMemory(_tensors[i], base + _lifetimes[i].offset);
+		}
+		//Every row of a view is a row of its parent, the padding of the parent is final now
+		for(size_t v = 0; v < _views.size(); v++)
+		{
+			const ITensorInfo * parent = _views[v].parent->info();
+			TensorInfo &info = _views[v].tensor->allocator()->info();
+			const size_t offset = parent->offset_first_element_in_bytes() + _views[v].first * parent->strides_in_bytes()[2];
+			info.init(info.tensor_shape(), 1, info.data_type(), parent->strides_in_bytes(), offset, parent->total_size());
+			importMemory(_views[v].tensor, _views[v].parent->buffer());
+		}
+	}
+
+	size_t MemoryPlanner::viewBytes() const{
+		size_t total = 0;
+		for(size_t v = 0; v < _views.size(); v++)
+		{
+			const ITensorInfo * info = _views[v].tensor->info();
+			total += info->tensor_shape().total_size() * info->element_size();
+		}
+		return total;
+	}
+
+	size_t MemoryPlanner::unplannedBytes() const{
+		size_t total = 0;
+		for(size_t i = 0; i < _tensors.size(); i++)
+		{
+			total += _tensors[i]->info()->total_size();
+		}
+		return total;
+	}
+
+	void MemoryPlanner::print(std::ostream &os) const{
+		os << std::fixed << std::setprecision(2);
+		os << "Activation memory: " << _tensors.size() << " tensors, "
+		   << unplannedBytes() / 1048576.0 << " MB allocated separately, "
+		   << _arena_size / 1048576.0 << " MB planned";
+		if(!_views.empty())
+		{
+			os << ", " << _views.size() << " channel views (" << viewBytes() / 1048576.0 << " MB) inside their parents";
+		}
+		os << std::endl;
+	}
+
+	void allocateOutput(Tensor * tensor){
+		if(g_planner != nullptr)
+		{
+			g_planner->manage(tensor);
+		}
+		else
+		{
+			tensor->allocator()->allocate();
+		}
+	}
+
+	void importMemory(Tensor * tensor, void * memory){
+		const Status status = tensor->allocator()->import_memory(memory);
+		if(status.error_code() != ErrorCode::OK)
+		{
+			ARM_COMPUTE_ERROR("Cannot import memory into a tensor: %s", status.error_description().c_str());
+		}
+	}
+
+	void setMemoryPlanner(MemoryPlanner * planner){
+		g_planner = planner;
+	}
+
+	MemoryPlanner * memoryPlanner(){
+		return g_planner;
+	}
+
+	void setMemoryManager(std::shared_ptr<IMemoryManager> memory_manager){
+		g_memory_manager = memory_manager;
+	}
+
+	std::shared_ptr<IMemoryManager> memoryManager(){
+		return g_memory_manager;
+	}
+
+	Tensor * newParameter(){
+		Tensor * tensor = new Tensor();
+		if(g_parameter_owner != nullptr)
+		{
+			g_parameter_owner->emplace_back(tensor);
+		}
+		return tensor;
+	}
+
+	void setParameterOwner(std::vector<std::unique_ptr<Tensor>> * owner){
+		g_parameter_owner = owner;
+	}
+
+	size_t residentSetBytes(){
+		//Second field, in pages
+		std::ifstream statm("/proc/self/statm");
+		size_t total = 0;
+		size_t resident = 0;
+		if(!(statm >> total >> resident))
+		{
+			return 0;
+		}
+		return resident * static_cast<size_t>(sysconf(_SC_PAGESIZE));
+	}
+
+ }
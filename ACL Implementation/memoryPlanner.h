@@ -0,0 +1,100 @@
+#ifndef OPMEMORYPLANNER
+#define OPMEMORYPLANNER
+
+#include "arm_compute/runtime/Tensor.h"
+#include "arm_compute/runtime/IMemoryManager.h"
+
+#include <map>
+#include <memory>
+#include <ostream>
+#include <vector>
+
+using namespace arm_compute;
+
+namespace opWrapper{
+
+	//Live range of one activation, in layer positions (first and last are inclusive)
+	struct Lifetime{
+		size_t size;
+		int first;
+		int last;
+		size_t offset;
+
+		Lifetime()
+			: size(0), first(-1), last(-1), offset(0)
+		{
+		}
+	};
+
+	//Greedy-by-size placement: biggest tensors first, each one goes into the lowest gap that is free for its whole lifetime
+	//Returns the size of the arena needed to hold every lifetime
+	size_t assignOffsets(std::vector<Lifetime> &lifetimes, size_t alignment);
+
+	//Collects the activations of a network, computes their lifetimes from the layer order
+	//and backs all of them with one arena so that tensors which are never alive together share memory
+	class MemoryPlanner{
+	public:
+		MemoryPlanner();
+		MemoryPlanner(const MemoryPlanner &) = delete;
+		MemoryPlanner &operator=(const MemoryPlanner &) = delete;
+
+		//Called instead of allocate() while the planner is active, views are skipped
+		void manage(Tensor * tensor);
+		bool isManaged(Tensor * tensor) const;
+		//view holds the NCHW channels first, first + 1, ... of parent, which must be managed, and gets no memory of its own
+		//Declared before the layers writing the view are configured, its uses count as uses of the parent
+		void view(Tensor * view, Tensor * parent, unsigned int first);
+		bool isView(ITensor * tensor) const;
+		//The tensor is read or written by the layer at position step
+		void use(ITensor * tensor, int step);
+		//Assign offsets and import the arena into every managed tensor, must run after all layers are configured
+		//The padding the kernels asked of a view goes to its parent first, then the view takes the strides of the parent
+		void allocate();
+
+		//Sum of all the managed activations, i.e. what the factories allocated on their own
+		size_t unplannedBytes() const;
+		size_t plannedBytes() const { return _arena_size; }
+		size_t numTensors() const { return _tensors.size(); }
+		//What the views would take as tensors of their own
+		size_t viewBytes() const;
+		size_t numViews() const { return _views.size(); }
+		void print(std::ostream &os) const;
+
+	private:
+		struct View{
+			Tensor * tensor;
+			Tensor * parent;
+			unsigned int first;
+		};
+
+		std::vector<Tensor *> _tensors;
+		std::vector<Lifetime> _lifetimes;
+		std::map<ITensor *, size_t> _index;
+		std::vector<View> _views;
+		std::map<ITensor *, Tensor *> _parent;	//of every view
+		std::vector<uint8_t> _arena;
+		size_t _arena_size;
+	};
+
+	//All the opWrapper factories call this on their output instead of allocator()->allocate()
+	void allocateOutput(Tensor * tensor);
+	//allocator()->import_memory() that fails on a bad Status in every build, ARM_COMPUTE_ERROR_THROW_ON is only in debug ones
+	void importMemory(Tensor * tensor, void * memory);
+	//Route output allocation through a planner, nullptr restores immediate allocation
+	void setMemoryPlanner(MemoryPlanner * planner);
+	MemoryPlanner * memoryPlanner();
+	//Memory manager handed to the functions that keep internal workspaces (im2col, reshaped GEMM input)
+	void setMemoryManager(std::shared_ptr<IMemoryManager> memory_manager);
+	std::shared_ptr<IMemoryManager> memoryManager();
+	
+	//Weights, biases and BN statistics the factories create, handed to the owner while one is set
+	//so that the Network can release the ones its functions no longer read after prepare()
+	Tensor * newParameter();
+	void setParameterOwner(std::vector<std::unique_ptr<Tensor>> * owner);
+	//Resident set of this process from /proc/self/statm, 0 when it cannot be read
+	size_t residentSetBytes();
+
+ }
+
+
+#endif
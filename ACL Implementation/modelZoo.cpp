@@ -0,0 +1,264 @@
+#include "modelZoo.h"
+#include "arm_compute/core/Error.h"
+
+namespace opGraph{
+
+	ResNetSpec resnetSpec(const std::string &name){
+		ResNetSpec spec;
+		spec.layers = std::vector<int>{ 3, 4, 6, 3 };
+
+		if(name == "resnet50")
+		{
+		}
+		else if(name == "resnet50_justaddgroup")
+		{
+			spec.groups = 4;
+			spec.decoupled = true;
+		}
+		else if(name == "resnet50_s3_addchannel")
+		{
+			spec.width = 96;
+			spec.groups = 4;
+			spec.shuffle = true;
+			spec.decoupled = true;
+		}
+		else if(name == "resnet50_s3_addchannel175")
+		{
+			spec.width = 112;
+			spec.groups = 4;
+			spec.shuffle = true;
+			spec.decoupled = true;
+		}
+		else if(name == "resnet34_s3_x15")
+		{
+			spec.bottleneck = false;
+			spec.width = 96;
+			spec.groups = 4;
+			spec.shuffle = true;
+			spec.decoupled = true;
+		}
+		else if(name == "resnet34_s3_x175")
+		{
+			spec.bottleneck = false;
+			spec.width = 112;
+			spec.groups = 4;
+			spec.shuffle = true;
+			spec.decoupled = true;
+		}
+		else
+		{
+			ARM_COMPUTE_ERROR("Unknown ResNet model %s", name.c_str());
+		}
+		return spec;
+	}
+
+	ShuffleNetSpec shufflenetSpec(const std::string &name){
+		//shufflenetv1[_shuffle3]_g<group>_<size>
+		ShuffleNetSpec spec;
+
+		std::string rest = name.substr(std::string("shufflenetv1_").size());
+		if(rest.compare(0, 9, "shuffle3_") == 0)
+		{
+			spec.shuffle_every_block = false;
+			rest = rest.substr(9);
+		}
+		const size_t sep = rest.find('_');
+		if(rest.empty() || rest[0] != 'g' || sep == std::string::npos || sep < 2
+		   || rest.find_first_not_of("0123456789", 1) != sep || sep + 1 == rest.size())
+		{
+			ARM_COMPUTE_ERROR("Malformed ShuffleNetV1 name %s", name.c_str());
+		}
+		spec.group = std::stoi(rest.substr(1, sep - 1));
+		spec.model_size = rest.substr(sep + 1);
+		return spec;
+	}
+
+	//One ResNet block on a single branch, the channel counts are already divided by the groups of the branch
+	static int resnetBlock(Graph &graph, int x, const std::string &name, const ResNetSpec &spec,
+						   int inplanes, int planes, int stride, int groups){
+		int out = 0;
+		if(spec.bottleneck)
+		{
+			out = graph.conv(x, name + "_conv0", planes, 1, 1, 0, groups);
+			out = graph.bn(out, name + "_bn0", true);
+			out = graph.conv(out, name + "_conv1", planes, 3, stride, 1, groups);
+			out = graph.bn(out, name + "_bn1", true);
+			out = graph.conv(out, name + "_conv2", planes * 4, 1, 1, 0, groups);
+			out = graph.bn(out, name + "_bn2");
+		}
+		else
+		{
+			out = graph.conv(x, name + "_conv0", planes, 3, stride, 1, groups);
+			out = graph.bn(out, name + "_bn0", true);
+			out = graph.conv(out, name + "_conv1", planes, 3, 1, 1, groups);
+			out = graph.bn(out, name + "_bn1");
+		}
+
+		const int expansion = spec.bottleneck ? 4 : 1;
+		int residual = x;
+		if(stride != 1 || inplanes != planes * expansion)
+		{
+			residual = graph.conv(x, name + "_residual_conv", planes * expansion, 1, stride, 0, groups);
+			residual = graph.bn(residual, name + "_residual_bn");
+		}
+		return graph.add(out, residual, name + "_add", true);
+	}
+
+	void buildResNet(Graph &graph, const ResNetSpec &spec){
+		const int expansion = spec.bottleneck ? 4 : 1;
+		const bool decoupled = spec.decoupled && spec.groups > 1;
+		//A decoupled branch holds 1/groups of the channels and runs dense convolutions
+		const int branches = decoupled ? spec.groups : 1;
+		const int conv_groups = decoupled ? 1 : spec.groups;
+
+		int x = graph.input("input", 224, 224, 3);
+		x = graph.conv(x, "conv1", spec.width, 7, 2, 3);
+		x = graph.bn(x, "bn1", true);
+		x = graph.maxpool(x, "pool1", 3, 2, 1);
+
+		std::vector<int> branch(1, x);
+		int inplanes = spec.width;
+		for(size_t s = 0; s < spec.layers.size(); s++)
+		{
+			const std::string layer = "layer" + std::to_string(s);
+			const int planes = spec.width << s;
+			const int stride = s == 0 ? 1 : 2;
+
+			if(decoupled && branch.size() == 1)
+			{
+				branch = graph.split(branch[0], layer + "_split", branches);
+			}
+			for(int g = 0; g < branches; g++)
+			{
+				const std::string suffix = decoupled ? "_g" + std::to_string(g) : "";
+				graph.setGroup(decoupled ? g : -1);
+				int in = inplanes;
+				for(int b = 0; b < spec.layers[s]; b++)
+				{
+					const std::string name = layer + "_block" + std::to_string(b);
+					branch[g] = resnetBlock(graph, branch[g], name + suffix, spec, in / branches, planes / branches,
+											b == 0 ? stride : 1, conv_groups);
+					in = planes * expansion;
+				}
+			}
+			graph.setGroup(-1);
+			inplanes = planes * expansion;
+
+			const bool last = s + 1 == spec.layers.size();
+			if(decoupled && (spec.shuffle || last))
+			{
+				branch = std::vector<int>(1, graph.concat(branch, layer + "_concat"));
+			}
+			if(spec.shuffle && !last)
+			{
+				branch[0] = graph.shuffle(branch[0], layer + "_shuffle", spec.groups);
+			}
+		}
+
+		x = graph.avgpool(branch[0], "pool2", 7, 1, 0);
+		x = graph.fc(x, "fc1", spec.num_classes);
+		graph.setOutput(x);
+	}
+
+	static std::vector<int> shufflenetChannels(int group, const std::string &model_size){
+		static const char * sizes[] = { "0.5x", "1.0x", "1.5x", "2.0x" };
+		static const int g3[4][4] = { { 12, 120, 240, 480 }, { 24, 240, 480, 960 }, { 24, 360, 720, 1440 }, { 48, 480, 960, 1920 } };
+		static const int g4[4][4] = { { 16, 136, 272, 544 }, { 24, 272, 544, 1088 }, { 24, 408, 816, 1632 }, { 48, 544, 1088, 2176 } };
+		static const int g8[4][4] = { { 16, 192, 384, 768 }, { 24, 384, 768, 1536 }, { 24, 576, 1152, 2304 }, { 48, 768, 1536, 3072 } };
+
+		int index = -1;
+		for(int i = 0; i < 4; i++)
+		{
+			if(model_size == sizes[i])
+			{
+				index = i;
+			}
+		}
+		if(index < 0 || (group != 3 && group != 4 && group != 8))
+		{
+			ARM_COMPUTE_ERROR("Unsupported ShuffleNetV1 group %d / size %s", group, model_size.c_str());
+		}
+		const int (*table)[4] = group == 3 ? g3 : (group == 4 ? g4 : g8);
+		return std::vector<int>(table[index], table[index] + 4);
+	}
+
+	void buildShuffleNetV1(Graph &graph, const ShuffleNetSpec &spec){
+		static const int stage_repeats[3] = { 4, 8, 4 };
+		const std::vector<int> channels = shufflenetChannels(spec.group, spec.model_size);
+
+		int input_channel = channels[0];
+		int x = graph.input("input", 224, 224, 3);
+		x = graph.conv(x, "first_conv", input_channel, 3, 2, 1);
+		x = graph.bn(x, "first_bn", true);
+		x = graph.maxpool(x, "maxpool", 3, 2, 1);
+
+		for(int s = 0; s < 3; s++)
+		{
+			const int output_channel = channels[s + 1];
+			for(int i = 0; i < stage_repeats[s]; i++)
+			{
+				const std::string name = "stage" + std::to_string(s) + "_block" + std::to_string(i);
+				const int stride = i == 0 ? 2 : 1;
+				const bool first_group = s == 0 && i == 0;
+				const bool shuffle = spec.group > 1 && (spec.shuffle_every_block || i == stage_repeats[s] - 1);
+				const int mid_channels = output_channel / 4;
+				const int outputs = stride == 2 ? output_channel - input_channel : output_channel;
+
+				int out = graph.conv(x, name + "_pw0", mid_channels, 1, 1, 0, first_group ? 1 : spec.group);
+				out = graph.bn(out, name + "_bn0", true);
+				out = graph.dwconv(out, name + "_dw", 3, stride, 1);
+				out = graph.bn(out, name + "_bn1");
+				if(shuffle)
+				{
+					out = graph.shuffle(out, name + "_shuffle", spec.group);
+				}
+				out = graph.conv(out, name + "_pw1", outputs, 1, 1, 0, spec.group);
+
+				if(stride == 1)
+				{
+					out = graph.bn(out, name + "_bn2");
+					x = graph.add(out, x, name + "_add", true);
+				}
+				else
+				{
+					out = graph.bn(out, name + "_bn2", true);
+					const int proj = graph.avgpool(x, name + "_proj", 3, 2, 1);
+					x = graph.concat(std::vector<int>{ proj, out }, name + "_concat");
+				}
+				input_channel = output_channel;
+			}
+		}
+
+		x = graph.reduceMean(x, "globalpool");
+		x = graph.fc(x, "classifier", spec.num_classes);
+		graph.setOutput(x);
+	}
+
+	void buildModel(Graph &graph, const std::string &name){
+		if(name.compare(0, 13, "shufflenetv1_") == 0)
+		{
+			buildShuffleNetV1(graph, shufflenetSpec(name));
+		}
+		else
+		{
+			buildResNet(graph, resnetSpec(name));
+		}
+	}
+
+	std::vector<std::string> modelNames(){
+		std::vector<std::string> names{ "resnet50", "resnet50_justaddgroup", "resnet50_s3_addchannel", "resnet50_s3_addchannel175",
+										"resnet34_s3_x15", "resnet34_s3_x175" };
+		static const char * sizes[] = { "0.5x", "1.0x", "1.5x", "2.0x" };
+		static const int groups[] = { 3, 4, 8 };
+		for(int g = 0; g < 3; g++)
+		{
+			for(int s = 0; s < 4; s++)
+			{
+				names.push_back("shufflenetv1_g" + std::to_string(groups[g]) + "_" + sizes[s]);
+				names.push_back("shufflenetv1_shuffle3_g" + std::to_string(groups[g]) + "_" + sizes[s]);
+			}
+		}
+		return names;
+	}
+
+ }
@@ -0,0 +1,55 @@
+#ifndef OPMODELZOO
+#define OPMODELZOO
+
+#include "graph.h"
+#include <string>
+#include <vector>
+
+namespace opGraph{
+
+	//Compact description of the ResNet family in Models/Models/models
+	struct ResNetSpec{
+		std::vector<int> layers;	//blocks per stage, {3, 4, 6, 3} for ResNet-50
+		bool bottleneck;			//Bottleneck (expansion 4) or BasicBlock
+		int width;					//planes of the first stage, 64 for the torchvision models
+		int groups;					//groups of every conv except the stem, 1 for the dense models
+		bool shuffle;				//channel shuffle between the stages
+		bool decoupled;				//build one branch per group instead of grouped convolutions
+		int num_classes;
+
+		ResNetSpec()
+			: layers(), bottleneck(true), width(64), groups(1), shuffle(false), decoupled(false), num_classes(1000)
+		{
+		}
+	};
+
+	//Compact description of ShuffleNetV1 in Models/ShuffleNetV1
+	struct ShuffleNetSpec{
+		int group;
+		std::string model_size;		//0.5x, 1.0x, 1.5x or 2.0x
+		bool shuffle_every_block;	//ShuffleNetV1_Original, otherwise only the last block of a stage (ShuffleNetV1_Shuffle3)
+		int num_classes;
+
+		ShuffleNetSpec()
+			: group(3), model_size("1.0x"), shuffle_every_block(true), num_classes(1000)
+		{
+		}
+	};
+
+	ResNetSpec resnetSpec(const std::string &name);
+	ShuffleNetSpec shufflenetSpec(const std::string &name);
+
+	void buildResNet(Graph &graph, const ResNetSpec &spec);
+	void buildShuffleNetV1(Graph &graph, const ShuffleNetSpec &spec);
+
+	//Build any of the models below from its name
+	//  resnet50, resnet50_justaddgroup, resnet50_s3_addchannel, resnet50_s3_addchannel175,
+	//  resnet34_s3_x15, resnet34_s3_x175, shufflenetv1_g{3,4,8}_{0.5,1.0,1.5,2.0}x,
+	//  shufflenetv1_shuffle3_g{3,4,8}_{0.5,1.0,1.5,2.0}x
+	void buildModel(Graph &graph, const std::string &name);
+	std::vector<std::string> modelNames();
+
+ }
+
+
+#endif
@@ -0,0 +1,136 @@
+#include "network.h"
+#include "modelZoo.h"
+#include <chrono>
+#include <arm_compute/runtime/Scheduler.h>
+
+#include <algorithm>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <string>
+#include <vector>
+
+using namespace arm_compute;
+using namespace std;
+
+//ShuffleNetV1 with groups = 3 and the channel shuffle only in the last block of a stage (Models/ShuffleNetV1/ShuffleNetV1_Shuffle3)
+//at every width, against ResNet-50 with the same threads: median latency, the time of every kind of layer,
+//the planned activations and what the network adds to the resident set once built and run
+
+struct Measure{
+	string model;
+	double ms;
+	double activations_mb;
+	double resident_mb;
+	std::map<string, double> op_ms;	//per layer type, summed over one run
+
+	Measure()
+		: model(), ms(0), activations_mb(0), resident_mb(0), op_ms()
+	{
+	}
+};
+
+static Measure measure(const string &model, int iterations){
+	Measure result;
+	result.model = model;
+	const size_t resident_before = opWrapper::residentSetBytes();
+	opGraph::Graph graph;
+	opGraph::buildModel(graph, model);
+	opGraph::CompileOptions options;
+	opGraph::Network network(graph, options);
+	network.run();
+
+	vector<double> latency;
+	for(int i = 0; i < iterations; i++)
+	{
+		auto beginTime = std::chrono::steady_clock::now();
+		network.run();
+		latency.push_back(std::chrono::duration<double,std::milli>(std::chrono::steady_clock::now() - beginTime).count());
+	}
+	std::sort(latency.begin(), latency.end());
+	result.ms = latency[latency.size() / 2];
+
+	//Layer by layer, as run_resnet walks m_vecFuc
+	const vector<opGraph::Layer> &layers = network.layers();
+	for(int i = 0; i < iterations; i++)
+	{
+		for(size_t l = 0; l < layers.size(); l++)
+		{
+			auto beginTime = std::chrono::steady_clock::now();
+			layers[l].run();
+			result.op_ms[opGraph::opName(layers[l].type)] += std::chrono::duration<double,std::milli>(std::chrono::steady_clock::now() - beginTime).count() / iterations;
+		}
+	}
+
+	result.activations_mb = network.memoryPlanner().plannedBytes() / 1048576.0;
+	const size_t resident_after = opWrapper::residentSetBytes();
+	result.resident_mb = resident_after > resident_before ? (resident_after - resident_before) / 1048576.0 : 0;
+	return result;
+}
+
+int main (int argc, char **argv)
+{
+	if(argc > 5)
+	{
+		std::cout<<"Usage: ./neon_shuffle3 [numberThread(4)] [model_size(all): 0.5x, 1.0x, 1.5x or 2.0x] [numberIteration(20)] [baseline(resnet50)]"<<std::endl;
+		return 0;
+	}
+	const int threads = argc > 1 ? atoi(argv[1]) : 4;
+	const string size = argc > 2 ? argv[2] : "all";
+	const int iterations = std::max(argc > 3 ? atoi(argv[3]) : 20, 1);
+	const string baseline = argc > 4 ? argv[4] : "resnet50";
+	arm_compute::Scheduler::get().set_num_threads(threads);
+
+	vector<string> models;
+	const string sizes[] = { "0.5x", "1.0x", "1.5x", "2.0x" };
+	for(const string &s : sizes)
+	{
+		if(size == "all" || size == s)
+		{
+			models.push_back("shufflenetv1_shuffle3_g3_" + s);
+		}
+	}
+	if(models.empty())
+	{
+		std::cout<<"Unknown model_size "<<size<<std::endl;
+		return 1;
+	}
+	models.push_back(baseline);
+
+	vector<Measure> results;
+	for(size_t i = 0; i < models.size(); i++)
+	{
+		results.push_back(measure(models[i], iterations));
+	}
+	const Measure &base = results.back();
+
+	std::cout << std::fixed << std::setprecision(3);
+	std::cout << threads << " threads, median of " << iterations << " runs" << std::endl;
+	std::cout << "model                          latency ms  images/s  vs " << baseline << "  activations MB  resident MB" << std::endl;
+	for(size_t i = 0; i < results.size(); i++)
+	{
+		const Measure &m = results[i];
+		std::cout << std::left << std::setw(31) << m.model << std::right << std::setw(10) << m.ms << "  " << std::setw(8) << 1000.0 / m.ms << "  "
+				  << std::setw(8) << base.ms / m.ms << "x  " << std::setw(14) << m.activations_mb << "  " << std::setw(11) << m.resident_mb << std::endl;
+	}
+
+	//Where the time goes: ShuffleNet moves it from the dense convolutions to the depthwise layers, the shuffles and the concats
+	std::cout << std::endl << "ms per layer type" << std::endl;
+	std::cout << std::setprecision(2);
+	for(size_t i = 0; i < results.size(); i++)
+	{
+		const Measure &m = results[i];
+		double total = 0;
+		for(const auto &op : m.op_ms)
+		{
+			total += op.second;
+		}
+		std::cout << m.model << ":";
+		for(const auto &op : m.op_ms)
+		{
+			std::cout << " " << op.first << " " << op.second << " (" << std::setprecision(0) << 100 * op.second / total << "%)" << std::setprecision(2);
+		}
+		std::cout << std::endl;
+	}
+	return 0;
+}
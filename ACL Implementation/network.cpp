@@ -0,0 +1,880 @@
+#include "network.h"
+#include "distributed.h"
+#include <arm_compute/runtime/Scheduler.h>
+
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <malloc.h>
+#include <sstream>
+
+namespace opGraph{
+
+	static ActivationLayerInfo activation(bool relu){
+		return relu ? ActivationLayerInfo(ActivationLayerInfo::ActivationFunction::RELU) : ActivationLayerInfo();
+	}
+
+	//Grouped convs on channel views of their input and output. Without the planner the input is allocated already
+	//and its padding can no longer grow under a view, and as in planViews a channel view of a batch is not one on NEON
+	static bool groupedViews(const CompileOptions &options){
+#ifdef OPWRAPPER_AVX2
+		return options.grouped_views && options.plan_memory;
+#else
+		return options.grouped_views && options.plan_memory && options.batch == 1;
+#endif
+	}
+
+	void foldGraph(Graph &graph, const CompileOptions &options){
+		if(options.fold_bn)
+		{
+			const int folded = graph.foldBatchNorm();
+			if(options.verbose)
+			{
+				std::cout << "Folded " << folded << " BN layers into their convolutions" << std::endl;
+			}
+		}
+		if(options.fuse_epilogue && !options.quantize)
+		{
+			//Only the BN that could not go into a convolution are left
+			const int folded = graph.foldBatchNormIntoAdd();
+			if(options.verbose)
+			{
+				std::cout << "Folded " << folded << " BN layers into their residual adds" << std::endl;
+			}
+		}
+		if(options.fold_shuffle)
+		{
+			//A grouped producer interleaves its group views, the split + concat emulation has no such views
+			const int folded = graph.foldChannelShuffle(groupedViews(options));
+			if(options.verbose)
+			{
+				std::cout << "Folded " << folded << " channel shuffles into their convolutions" << std::endl;
+			}
+		}
+	}
+
+	Network::Network(const Graph &graph, const CompileOptions &options)
+		: _graph(graph), _options(options), _bundle(), _tensors(), _input(), _output(), _owned(), _parameters(), _functions(), _layers(),
+		  _in_place(), _planner(), _memory_manager(), _allocator(), _prepared(false), _released(0), _resident_before(0), _resident_after(0)
+	{
+		if(_options.batch < 1)
+		{
+			ARM_COMPUTE_ERROR("The batch needs at least one image");
+		}
+		if(_options.fp16 && _options.quantize)
+		{
+			ARM_COMPUTE_ERROR("fp16 and quantize are exclusive");
+		}
+		if(_options.fp16 && !Scheduler::get().cpu_info().has_fp16())
+		{
+			std::cout << "This core has no FP16 arithmetic, running in F32" << std::endl;
+			_options.fp16 = false;
+		}
+		foldGraph(_graph, _options);
+
+#ifndef OPWRAPPER_SYNTHETIC
+		//The warm cache is only valid for the graph after the passes and the options that change the parameters
+		std::string signature;
+		bool record = false;
+		if(!_options.warm_cache.empty() && _options.quantize)
+		{
+			std::cout << "The warm cache is not used by quantized networks, calibrate already prepares their parameters" << std::endl;
+		}
+		else if(!_options.warm_cache.empty())
+		{
+			std::ostringstream os;
+			_graph.print(os);
+			os << "data_path " << _options.data_path << "\nfp16 " << _options.fp16 << "\n";
+			signature = os.str();
+			if(std::ifstream(_options.warm_cache).good())
+			{
+				_bundle.reset(new opWrapper::WeightBundle(_options.warm_cache));
+				if(!_bundle->prepared() || _bundle->signature() != signature)
+				{
+					std::cout << _options.warm_cache << " was prepared for another graph, rebuilding it" << std::endl;
+					_bundle.reset();
+				}
+			}
+			record = !_bundle;
+		}
+		opWrapper::recordPrepared(record);
+#endif
+		if(!_bundle && !_options.weight_bundle.empty())
+		{
+			_bundle.reset(new opWrapper::WeightBundle(_options.weight_bundle));
+		}
+		opWrapper::setWeightBundle(_bundle.get());
+		opWrapper::setParameterOwner(&_parameters);
+#ifdef OPWRAPPER_AVX2
+		//One convolution kernel, nothing to choose from
+		if(!_options.conv_tuning.empty())
+		{
+			std::cout << "conv_tuning is ignored by the AVX2 backend" << std::endl;
+		}
+#else
+		std::unique_ptr<opWrapper::ConvTuner> tuner;
+		if(!_options.conv_tuning.empty())
+		{
+			//Tuning runs the candidates on scratch tensors while the layers are configured
+			tuner.reset(new opWrapper::ConvTuner(_options.conv_tuning, _options.tune));
+			opWrapper::setConvTuner(tuner.get());
+		}
+#endif
+
+		_tensors.assign(_graph.edges().size(), nullptr);
+		const Edge &in = _graph.edge(_graph.inputEdge());
+		_input = opWrapper::configure4DTensor(in.w, in.h, in.c, _options.batch);
+		_owned.emplace_back(_input);
+		if(edgeType(in.id) != DataType::F32)
+		{
+			//The caller keeps feeding F32, the first layer quantizes or casts it into the input edge
+			_tensors[in.id] = newTensor();
+			_tensors[in.id]->allocator()->init(edgeInfo(in.id));
+		}
+		else
+		{
+			_tensors[in.id] = _input;
+		}
+		for(size_t i = 0; i < _graph.edges().size(); i++)
+		{
+			if(_tensors[i] == nullptr)
+			{
+				_tensors[i] = newTensor();
+			}
+		}
+		_output = edgeType(_graph.outputEdge()) != DataType::F32 ? newTensor() : _tensors[_graph.outputEdge()];
+		if(_options.plan_memory)
+		{
+			//Activations go to the planner, the internal workspaces of the functions to a shared on-demand manager
+			_memory_manager = std::make_shared<MemoryManagerOnDemand>(std::make_shared<BlobLifetimeManager>(), std::make_shared<PoolManager>());
+			opWrapper::setMemoryPlanner(&_planner);
+			opWrapper::setMemoryManager(_memory_manager);
+		}
+		planViews();
+
+		const std::vector<int> order = _graph.schedule();
+		for(size_t i = 0; i < order.size(); i++)
+		{
+			const Node &node = _graph.node(order[i]);
+			if(_options.comm != nullptr && rankOf(node) != _options.comm->rank())
+			{
+				exchange(node);
+				continue;
+			}
+			lower(node);
+			for(size_t o = 0; o < node.outputs.size(); o++)
+			{
+				checkShape(node.outputs[o]);
+				if(node.outputs[o] == _graph.outputEdge() && _tensors[node.outputs[o]] != _output)
+				{
+					Tensor * result = _tensors[node.outputs[o]];
+					_output->allocator()->init(TensorInfo(result->info()->tensor_shape(), 1, DataType::F32));
+					if(_options.quantize)
+					{
+						addLayer(node.name + "_dequantize", node.id, opWrapper::DequantizeOp(result, _output), {result}, {_output});
+						_layers.back().type = OpType::Dequantize;
+					}
+					else
+					{
+						addLayer(node.name + "_to_f32", node.id, opWrapper::CastOp(result, _output), {result}, {_output});
+						_layers.back().type = OpType::Cast;
+					}
+				}
+			}
+			exchange(node);
+		}
+
+		//The input is allocated last so every consumer had the chance to extend its padding
+		input()->allocator()->allocate();
+		opWrapper::setWeightBundle(nullptr);
+		opWrapper::setParameterOwner(nullptr);
+#ifndef OPWRAPPER_AVX2
+		if(tuner)
+		{
+			opWrapper::setConvTuner(nullptr);
+			tuner->save();
+			if(_options.tune || _options.verbose)
+			{
+				tuner->print(std::cout);
+			}
+		}
+#endif
+		if(_options.plan_memory)
+		{
+			opWrapper::setMemoryPlanner(nullptr);
+			opWrapper::setMemoryManager(nullptr);
+			planMemory();
+			if(_options.verbose)
+			{
+				printViews(std::cout);
+			}
+		}
+#ifndef OPWRAPPER_SYNTHETIC
+		if(record)
+		{
+			//Every parameter is loaded and transformed by now, the functions only reshape them on the first run
+			opWrapper::writePreparedBundle(_options.warm_cache, signature);
+			opWrapper::recordPrepared(false);
+			if(_options.verbose)
+			{
+				std::cout << "Wrote the warm cache " << _options.warm_cache << std::endl;
+			}
+		}
+#endif
+		if(_options.prepare)
+		{
+			prepare();
+			if(_options.verbose)
+			{
+				printPrepare(std::cout);
+			}
+		}
+	}
+
+	void Network::prepare(){
+		if(_prepared)
+		{
+			return;
+		}
+		_prepared = true;
+		_resident_before = opWrapper::residentSetBytes();
+		for(size_t i = 0; i < _functions.size(); i++)
+		{
+			_functions[i]->prepare();
+		}
+		//A function marks its original weights unused once it keeps a transformed copy, the rest are read by every run
+		for(size_t i = 0; i < _parameters.size(); i++)
+		{
+			Tensor * parameter = _parameters[i].get();
+			if(parameter->is_used() || parameter->buffer() == nullptr)
+			{
+				continue;
+			}
+			const size_t bytes = parameter->info()->total_size();
+			//Imported from the bundle, the mapped pages go back to the kernel, they are not part of any allocation
+			if(_bundle)
+			{
+				_bundle->release(parameter->buffer(), bytes);
+			}
+			parameter->allocator()->free();
+			_released += bytes;
+		}
+		//The NPY staging buffers and the freed weights are back in the heap, hand the free pages to the kernel
+		malloc_trim(0);
+		_resident_after = opWrapper::residentSetBytes();
+	}
+
+	void Network::printPrepare(std::ostream &os) const{
+		if(!_prepared)
+		{
+			os << "Not prepared, every function reshapes its weights on its first run" << std::endl;
+			return;
+		}
+		const double mb = 1024.0 * 1024.0;
+		os << std::fixed << std::setprecision(1);
+		os << "prepare released " << _released / mb << " MB of original weights, resident set " << _resident_before / mb
+		   << " MB -> " << _resident_after / mb << " MB" << std::endl;
+	}
+
+	void Network::planMemory(){
+		for(size_t i = 0; i < _layers.size(); i++)
+		{
+			for(size_t t = 0; t < _layers[i].inputs.size(); t++)
+			{
+				_planner.use(_layers[i].inputs[t], static_cast<int>(i));
+			}
+			for(size_t t = 0; t < _layers[i].outputs.size(); t++)
+			{
+				_planner.use(_layers[i].outputs[t], static_cast<int>(i));
+			}
+		}
+		//The caller reads the output after run(), it must never be reused
+		_planner.use(output(), static_cast<int>(_layers.size()) - 1);
+		_planner.allocate();
+		_memory_manager->populate(_allocator, std::max(_options.workspace_pools, 1));
+	}
+
+	//Layers that write their output through its strides, a view can be their output
+	static bool writesViews(OpType type){
+		switch(type)
+		{
+			case OpType::Conv:
+			case OpType::DWConv:
+			case OpType::BN:
+			case OpType::Activation:
+			case OpType::MaxPool:
+			case OpType::AvgPool:
+			case OpType::Add:
+			case OpType::ChannelShuffle:
+			case OpType::Split:
+			case OpType::Concat:
+				return true;
+			default:
+				return false;
+		}
+	}
+
+	//The network input is allocated apart from the planner and the caller reads the output without strides,
+	//the FC takes whole images without padding
+	static bool canView(const Graph &graph, int edge){
+		if(edge == graph.inputEdge() || edge == graph.outputEdge())
+		{
+			return false;
+		}
+		const Edge &e = graph.edge(edge);
+		for(size_t c = 0; c < e.consumers.size(); c++)
+		{
+			if(graph.node(e.consumers[c]).type == OpType::FC)
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+
+	void Network::planViews(){
+		_in_place.assign(_graph.nodes().size(), false);
+		//QASYMM8 concat inputs have ranges of their own and are requantized, views need the planner to place their parent
+		if(!_options.split_concat_views || !_options.plan_memory || _options.quantize || _options.comm != nullptr)
+		{
+			return;
+		}
+#ifndef OPWRAPPER_AVX2
+		//Several NEON kernels collapse the channel and batch dimensions into one, which a channel view of a batch is not
+		if(_options.batch > 1)
+		{
+			return;
+		}
+#endif
+		const std::vector<Node> &nodes = _graph.nodes();
+		std::vector<bool> view(_graph.edges().size(), false);
+		std::vector<bool> parent(_graph.edges().size(), false);
+		//Concats first: the producers write into their slice, which saves the inputs as well as the copy
+		for(size_t n = 0; n < nodes.size(); n++)
+		{
+			const Node &node = nodes[n];
+			if(node.type != OpType::Concat)
+			{
+				continue;
+			}
+			const int out = node.outputs[0];
+			bool in_place = out != _graph.inputEdge() && out != _graph.outputEdge() && !view[out];
+			for(size_t i = 0; i < node.inputs.size() && in_place; i++)
+			{
+				const int in = node.inputs[i];
+				in_place = canView(_graph, in) && !view[in] && !parent[in] && edgeType(in) == edgeType(out)
+						   && writesViews(_graph.node(_graph.edge(in).producer).type)
+						   && std::count(node.inputs.begin(), node.inputs.end(), in) == 1;
+			}
+			if(!in_place)
+			{
+				continue;
+			}
+			//No layer allocates the output any more
+			Tensor * output = _tensors[out];
+			output->allocator()->init(edgeInfo(out));
+			opWrapper::allocateOutput(output);
+			unsigned int first = 0;
+			for(size_t i = 0; i < node.inputs.size(); i++)
+			{
+				const int in = node.inputs[i];
+				_tensors[in]->allocator()->init(edgeInfo(in));
+				_planner.view(_tensors[in], output, first);
+				first += _graph.edge(in).c;
+				view[in] = true;
+			}
+			parent[out] = true;
+			_in_place[node.id] = true;
+		}
+		//Then the splits whose outputs are not concat inputs already
+		for(size_t n = 0; n < nodes.size(); n++)
+		{
+			const Node &node = nodes[n];
+			if(node.type != OpType::Split)
+			{
+				continue;
+			}
+			const int in = node.inputs[0];
+			bool in_place = in != _graph.inputEdge() && in != _graph.outputEdge() && !view[in];
+			for(size_t o = 0; o < node.outputs.size() && in_place; o++)
+			{
+				in_place = canView(_graph, node.outputs[o]) && !view[node.outputs[o]];
+			}
+			if(!in_place)
+			{
+				continue;
+			}
+			unsigned int first = 0;
+			for(size_t o = 0; o < node.outputs.size(); o++)
+			{
+				const int out = node.outputs[o];
+				_tensors[out]->allocator()->init(edgeInfo(out));
+				_planner.view(_tensors[out], _tensors[in], first);
+				first += _graph.edge(out).c;
+				view[out] = true;
+			}
+			parent[in] = true;
+			_in_place[node.id] = true;
+		}
+	}
+
+	void Network::printViews(std::ostream &os) const{
+		int nodes = 0;
+		int in_place = 0;
+		for(size_t n = 0; n < _graph.nodes().size(); n++)
+		{
+			const OpType type = _graph.nodes()[n].type;
+			if(type == OpType::Split || type == OpType::Concat)
+			{
+				nodes++;
+				in_place += _in_place[n] ? 1 : 0;
+			}
+		}
+		//A copy reads and writes every byte of a view once
+		os << std::fixed << std::setprecision(2);
+		os << in_place << " of " << nodes << " split and concat nodes run in place on " << _planner.numViews() << " channel views, "
+		   << 2 * _planner.viewBytes() / 1048576.0 << " MB of copies saved per run" << std::endl;
+	}
+
+	Tensor * Network::newTensor(){
+		_owned.emplace_back(new Tensor());
+		return _owned.back().get();
+	}
+
+	void Network::addLayer(const std::string &name, int node, IFunction * func,
+						   const std::vector<ITensor *> &inputs, const std::vector<ITensor *> &outputs){
+		_functions.emplace_back(func);
+		addStep(name, node, _graph.node(node).type, std::bind(&IFunction::run, func), inputs, outputs);
+	}
+
+	void Network::addStep(const std::string &name, int node, OpType type, const std::function<void()> &run,
+						  const std::vector<ITensor *> &inputs, const std::vector<ITensor *> &outputs){
+		Layer layer;
+		layer.name = name;
+		layer.node = node;
+		layer.type = type;
+		layer.run = run;
+		layer.inputs = inputs;
+		layer.outputs = outputs;
+		_layers.push_back(layer);
+	}
+
+	//Called for every node at its place in the global schedule, on every rank
+	//The owner sends each output to the ranks that consume it, those ranks receive it at the same point
+	void Network::exchange(const Node &node){
+		Communicator * comm = _options.comm;
+		if(comm == nullptr)
+		{
+			return;
+		}
+		const int owner = rankOf(node);
+		for(size_t o = 0; o < node.outputs.size(); o++)
+		{
+			const Edge &edge = _graph.edge(node.outputs[o]);
+			std::vector<bool> needed(comm->size(), false);
+			for(size_t c = 0; c < edge.consumers.size(); c++)
+			{
+				needed[rankOf(_graph.node(edge.consumers[c]))] = true;
+			}
+			needed[owner] = false;
+
+			Tensor * tensor = _tensors[edge.id];
+			if(comm->rank() == owner)
+			{
+				for(int peer = 0; peer < comm->size(); peer++)
+				{
+					if(needed[peer])
+					{
+						addStep(edge.name + "_send" + std::to_string(peer), node.id, OpType::Send,
+								[comm, peer, tensor]() { comm->send(peer, tensor); }, {tensor}, {});
+					}
+				}
+			}
+			else if(needed[comm->rank()])
+			{
+				//Nothing is configured on this side, the shape comes from the graph
+				if(edge.id != _graph.inputEdge())
+				{
+					tensor->allocator()->init(edgeInfo(edge.id));
+					opWrapper::allocateOutput(tensor);
+				}
+				addStep(edge.name + "_recv", node.id, OpType::Recv,
+						[comm, owner, tensor]() { comm->recv(owner, tensor); }, {}, {tensor});
+			}
+		}
+	}
+
+	int Network::rankOf(const Node &node) const{
+		return _options.place ? _options.place(node) : placeNode(node, _options.comm->size());
+	}
+
+	int quantizationSource(const Graph &graph, int edge){
+		const Node &producer = graph.node(graph.edge(edge).producer);
+		switch(producer.type)
+		{
+			case OpType::Input:
+			case OpType::Conv:
+			case OpType::DWConv:
+			case OpType::FC:
+			case OpType::Add:
+			case OpType::Concat:
+				return edge;
+			default:
+				return quantizationSource(graph, producer.inputs[0]);
+		}
+	}
+
+	bool keepsF32(const Graph &graph, int edge){
+		const Node &producer = graph.node(graph.edge(edge).producer);
+		switch(producer.type)
+		{
+			case OpType::ReduceMean:
+			case OpType::FC:
+				return true;
+			case OpType::Input:
+				return false;
+			default:
+				return keepsF32(graph, producer.inputs[0]);
+		}
+	}
+
+	DataType Network::edgeType(int edge) const{
+		if(_options.quantize)
+		{
+			return DataType::QASYMM8;
+		}
+		return _options.fp16 && !keepsF32(_graph, edge) ? DataType::F16 : DataType::F32;
+	}
+
+	//The batch is the 4th dimension of the activations, the FC collapses (W, H, C) into its outputs so its batch is the 2nd
+	TensorShape Network::edgeShape(int edge) const{
+		const Edge &e = _graph.edge(edge);
+		if(e.producer >= 0 && _graph.node(e.producer).type == OpType::FC)
+		{
+			return TensorShape(e.w, _options.batch);
+		}
+		return TensorShape(e.w, e.h, e.c, _options.batch);
+	}
+
+	//Tensor info of an edge before its producer is configured, for quantized outputs and received tensors
+	TensorInfo Network::edgeInfo(int edge) const{
+		const TensorShape shape = edgeShape(edge);
+		if(!_options.quantize)
+		{
+			return TensorInfo(shape, 1, edgeType(edge));
+		}
+		return TensorInfo(shape, 1, DataType::QASYMM8, quantization(quantizationSource(_graph, edge)));
+	}
+
+	//The reductions of a F16 network run in F32, their F16 input is widened first
+	Tensor * Network::castToF32(const Node &node, Tensor * input){
+		if(input->info()->data_type() != DataType::F16)
+		{
+			return input;
+		}
+		Tensor * wide = newTensor();
+		wide->allocator()->init(TensorInfo(input->info()->tensor_shape(), 1, DataType::F32));
+		addLayer(node.name + "_to_f32", node.id, opWrapper::CastOp(input, wide), {input}, {wide});
+		_layers.back().type = OpType::Cast;
+		return wide;
+	}
+
+	QuantizationInfo Network::quantization(int edge) const{
+		const Edge &e = _graph.edge(edge);
+		const opWrapper::BundleEntry * entry = _bundle ? _bundle->find(opWrapper::rangeKey(e.name)) : nullptr;
+		if(entry == nullptr)
+		{
+#ifdef OPWRAPPER_SYNTHETIC
+			//Nothing was calibrated for synthetic weights, any range exercises the same kernels
+			return opWrapper::rangeQuantization(0.f, 1.f);
+#else
+			ARM_COMPUTE_ERROR("No calibrated range for %s, load the bundle written by calibrate", e.name.c_str());
+#endif
+		}
+		if(entry->data_type != DataType::F32 || entry->shape.total_size() != 2)
+		{
+			ARM_COMPUTE_ERROR("Range of %s is not two F32 values", e.name.c_str());
+		}
+		const float * range = reinterpret_cast<const float *>(_bundle->data(*entry));
+		return opWrapper::rangeQuantization(range[0], range[1]);
+	}
+
+	void Network::checkShape(int edge){
+		const TensorShape &shape = _tensors[edge]->info()->tensor_shape();
+		const TensorShape expected = edgeShape(edge);
+		if(shape[0] != expected[0] || shape[1] != expected[1] || shape[2] != expected[2] || shape[3] != expected[3])
+		{
+			ARM_COMPUTE_ERROR("Shape of %s is %dx%dx%dx%d, graph expects %dx%dx%dx%d", _graph.edge(edge).name.c_str(),
+							  static_cast<int>(shape[0]), static_cast<int>(shape[1]), static_cast<int>(shape[2]), static_cast<int>(shape[3]),
+							  static_cast<int>(expected[0]), static_cast<int>(expected[1]), static_cast<int>(expected[2]), static_cast<int>(expected[3]));
+		}
+	}
+
+	void Network::lowerConv(const Node &node, Tensor * input, Tensor * output, int bn_offset){
+		const Edge &in = _graph.edge(node.inputs[0]);
+		IFunction * conv = nullptr;
+#ifdef OPWRAPPER_SYNTHETIC
+		ARM_COMPUTE_UNUSED(bn_offset);
+		if(node.bn.empty())
+		{
+			conv = opWrapper::ConvolutionLayer(input, output, node.stride, node.padding, node.kernel, node.kernel,
+											   in.c / node.groups, node.channels / node.groups, activation(node.relu));
+		}
+		else
+		{
+			conv = opWrapper::ConvolutionBNLayer(input, output, node.stride, node.padding, node.kernel, node.kernel,
+												 in.c / node.groups, node.channels / node.groups, activation(node.relu));
+		}
+#else
+		ARM_COMPUTE_UNUSED(in);
+		if(node.bn.empty())
+		{
+			conv = opWrapper::ConvolutionLayer(input, output, node.stride, node.padding,
+											   _options.data_path + node.name + "_weights_0.npy", activation(node.relu), node.shuffle);
+		}
+		else
+		{
+			conv = opWrapper::ConvolutionBNLayer(input, output, node.stride, node.padding, _options.data_path + node.name + "_weights_0.npy",
+												 _options.data_path + node.bn, bn_offset, activation(node.relu), node.shuffle);
+		}
+#endif
+		addLayer(node.name, node.id, conv, {input}, {output});
+	}
+
+	void Network::lowerGroupedConv(const Node &node, Tensor * input, Tensor * output){
+		if(output->info()->total_size() == 0)
+		{
+			//The group views are cut from the output, it is shaped before configure
+			output->allocator()->init(edgeInfo(node.outputs[0]));
+		}
+		opWrapper::GroupedConvolution * conv = nullptr;
+#ifdef OPWRAPPER_SYNTHETIC
+		conv = opWrapper::GroupedConvolutionLayer(input, output, node.stride, node.padding, node.kernel, node.kernel, node.groups,
+												  !node.bn.empty(), activation(node.relu), node.shuffle);
+#else
+		std::vector<std::string> weights;
+		for(int g = 0; g < node.groups; g++)
+		{
+			weights.push_back(_options.data_path + node.name + "_g" + std::to_string(g) + "_weights_0.npy");
+		}
+		conv = opWrapper::GroupedConvolutionLayer(input, output, node.stride, node.padding, weights,
+												  node.bn.empty() ? "" : _options.data_path + node.bn, activation(node.relu), node.shuffle);
+#endif
+		addLayer(node.name, node.id, conv, {input}, {output});
+	}
+
+	void Network::lower(const Node &node){
+		Tensor * in = node.inputs.empty() ? nullptr : _tensors[node.inputs[0]];
+		Tensor * out = node.outputs.empty() ? nullptr : _tensors[node.outputs[0]];
+		if(_options.verbose)
+		{
+			std::cout << "Lowering " << node.name << " [" << opName(node.type) << "]" << std::endl;
+		}
+
+		if(_options.quantize)
+		{
+			//Layers that compute new values write with their own calibrated range, set before configure
+			const OpType type = node.type;
+			if(type == OpType::Conv || type == OpType::DWConv || type == OpType::FC || type == OpType::Add || type == OpType::Concat)
+			{
+				for(size_t o = 0; o < node.outputs.size(); o++)
+				{
+					_tensors[node.outputs[o]]->allocator()->init(edgeInfo(node.outputs[o]));
+				}
+			}
+		}
+
+		switch(node.type)
+		{
+			case OpType::Input:
+				if(_options.quantize)
+				{
+					addLayer(node.name + "_quantize", node.id, opWrapper::QuantizeOp(_input, out), {_input}, {out});
+					_layers.back().type = OpType::Quantize;
+				}
+				else if(out != _input)
+				{
+					addLayer(node.name + "_to_f16", node.id, opWrapper::CastOp(_input, out), {_input}, {out});
+					_layers.back().type = OpType::Cast;
+				}
+				break;
+			case OpType::Conv:
+			{
+				if(node.groups == 1)
+				{
+					lowerConv(node, in, out, 0);
+					break;
+				}
+				if(groupedViews(_options))
+				{
+					lowerGroupedConv(node, in, out);
+					break;
+				}
+				//NEConvolutionLayer has no groups on NEON, emulate them with split + dense convs + concat
+				std::vector<ITensor *> slices;
+				std::vector<ITensor *> results;
+				for(int g = 0; g < node.groups; g++)
+				{
+					slices.push_back(newTensor());
+					Tensor * result = newTensor();
+					if(_options.quantize)
+					{
+						//Every group writes with the range of the whole output, the concat then only copies
+						TensorShape shape = edgeShape(node.outputs[0]);
+						shape.set(2, shape[2] / node.groups);
+						result->allocator()->init(TensorInfo(shape, 1, DataType::QASYMM8, out->info()->quantization_info()));
+					}
+					results.push_back(result);
+				}
+				addLayer(node.name + "_split", node.id, opWrapper::SplitLayer(in, slices, 2), {in}, slices);
+				_layers.back().type = OpType::Split;
+				for(int g = 0; g < node.groups; g++)
+				{
+					opWrapper::allocateOutput(static_cast<Tensor *>(slices[g]));
+				}
+				for(int g = 0; g < node.groups; g++)
+				{
+					Node group = node;
+					group.name = node.name + "_g" + std::to_string(g);
+					lowerConv(group, static_cast<Tensor *>(slices[g]), static_cast<Tensor *>(results[g]), g * node.channels / node.groups);
+				}
+				addLayer(node.name + "_concat", node.id, opWrapper::ConcatLayer(results, out), results, {out});
+				_layers.back().type = OpType::Concat;
+				break;
+			}
+			case OpType::DWConv:
+			{
+				IFunction * dwconv = nullptr;
+#ifdef OPWRAPPER_SYNTHETIC
+				if(node.bn.empty())
+				{
+					dwconv = opWrapper::DWConvolutionLayer(in, out, node.stride, node.padding, node.kernel, node.kernel, node.channels, activation(node.relu));
+				}
+				else
+				{
+					dwconv = opWrapper::DWConvolutionBNLayer(in, out, node.stride, node.padding, node.kernel, node.kernel, node.channels, activation(node.relu));
+				}
+#else
+				const std::string weights = _options.data_path + node.name + "_weights_0.npy";
+				if(node.bn.empty())
+				{
+					dwconv = opWrapper::DWConvolutionLayer(in, out, node.stride, node.padding, weights, activation(node.relu), node.shuffle);
+				}
+				else
+				{
+					dwconv = opWrapper::DWConvolutionBNLayer(in, out, node.stride, node.padding, weights, _options.data_path + node.bn,
+															 activation(node.relu), node.shuffle);
+				}
+#endif
+				addLayer(node.name, node.id, dwconv, {in}, {out});
+				break;
+			}
+			case OpType::BN:
+			{
+				if(_options.quantize)
+				{
+					ARM_COMPUTE_ERROR("BN has no QASYMM8 kernel, fold it into its convolution");
+				}
+#ifdef OPWRAPPER_SYNTHETIC
+				addLayer(node.name, node.id, opWrapper::BNLayer(in, out, _graph.edge(node.inputs[0]).c, activation(node.relu)), {in}, {out});
+#else
+				addLayer(node.name, node.id, opWrapper::BNLayer(in, out, _options.data_path + node.name, activation(node.relu)), {in}, {out});
+#endif
+				break;
+			}
+			case OpType::Activation:
+				addLayer(node.name, node.id, opWrapper::ActivationOp(in, out, activation(true)), {in}, {out});
+				break;
+			case OpType::MaxPool:
+				addLayer(node.name, node.id, opWrapper::PoolLayer(in, out, PoolingType::MAX, node.kernel, node.stride, node.padding), {in}, {out});
+				break;
+			case OpType::AvgPool:
+				addLayer(node.name, node.id, opWrapper::PoolLayer(in, out, PoolingType::AVG, node.kernel, node.stride, node.padding), {in}, {out});
+				break;
+			case OpType::Add:
+			{
+				Tensor * residual = _tensors[node.inputs[1]];
+				if(_options.fuse_epilogue && !_options.quantize)
+				{
+#ifdef OPWRAPPER_SYNTHETIC
+					addLayer(node.name, node.id, opWrapper::ResidualAddOp(in, residual, out, activation(node.relu), !node.bn.empty()), {in, residual}, {out});
+#else
+					const std::string bn_filename = node.bn.empty() ? "" : _options.data_path + node.bn;
+					addLayer(node.name, node.id, opWrapper::ResidualAddOp(in, residual, out, activation(node.relu), bn_filename), {in, residual}, {out});
+#endif
+					break;
+				}
+				addLayer(node.name, node.id, opWrapper::ElementAddOp(in, residual, out), {in, residual}, {out});
+				if(node.relu)
+				{
+					addLayer(node.name + "_relu", node.id, opWrapper::ActivationOp(out, nullptr, activation(true)), {out}, {out});
+					_layers.back().type = OpType::Activation;
+				}
+				break;
+			}
+			case OpType::ChannelShuffle:
+				addLayer(node.name, node.id, opWrapper::CSLayer(in, out, node.groups), {in}, {out});
+				break;
+			case OpType::Split:
+			{
+				if(_in_place[node.id])
+				{
+					//The outputs are views of the input, see planViews()
+					break;
+				}
+				std::vector<ITensor *> outputs;
+				for(size_t o = 0; o < node.outputs.size(); o++)
+				{
+					outputs.push_back(_tensors[node.outputs[o]]);
+				}
+				addLayer(node.name, node.id, opWrapper::SplitLayer(in, outputs, 2), {in}, outputs);
+				//SplitLayer leaves the outputs to the caller
+				for(size_t o = 0; o < node.outputs.size(); o++)
+				{
+					opWrapper::allocateOutput(_tensors[node.outputs[o]]);
+				}
+				break;
+			}
+			case OpType::Concat:
+			{
+				if(_in_place[node.id])
+				{
+					//The producers wrote their slice of the output already
+					break;
+				}
+				std::vector<ITensor *> inputs;
+				for(size_t i = 0; i < node.inputs.size(); i++)
+				{
+					inputs.push_back(_tensors[node.inputs[i]]);
+				}
+				addLayer(node.name, node.id, opWrapper::ConcatLayer(inputs, out), inputs, {out});
+				break;
+			}
+			case OpType::ReduceMean:
+				in = castToF32(node, in);
+				addLayer(node.name, node.id, opWrapper::ReduceMeanLayer(in, out, Coordinates(0, 1)), {in}, {out});
+				break;
+			case OpType::FC:
+			{
+				in = castToF32(node, in);
+#ifdef OPWRAPPER_SYNTHETIC
+				addLayer(node.name, node.id, opWrapper::FullyConnectedLayer(in, out, static_cast<int>(_graph.edge(node.inputs[0]).elements()), node.channels), {in}, {out});
+#else
+				addLayer(node.name, node.id, opWrapper::FullyConnectedLayer(in, out, _options.data_path), {in}, {out});
+#endif
+				break;
+			}
+			default:
+				ARM_COMPUTE_ERROR("Unsupported node %s", node.name.c_str());
+		}
+	}
+
+	void Network::run(){
+		for(size_t i = 0; i < _layers.size(); i++)
+		{
+			_layers[i].run();
+		}
+	}
+
+ }
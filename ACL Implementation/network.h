@@ -0,0 +1,152 @@
+#ifndef OPNETWORK
+#define OPNETWORK
+
+#include "graph.h"
+#include "weightBundle.h"
+#if defined(OPWRAPPER_AVX2)
+#include "opWrapper_avx2.h"
+#elif defined(OPWRAPPER_SYNTHETIC)
+#include "opWrapper_synthetic.h"
+#else
+#include "opWrapper.h"
+#endif
+
+#include <functional>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace opGraph{
+
+	class Communicator;
+
+	//One runnable entry of the flat layer list, this is what m_vecFuc used to hold
+	struct Layer{
+		std::string name;
+		int node;
+		OpType type;					//what the function computes, a grouped Conv also yields Split and Concat layers
+		std::function<void()> run;
+		std::vector<ITensor *> inputs;		//tensors the function reads, used for the activation lifetimes
+		std::vector<ITensor *> outputs;
+
+		Layer()
+			: name(), node(-1), type(OpType::Input), run(), inputs(), outputs()
+		{
+		}
+	};
+
+	struct CompileOptions{
+		std::string data_path;		//prefix of the NPY dumps, not used by the synthetic wrappers
+		std::string weight_bundle;	//packed parameters written by pack_weights, files missing from it fall back to data_path
+		std::string warm_cache;		//prepared parameters of this graph and options, written on the first start and read on later ones, not used by the synthetic wrappers
+		bool verbose;
+		bool plan_memory;			//share activation memory between tensors that are never alive together
+		bool fold_bn;				//merge every BN that follows a Conv or DWConv into its weights and bias
+		bool fold_shuffle;			//write channels in shuffled order from the Conv before a ChannelShuffle instead of permuting a copy
+		bool fuse_epilogue;			//run BN + Add + ReLU at the end of a residual block as one pass, F32 and F16 only
+		int workspace_pools;		//copies of the shared workspaces, one per layer that may run at the same time
+		bool grouped_views;			//grouped convs work on channel views of their input and output, needs plan_memory and on NEON a batch of 1
+		bool split_concat_views;	//split outputs and concat inputs are channel views of the tensor on the other side so neither copies, needs plan_memory
+		bool quantize;				//QASYMM8 activations, ranges and parameters come from the bundle written by calibrate
+		bool fp16;					//F16 activations and weights, ReduceMean and the FC stay F32, ignored on cores without FP16 arithmetic
+		int batch;					//images per run, every activation gets a 4th dimension, the FC output is (classes, batch)
+		std::string conv_tuning;	//file of the convolution method per shape and thread count, see opWrapper::ConvTuner, ignored by the AVX2 backend
+		bool tune;					//time the candidate methods of the shapes the tuning file does not hold and add them to it
+		bool prepare;				//reshape every weight at the end of the constructor and free the originals no function reads any more
+		Communicator * comm;		//when set only the nodes placed on this rank are lowered, see placeNode()
+		std::function<int(const Node &)> place;	//rank of every node when comm is set, placeNode() when empty
+
+		CompileOptions()
+			: data_path(), weight_bundle(), warm_cache(), verbose(false), plan_memory(true), fold_bn(true), fold_shuffle(true), fuse_epilogue(true), workspace_pools(1), grouped_views(true), split_concat_views(true), quantize(false), fp16(false), batch(1), conv_tuning(), tune(false), prepare(true), comm(nullptr), place()
+		{
+		}
+		//The communicator is shared, not owned
+		CompileOptions(const CompileOptions &) = default;
+		CompileOptions &operator=(const CompileOptions &) = default;
+	};
+
+	//Edge whose calibrated range a quantized edge uses: its own for the layers that compute new values,
+	//the one of their input for the layers that only move or select values (pooling, shuffle, split, ReLU, mean)
+	int quantizationSource(const Graph &graph, int edge);
+	//True for the edges a F16 network keeps in F32: the outputs of ReduceMean and the FC and whatever only moves them on
+	bool keepsF32(const Graph &graph, int edge);
+
+	//The load time passes of the options, the constructor runs them on its copy of the graph
+	//Tools that only need the node names and shapes of Network::graph() call it without building a network
+	void foldGraph(Graph &graph, const CompileOptions &options);
+
+	//Lowers a Graph onto the opWrapper layers in schedule order, after the load time passes enabled in the options
+	//The network owns every activation tensor and every configured function
+	class Network{
+	public:
+		Network(const Graph &graph, const CompileOptions &options);
+		Network(const Network &) = delete;
+		Network &operator=(const Network &) = delete;
+
+		//Run every layer once
+		void run();
+		//Weight transformations of every function (GEMM reshapes, FC transposes, depthwise packing), then the original
+		//weights the functions marked as unused are freed. The constructor calls it unless CompileOptions::prepare is off
+		void prepare();
+		//Bytes of original weights freed by prepare() and the resident set around it
+		void printPrepare(std::ostream &os) const;
+		//Split and concat nodes that run in place and the copies that saves on every run
+		void printViews(std::ostream &os) const;
+
+		//Always F32, a quantized or F16 network converts at both ends
+		//The input is (W, H, C, batch), image b starts at strides_in_bytes()[3] * b
+		Tensor * input() { return _input; }
+		Tensor * output() { return _output; }
+		Tensor * tensor(int edge) { return _tensors.at(edge); }
+		const std::vector<Layer> & layers() const { return _layers; }
+		const Graph & graph() const { return _graph; }
+		const opWrapper::MemoryPlanner & memoryPlanner() const { return _planner; }
+		//False when fp16 was not asked for or the core has no FP16 arithmetic
+		bool halfPrecision() const { return _options.fp16; }
+		int batch() const { return _options.batch; }
+
+	private:
+		void planViews();
+		void lower(const Node &node);
+		void lowerConv(const Node &node, Tensor * input, Tensor * output, int bn_offset);
+		void lowerGroupedConv(const Node &node, Tensor * input, Tensor * output);
+		void addLayer(const std::string &name, int node, IFunction * func,
+					  const std::vector<ITensor *> &inputs, const std::vector<ITensor *> &outputs);
+		void addStep(const std::string &name, int node, OpType type, const std::function<void()> &run,
+					 const std::vector<ITensor *> &inputs, const std::vector<ITensor *> &outputs);
+		void exchange(const Node &node);
+		int rankOf(const Node &node) const;
+		DataType edgeType(int edge) const;
+		TensorShape edgeShape(int edge) const;
+		TensorInfo edgeInfo(int edge) const;
+		Tensor * castToF32(const Node &node, Tensor * input);
+		QuantizationInfo quantization(int edge) const;
+		void planMemory();
+		Tensor * newTensor();
+		void checkShape(int edge);
+
+		Graph _graph;
+		CompileOptions _options;
+		std::unique_ptr<opWrapper::WeightBundle> _bundle;	//mapped until the network goes away, weights point into it
+		std::vector<Tensor *> _tensors;
+		Tensor * _input;
+		Tensor * _output;
+		std::vector<std::unique_ptr<Tensor>> _owned;
+		std::vector<std::unique_ptr<Tensor>> _parameters;	//created by the factories, see opWrapper::newParameter()
+		std::vector<std::unique_ptr<IFunction>> _functions;
+		std::vector<Layer> _layers;
+		std::vector<bool> _in_place;	//per node, a split or concat whose tensors are views of one another
+		opWrapper::MemoryPlanner _planner;
+		std::shared_ptr<MemoryManagerOnDemand> _memory_manager;
+		Allocator _allocator;
+		bool _prepared;
+		size_t _released;
+		size_t _resident_before;
+		size_t _resident_after;
+	};
+
+ }
+
+
+#endif
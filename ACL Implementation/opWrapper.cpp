@@ -1,60 +1,369 @@
 #include "opWrapper.h"
 #include "dataLoader.h"
 
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <memory>
+
 namespace opWrapper{
 	 
 	//These are Layer Wrappers
 	//They can automatically configure weights and add memory manager
 	//However the input and output tensor must be handled outside
+	
+	//Epsilon of the BN layers of the exported models, BNLayer and the folded convolutions must agree
+	static const float bn_epsilon = 0.001f;
+	
+	//Parameter tensors: the shape is set before configure, the data is loaded after it
+	//Both come from the weight bundle when it holds the file, from the NPY file otherwise
+	//Float parameters take data_type (F16 layers get F16 weights), quantized ones keep the type they were written with
+	static void initWeights(Tensor * weights, const std::string &npy_filename, DataType data_type){
+		WeightBundle * bundle = weightBundle();
+		const BundleEntry * entry = bundle != nullptr ? bundle->find(npy_filename) : nullptr;
+		if(entry != nullptr)
+		{
+			const DataType type = is_data_type_float(entry->data_type) ? data_type : entry->data_type;
+			weights->allocator()->init(TensorInfo(entry->shape, 1, type, entry->quantization));
+			return;
+		}
+		NPLoader loader;
+		loader.open(npy_filename, DataLayout::NHWC);
+		loader.init_tensor(*weights, DataType::F32);
+		loader.close();
+		if(data_type != DataType::F32)
+		{
+			weights->allocator()->init(TensorInfo(weights->info()->tensor_shape(), 1, data_type));
+		}
+	}
+	
+	//The tensor goes to the parameter owner while one is set, see newParameter()
+	static Tensor * newWeights(const std::string &npy_filename, DataType data_type = DataType::F32){
+		Tensor * weights = newParameter();
+		initWeights(weights, npy_filename, data_type);
+		return weights;
+	}
+	
+	//Element by element F32 to F16, both tensors allocated and of the same shape
+	static void convertToHalf(const ITensor * src, ITensor * dst){
+		Window window;
+		window.use_tensor_dimensions(src->info()->tensor_shape());
+		execute_window_loop(window, [&](const Coordinates & id)
+		{
+			*reinterpret_cast<half *>(dst->ptr_to_element(id)) = half(*reinterpret_cast<const float *>(src->ptr_to_element(id)));
+		});
+	}
+	
+	static void loadWeights(Tensor * weights, const std::string &npy_filename){
+		WeightBundle * bundle = weightBundle();
+		const BundleEntry * entry = bundle != nullptr ? bundle->find(npy_filename) : nullptr;
+		if(weights->info()->data_type() == DataType::F16 && (entry == nullptr || entry->data_type == DataType::F32))
+		{
+			//The NPY files and the bundle stay F32, the parameter is read as it is and narrowed once
+			Tensor master;
+			master.allocator()->init(TensorInfo(weights->info()->tensor_shape(), 1, DataType::F32));
+			loadWeights(&master, npy_filename);
+			weights->allocator()->allocate();
+			convertToHalf(&master, weights);
+			return;
+		}
+		if(entry == nullptr)
+		{
+			weights->allocator()->allocate();
+			NPLoader loader;
+			loader.open(npy_filename, DataLayout::NHWC);
+			if(loader.is_open())
+			{
+				loader.fill_tensor(*weights);
+				loader.close();
+			}
+			return;
+		}
+		
+		const ITensorInfo * info = weights->info();
+		if(info->padding().empty() && info->total_size() == entry->size)
+		{
+			//Zero copy, the tensor points into the mapped file
+			importMemory(weights, bundle->data(*entry));
+			return;
+		}
+		//A kernel asked for padding the bundle does not have, copy row by row
+		weights->allocator()->allocate();
+		const size_t row = info->dimension(0) * info->element_size();
+		const uint8_t * src = bundle->data(*entry);
+		Window window;
+		window.use_tensor_dimensions(info->tensor_shape());
+		window.set(Window::DimX, Window::Dimension(0, 1, 1));
+		execute_window_loop(window, [&](const Coordinates & id)
+		{
+			memcpy(weights->ptr_to_element(id), src, row);
+			src += row;
+		});
+	}
+	
+	//Warm start: while recording, every parameter is remembered in the form its layer uses it so that
+	//writePreparedBundle can save them. A prepared bundle gives them back as they are, the factories then
+	//skip the BN folding, the shuffles and the F16 conversion
+	static std::vector<std::pair<std::string, const ITensor *>> g_prepared;
+	static std::vector<std::unique_ptr<Tensor>> g_kept;		//host only parameters copied for the cache
+	static bool g_record = false;
+	
+	static bool isPrepared(const std::string &npy_filename){
+		WeightBundle * bundle = weightBundle();
+		return bundle != nullptr && bundle->prepared() && bundle->find(npy_filename) != nullptr;
+	}
+	
+	static void keepPrepared(const std::string &npy_filename, const ITensor * tensor){
+		if(g_record && tensor != nullptr)
+		{
+			g_prepared.emplace_back(bundleKey(npy_filename), tensor);
+		}
+	}
+	
+	//For parameters a layer only reads into host memory, the cache gets its own copy
+	static void keepPrepared(const std::string &npy_filename, const std::vector<float> &values){
+		if(g_record)
+		{
+			Tensor * tensor = new Tensor();
+			tensor->allocator()->init(TensorInfo(TensorShape(values.size()), 1, DataType::F32));
+			tensor->allocator()->allocate();
+			memcpy(tensor->buffer(), values.data(), values.size() * sizeof(float));
+			g_kept.emplace_back(tensor);
+			keepPrepared(npy_filename, tensor);
+		}
+	}
+	
+	void recordPrepared(bool record){
+		g_record = record;
+		g_prepared.clear();
+		g_kept.clear();
+	}
+	
+	void writePreparedBundle(const std::string &filename, const std::string &signature){
+		Tensor key;
+		key.allocator()->init(TensorInfo(TensorShape(signature.size()), 1, DataType::U8));
+		key.allocator()->allocate();
+		memcpy(key.buffer(), signature.data(), signature.size());
+		g_prepared.emplace_back(preparedKey(), &key);
+		writeWeightBundle(filename, g_prepared);
+		g_prepared.clear();
+		g_kept.clear();
+	}
+	
+	//Read a 1D parameter (BN statistics) into host memory, through a tensor of its own that no owner sees
+	static std::vector<float> loadVector(const std::string &npy_filename){
+		Tensor tensor;
+		initWeights(&tensor, npy_filename, DataType::F32);
+		loadWeights(&tensor, npy_filename);
+		const float * data = reinterpret_cast<const float *>(tensor.buffer());
+		return std::vector<float>(data, data + tensor.info()->tensor_shape().total_size());
+	}
+	
+	//y = gamma * (conv(x) - mean) / sqrt(var + eps) + beta becomes conv'(x) + bias with
+	//w' = w * scale and bias = beta - mean * scale, scale = gamma / sqrt(var + eps), per output channel
+	void foldBatchNorm(Tensor * weights, Tensor * biases, const std::string &bn_filename, int bn_offset, unsigned int channel_dim){
+		const std::vector<float> mean = loadVector(bn_filename + "_moving_mean_0.npy");
+		const std::vector<float> var = loadVector(bn_filename + "_moving_variance_0.npy");
+		const std::vector<float> gamma = loadVector(bn_filename + "_gamma_0.npy");
+		const std::vector<float> beta = loadVector(bn_filename + "_beta_0.npy");
+		
+		const size_t channels = weights->info()->dimension(channel_dim);
+		const size_t available = std::min(std::min(mean.size(), var.size()), std::min(gamma.size(), beta.size()));
+		if(bn_offset < 0 || bn_offset + channels > available)
+		{
+			ARM_COMPUTE_ERROR("%s has fewer channels than the convolution", bn_filename.c_str());
+		}
+		
+		std::vector<float> scale(channels);
+		for(size_t c = 0; c < channels; c++)
+		{
+			const size_t b = bn_offset + c;
+			scale[c] = gamma[b] / std::sqrt(var[b] + bn_epsilon);
+			*reinterpret_cast<float *>(biases->ptr_to_element(Coordinates(c))) = beta[b] - mean[b] * scale[c];
+		}
+		
+		Window window;
+		window.use_tensor_dimensions(weights->info()->tensor_shape());
+		execute_window_loop(window, [&](const Coordinates & id)
+		{
+			*reinterpret_cast<float *>(weights->ptr_to_element(id)) *= scale[id[channel_dim]];
+		});
+	}
+	 
+	std::string biasFilename(const std::string &weights_filename){
+		const std::string suffix = "_weights_0.npy";
+		const size_t pos = weights_filename.rfind(suffix);
+		if(pos == std::string::npos)
+		{
+			ARM_COMPUTE_ERROR("%s is not a weights file", weights_filename.c_str());
+		}
+		return weights_filename.substr(0, pos) + "_biases_0.npy";
+	}
+	
+	Tensor * loadParameter(const std::string &npy_filename){
+		Tensor * tensor = newWeights(npy_filename);
+		loadWeights(tensor, npy_filename);
+		return tensor;
+	}
+	
+	static bool isQuantized(const ITensor * tensor){
+		return is_data_type_quantized_asymmetric(tensor->info()->data_type());
+	}
+	
+	//Weights and biases of a float layer follow its input, F16 activations run with F16 parameters
+	static DataType parameterType(const ITensor * input){
+		return input->info()->data_type() == DataType::F16 ? DataType::F16 : DataType::F32;
+	}
+	
+	//Reorder a parameter along dim the way a channel shuffle with groups reorders channels:
+	//position k takes (k % groups) * (n / groups) + k / groups, n the size of dim. Any data type, done once at load time
+	static void shuffleAlong(ITensor * tensor, unsigned int dim, int groups){
+		const ITensorInfo * info = tensor->info();
+		const TensorShape &shape = info->tensor_shape();
+		const size_t element = info->element_size();
+		const size_t n = shape[dim];
+		if(groups < 1 || n % groups != 0)
+		{
+			ARM_COMPUTE_ERROR("%zu channels are not divisible by %d shuffle groups", n, groups);
+		}
+		
+		std::vector<uint8_t> copy(shape.total_size() * element);
+		Window window;
+		window.use_tensor_dimensions(shape);
+		size_t pos = 0;
+		execute_window_loop(window, [&](const Coordinates & id)
+		{
+			memcpy(&copy[pos], tensor->ptr_to_element(id), element);
+			pos += element;
+		});
+		//copy is dense with dimension 0 innermost, the stride of dim in it is the product of the dimensions below
+		size_t stride = 1;
+		for(unsigned int d = 0; d < dim; d++)
+		{
+			stride *= shape[d];
+		}
+		pos = 0;
+		execute_window_loop(window, [&](const Coordinates & id)
+		{
+			const size_t k = id[dim];
+			const size_t source = (k % groups) * (n / groups) + k / groups;
+			memcpy(tensor->ptr_to_element(id), &copy[(pos - k * stride + source * stride) * element], element);
+			pos++;
+		});
+	}
+	
+	//Fold the BN in F32 whatever the layer runs in, a F16 layer gets the folded values narrowed once
+	static void loadFolded(Tensor * weights, Tensor * biases, const std::string &npy_filename,
+						   const std::string &bn_filename, int bn_offset, unsigned int channel_dim){
+		if(weights->info()->data_type() == DataType::F32)
+		{
+			loadWeights(weights, npy_filename);
+			biases->allocator()->allocate();
+			foldBatchNorm(weights, biases, bn_filename, bn_offset, channel_dim);
+			return;
+		}
+		Tensor master_weights;
+		Tensor master_biases;
+		master_weights.allocator()->init(TensorInfo(weights->info()->tensor_shape(), 1, DataType::F32));
+		master_biases.allocator()->init(TensorInfo(biases->info()->tensor_shape(), 1, DataType::F32));
+		loadWeights(&master_weights, npy_filename);
+		master_biases.allocator()->allocate();
+		foldBatchNorm(&master_weights, &master_biases, bn_filename, bn_offset, channel_dim);
+		weights->allocator()->allocate();
+		biases->allocator()->allocate();
+		convertToHalf(&master_weights, weights);
+		convertToHalf(&master_biases, biases);
+	}
+	
+	//F16 cannot hold var + eps and its square root accurately, the statistics are normalised here in F32
+	//and the layer is left with mean 0 and var + eps = 1, so it only applies x * gamma + beta
+	static void loadHalfStatistics(Tensor * mean, Tensor * var, Tensor * gamma, Tensor * beta, const std::string &base_filename){
+		const std::vector<float> m = loadVector(base_filename + "_moving_mean_0.npy");
+		const std::vector<float> v = loadVector(base_filename + "_moving_variance_0.npy");
+		const std::vector<float> g = loadVector(base_filename + "_gamma_0.npy");
+		const std::vector<float> b = loadVector(base_filename + "_beta_0.npy");
+		const size_t channels = mean->info()->dimension(0);
+		if(m.size() != channels || v.size() != channels || g.size() != channels || b.size() != channels)
+		{
+			ARM_COMPUTE_ERROR("BN statistics of %s do not have %d channels", base_filename.c_str(), static_cast<int>(channels));
+		}
+		mean->allocator()->allocate();
+		var->allocator()->allocate();
+		gamma->allocator()->allocate();
+		beta->allocator()->allocate();
+		for(size_t c = 0; c < channels; c++)
+		{
+			const float scale = g[c] / std::sqrt(v[c] + bn_epsilon);
+			*reinterpret_cast<half *>(mean->ptr_to_element(Coordinates(c))) = half(0.f);
+			*reinterpret_cast<half *>(var->ptr_to_element(Coordinates(c))) = half(1.f - bn_epsilon);
+			*reinterpret_cast<half *>(gamma->ptr_to_element(Coordinates(c))) = half(scale);
+			*reinterpret_cast<half *>(beta->ptr_to_element(Coordinates(c))) = half(b[c] - m[c] * scale);
+		}
+	}
+	
+	//A QASYMM8 layer takes its weights and S32 biases as calibrate wrote them, the BN is already folded in
+	//(as in a prepared bundle, where the biases are stored under the name they would have had as NPY files)
+	static void newQuantizedParameters(const std::string &npy_filename, Tensor ** weights, Tensor ** biases){
+		*weights = newWeights(npy_filename);
+		*biases = newWeights(biasFilename(npy_filename));
+		if(!isQuantized(*weights) || (*biases)->info()->data_type() != DataType::S32)
+		{
+			ARM_COMPUTE_ERROR("%s is not quantized, load the bundle written by calibrate", npy_filename.c_str());
+		}
+	}
+	
+	static void loadBundledParameters(const std::string &npy_filename, Tensor * weights, Tensor * biases){
+		loadWeights(weights, npy_filename);
+		loadWeights(biases, biasFilename(npy_filename));
+	}
 	 
-	Tensor * configure1DTensor(const int dim0){
+	Tensor * configure1DTensor(const int dim0, DataType data_type){
 		const TensorShape ts_shape(dim0);		
-		Tensor * ts = new Tensor();
-		ts->allocator()->init(TensorInfo(ts_shape, 1, DataType::F32));
+		Tensor * ts = newParameter();
+		ts->allocator()->init(TensorInfo(ts_shape, 1, data_type));
 		return ts;
 	}	
-	Tensor * configure2DTensor(const int dim0, const int dim1){
+	Tensor * configure2DTensor(const int dim0, const int dim1, DataType data_type){
 		const TensorShape ts_shape(dim0, dim1);		
-		Tensor * ts = new Tensor();
-		ts->allocator()->init(TensorInfo(ts_shape, 1, DataType::F32));
+		Tensor * ts = newParameter();
+		ts->allocator()->init(TensorInfo(ts_shape, 1, data_type));
 		return ts;
 	}	
-	Tensor * configure3DTensor(const int dim0, const int dim1, const int dim2){
+	Tensor * configure3DTensor(const int dim0, const int dim1, const int dim2, DataType data_type){
 		const TensorShape ts_shape(dim0, dim1, dim2);		
-		Tensor * ts = new Tensor();
-		ts->allocator()->init(TensorInfo(ts_shape, 1, DataType::F32));
+		Tensor * ts = newParameter();
+		ts->allocator()->init(TensorInfo(ts_shape, 1, data_type));
 		return ts;
 	}	
-	Tensor * configure4DTensor(const int dim0, const int dim1, const int dim2, const int dim3){
-		const TensorShape ts_shape(dim0, dim1, dim2);		
+	Tensor * configure4DTensor(const int dim0, const int dim1, const int dim2, const int dim3, DataType data_type){
+		const TensorShape ts_shape(dim0, dim1, dim2, dim3);		
 		Tensor * ts = new Tensor();
-		ts->allocator()->init(TensorInfo(ts_shape, 1, DataType::F32));
+		ts->allocator()->init(TensorInfo(ts_shape, 1, data_type));
 		return ts;
 	}		
 	
 	
 	
 
-	NEConvolutionLayer * ConvolutionLayer(Tensor * input, Tensor * output, int stride, int padding, const std::string &npy_filename){ 
+	IFunction * ConvolutionLayer(Tensor * input, Tensor * output, int stride, int padding, const std::string &npy_filename, const ActivationLayerInfo &act_info,
+								 int shuffle){ 
 		
-		Tensor * weights = new Tensor();
-		NPLoader weightLoader;
-		weightLoader.open(npy_filename, DataLayout::NHWC);
-		weightLoader.init_tensor(*weights, DataType::F32);
-			
+		if(isQuantized(input))
+		{
+			return ConvolutionBNLayer(input, output, stride, padding, npy_filename, "", 0, act_info, shuffle);
+		}
+		Tensor * weights = newWeights(npy_filename, parameterType(input));
 		
-		NEConvolutionLayer * conv = new NEConvolutionLayer();
-		conv->configure(input, weights, nullptr, output, PadStrideInfo(stride, stride, padding, padding), WeightsInfo(),
-             Size2D(1U, 1U), ActivationLayerInfo(ActivationLayerInfo::ActivationFunction::RELU));				
+		IFunction * conv = newConvolution(input, weights, nullptr, output, PadStrideInfo(stride, stride, padding, padding), act_info);
 				
-		weights->allocator()->allocate();
-		output->allocator()->allocate();	
-		
-		if(weightLoader.is_open())
+		loadWeights(weights, npy_filename);
+		if(shuffle > 0 && !isPrepared(npy_filename))
 		{
-			weightLoader.fill_tensor(*weights);
-			weightLoader.close();
-		}	
+			shuffleAlong(weights, 3, shuffle);
+		}
+		keepPrepared(npy_filename, weights);
+		allocateOutput(output);	
+		
 		std::cout<<weights->info()->tensor_shape()[0]<<std::endl;
 		std::cout<<weights->info()->tensor_shape()[1]<<std::endl;
 		std::cout<<weights->info()->tensor_shape()[2]<<std::endl;
@@ -64,66 +373,155 @@ namespace opWrapper{
 		return conv;
 	}
 	
-	NEPoolingLayer * MaxPoolLayer(Tensor * input, Tensor * output, int poolsize, int stride){		
-		NEPoolingLayer * pool = new NEPoolingLayer();
-		pool->configure(input, output, PoolingLayerInfo(PoolingType::MAX, poolsize, PadStrideInfo(2, 2, 0, 0)));
-		output->allocator()->allocate();
-		//std::cout<<output->info()->tensor_shape()[0]<<std::endl;
-		return pool; 
+	IFunction * ConvolutionBNLayer(Tensor * input, Tensor * output, int stride, int padding, const std::string &npy_filename,
+								   const std::string &bn_filename, int bn_offset, const ActivationLayerInfo &act_info, int shuffle){
+		
+		Tensor * weights = nullptr;
+		Tensor * biases = nullptr;
+		if(isQuantized(input))
+		{
+			newQuantizedParameters(npy_filename, &weights, &biases);
+		}
+		else
+		{
+			weights = newWeights(npy_filename, parameterType(input));
+			biases = configure1DTensor(weights->info()->dimension(3), parameterType(input));
+		}
+		
+		IFunction * conv = newConvolution(input, weights, biases, output, PadStrideInfo(stride, stride, padding, padding), act_info);
+		
+		allocateOutput(output);
+		const bool prepared = isPrepared(npy_filename);
+		if(isQuantized(input) || prepared)
+		{
+			loadBundledParameters(npy_filename, weights, biases);
+		}
+		else
+		{
+			//The weights are only reshaped on the first run, folding them after configure is fine
+			//ACL weights are (kernel_x, kernel_y, IFM, OFM)
+			loadFolded(weights, biases, npy_filename, bn_filename, bn_offset, 3);
+		}
+		//The output channels come out shuffled, the BN was folded in the original order
+		if(shuffle > 0 && !prepared)
+		{
+			shuffleAlong(weights, 3, shuffle);
+			shuffleAlong(biases, 0, shuffle);
+		}
+		keepPrepared(npy_filename, weights);
+		keepPrepared(biasFilename(npy_filename), biases);
+		
+		return conv;
 	}
 	
-	NEBatchNormalizationLayer * BNLayer(Tensor * input, Tensor * output, const std::string &base_filename){		
+	GroupedConvolution * GroupedConvolutionLayer(Tensor * input, Tensor * output, int stride, int padding, const std::vector<std::string> &npy_filenames,
+												 const std::string &bn_filename, const ActivationLayerInfo &act_info, int shuffle){
 		
-		Tensor * mean = new Tensor();
-		Tensor * var = new Tensor();
-		Tensor * gamma = new Tensor();
-		Tensor * beta = new Tensor();
+		const unsigned int groups = npy_filenames.size();
+		if(output->info()->total_size() == 0)
+		{
+			ARM_COMPUTE_ERROR("The output of a grouped convolution must be initialised");
+		}
+		if(groups == 0 || input->info()->dimension(2) % groups != 0 || output->info()->dimension(2) % groups != 0)
+		{
+			ARM_COMPUTE_ERROR("The channels of a grouped convolution are not divisible by its %u groups", groups);
+		}
+		if(shuffle > 0 && static_cast<unsigned int>(shuffle) != groups)
+		{
+			ARM_COMPUTE_ERROR("A folded shuffle must have the groups of the convolution");
+		}
+		const unsigned int in_channels = input->info()->dimension(2) / groups;
+		const unsigned int out_channels = output->info()->dimension(2) / groups;
 		
-		NPLoader meanLoader;
-		NPLoader varLoader; 
-		NPLoader gammaLoader; 
-		NPLoader betaLoader;
+		GroupedConvolution * grouped = new GroupedConvolution();
+		std::vector<Tensor *> weights(groups, nullptr);
+		std::vector<Tensor *> biases(groups, nullptr);
+		for(unsigned int g = 0; g < groups; g++)
+		{
+			if(isQuantized(input))
+			{
+				newQuantizedParameters(npy_filenames[g], &weights[g], &biases[g]);
+			}
+			else
+			{
+				weights[g] = newWeights(npy_filenames[g], parameterType(input));
+				if(!bn_filename.empty())
+				{
+					biases[g] = configure1DTensor(weights[g]->info()->dimension(3), parameterType(input));
+				}
+			}
+			//Shuffled, group g writes channels g, g + groups, ... instead of a contiguous slice
+			ITensor * group_output = shuffle > 0 ? grouped->view(output, g, out_channels, groups) : grouped->view(output, g * out_channels, out_channels);
+			grouped->add(newConvolution(grouped->view(input, g * in_channels, in_channels), weights[g], biases[g],
+										group_output, PadStrideInfo(stride, stride, padding, padding), act_info));
+		}
 		
-		meanLoader.open(base_filename+"_moving_mean_0.npy", DataLayout::NHWC);
-		varLoader.open(base_filename+"_moving_variance_0.npy", DataLayout::NHWC); 
-		gammaLoader.open(base_filename+"_gamma_0.npy", DataLayout::NHWC); 
-		betaLoader.open(base_filename+"_beta_0.npy", DataLayout::NHWC);
+		//Every group has extended the padding of output by now
+		grouped->extendParents();
+		allocateOutput(output);
+		for(unsigned int g = 0; g < groups; g++)
+		{
+			if(biases[g] == nullptr)
+			{
+				loadWeights(weights[g], npy_filenames[g]);
+			}
+			else if(isQuantized(input) || isPrepared(npy_filenames[g]))
+			{
+				loadBundledParameters(npy_filenames[g], weights[g], biases[g]);
+			}
+			else
+			{
+				loadFolded(weights[g], biases[g], npy_filenames[g], bn_filename, g * out_channels, 3);
+			}
+			keepPrepared(npy_filenames[g], weights[g]);
+			keepPrepared(biasFilename(npy_filenames[g]), biases[g]);
+		}
+		return grouped;
+	}
+	
+	NEPoolingLayer * MaxPoolLayer(Tensor * input, Tensor * output, int poolsize, int stride, int padding){		
+		NEPoolingLayer * pool = new NEPoolingLayer();
+		pool->configure(input, output, PoolingLayerInfo(PoolingType::MAX, poolsize, PadStrideInfo(stride, stride, padding, padding)));
+		allocateOutput(output);
+		//std::cout<<output->info()->tensor_shape()[0]<<std::endl;
+		return pool; 
+	}
+	
+	NEPoolingLayer * PoolLayer(Tensor * input, Tensor * output, PoolingType type, int poolsize, int stride, int padding){
+		NEPoolingLayer * pool = new NEPoolingLayer();
+		pool->configure(input, output, PoolingLayerInfo(type, poolsize, PadStrideInfo(stride, stride, padding, padding)));
+		allocateOutput(output);
+		return pool;
+	}
+	
+	NEBatchNormalizationLayer * BNLayer(Tensor * input, Tensor * output, const std::string &base_filename, const ActivationLayerInfo &act_info){		
 		
-		meanLoader.init_tensor(*mean, DataType::F32);
-		varLoader.init_tensor(*var, DataType::F32);
-		gammaLoader.init_tensor(*gamma, DataType::F32);
-		betaLoader.init_tensor(*beta, DataType::F32);
+		const DataType type = parameterType(input);
+		Tensor * mean = newWeights(base_filename+"_moving_mean_0.npy", type);
+		Tensor * var = newWeights(base_filename+"_moving_variance_0.npy", type);
+		Tensor * gamma = newWeights(base_filename+"_gamma_0.npy", type);
+		Tensor * beta = newWeights(base_filename+"_beta_0.npy", type);
 		
 		NEBatchNormalizationLayer * bnl = new NEBatchNormalizationLayer();
 		
-		bnl->configure(input, output, mean, var, beta, gamma, 0.001f);
+		bnl->configure(input, output, mean, var, beta, gamma, bn_epsilon, act_info);
 		
-		mean->allocator()->allocate();
-		var->allocator()->allocate();
-		gamma->allocator()->allocate();
-		beta->allocator()->allocate();		
-		output->allocator()->allocate();
-		
-		if(meanLoader.is_open())
+		if(type == DataType::F16 && !isPrepared(base_filename+"_moving_mean_0.npy"))
 		{
-			meanLoader.fill_tensor(*mean);
-			meanLoader.close();
-		}						
-		if(varLoader.is_open())
-		{
-			varLoader.fill_tensor(*var);
-			varLoader.close();
-		}	
-		if(gammaLoader.is_open())
-		{
-			gammaLoader.fill_tensor(*gamma);
-			gammaLoader.close();
-		}	
-		if(betaLoader.is_open())
+			loadHalfStatistics(mean, var, gamma, beta, base_filename);
+		}
+		else
 		{
-			betaLoader.fill_tensor(*beta);
-			betaLoader.close();
-		}				
+			loadWeights(mean, base_filename+"_moving_mean_0.npy");
+			loadWeights(var, base_filename+"_moving_variance_0.npy");
+			loadWeights(gamma, base_filename+"_gamma_0.npy");
+			loadWeights(beta, base_filename+"_beta_0.npy");
+		}
+		keepPrepared(base_filename+"_moving_mean_0.npy", mean);
+		keepPrepared(base_filename+"_moving_variance_0.npy", var);
+		keepPrepared(base_filename+"_gamma_0.npy", gamma);
+		keepPrepared(base_filename+"_beta_0.npy", beta);
+		allocateOutput(output);				
 		/* int x = 0;
 		for(int j =0; j<24 ; j++){
 				std::cout<<*reinterpret_cast<float *>(mean->allocator()->data()+x)<<"  "<<std::endl;
@@ -150,24 +548,38 @@ namespace opWrapper{
 		
 	
 		
-	NEDepthwiseConvolutionLayer * DWConvolutionLayer(Tensor * input, Tensor * output, int stride, int padding, const std::string &base_filename){
-
-		Tensor * weights = new Tensor();
-		NPLoader weightLoader;
-		weightLoader.open(base_filename, DataLayout::NHWC);
-		weightLoader.init_tensor(*weights, DataType::F32);	
-		
+	//Depthwise3x3 where it applies, NEDepthwiseConvolutionLayer otherwise
+	static IFunction * depthwise(Tensor * input, Tensor * weights, Tensor * biases, Tensor * output, int stride, int padding,
+								 const ActivationLayerInfo &act_info){
+		if(isDepthwise3x3(input, weights, stride, padding, act_info))
+		{
+			Depthwise3x3 * dw = new Depthwise3x3();
+			dw->configure(input, weights, biases, output, stride, act_info);
+			return dw;
+		}
 		NEDepthwiseConvolutionLayer * dwcl = new NEDepthwiseConvolutionLayer();
-		dwcl->configure(input, weights, nullptr, output, PadStrideInfo(stride,stride,padding,padding),1);
+		dwcl->configure(input, weights, biases, output, PadStrideInfo(stride, stride, padding, padding), 1, act_info);
+		return dwcl;
+	}
+	
+	IFunction * DWConvolutionLayer(Tensor * input, Tensor * output, int stride, int padding, const std::string &base_filename, const ActivationLayerInfo &act_info,
+													 int shuffle){
+
+		if(isQuantized(input))
+		{
+			return DWConvolutionBNLayer(input, output, stride, padding, base_filename, "", act_info, shuffle);
+		}
+		Tensor * weights = newWeights(base_filename, parameterType(input));
 		
-		weights->allocator()->allocate();
-		output->allocator()->allocate();		
+		IFunction * dwcl = depthwise(input, weights, nullptr, output, stride, padding, act_info);
 		
-		if(weightLoader.is_open())
+		loadWeights(weights, base_filename);
+		if(shuffle > 0 && !isPrepared(base_filename))
 		{
-			weightLoader.fill_tensor(*weights);
-			weightLoader.close();
+			shuffleAlong(weights, 2, shuffle);
 		}
+		keepPrepared(base_filename, weights);
+		allocateOutput(output);		
 		
 		std::cout<<weights->info()->tensor_shape()[0]<<std::endl;
 		std::cout<<weights->info()->tensor_shape()[1]<<std::endl;
@@ -178,36 +590,128 @@ namespace opWrapper{
 		
 	}
 	
+	IFunction * DWConvolutionBNLayer(Tensor * input, Tensor * output, int stride, int padding, const std::string &npy_filename,
+													   const std::string &bn_filename, const ActivationLayerInfo &act_info, int shuffle){
+		
+		Tensor * weights = nullptr;
+		Tensor * biases = nullptr;
+		if(isQuantized(input))
+		{
+			newQuantizedParameters(npy_filename, &weights, &biases);
+		}
+		else
+		{
+			weights = newWeights(npy_filename, parameterType(input));
+			biases = configure1DTensor(weights->info()->dimension(2), parameterType(input));
+		}
+		
+		IFunction * dwcl = depthwise(input, weights, biases, output, stride, padding, act_info);
+		
+		allocateOutput(output);
+		const bool prepared = isPrepared(npy_filename);
+		if(isQuantized(input) || prepared)
+		{
+			loadBundledParameters(npy_filename, weights, biases);
+		}
+		else
+		{
+			//Depthwise weights are (kernel_x, kernel_y, channels)
+			loadFolded(weights, biases, npy_filename, bn_filename, 0, 2);
+		}
+		//Input and output are both in shuffled order, every channel keeps its own filter
+		if(shuffle > 0 && !prepared)
+		{
+			shuffleAlong(weights, 2, shuffle);
+			shuffleAlong(biases, 0, shuffle);
+		}
+		keepPrepared(npy_filename, weights);
+		keepPrepared(biasFilename(npy_filename), biases);
+		
+		return dwcl;
+	}
+	
 	NEChannelShuffleLayer * CSLayer(Tensor *input, Tensor *output, int num_groups)
 	{
 		NEChannelShuffleLayer * csl = new NEChannelShuffleLayer();
 		csl->configure(input, output, num_groups);
 		//output->info()->set_data_layout(DataLayout::NHWC);
-		output->allocator()->allocate();
+		allocateOutput(output);
 		return csl;
 	}
 	
 	NEArithmeticAddition * ElementAddOp(Tensor * input1, Tensor * input2, Tensor * output)
 	{
 		NEArithmeticAddition * eal = new NEArithmeticAddition();		
-		const TensorShape x(input1->info()->tensor_shape()[0],input1->info()->tensor_shape()[1],input1->info()->tensor_shape()[2]);
-		output->allocator()->init(TensorInfo(x,1,DataType::F32));
-		eal->configure(input1, input2, output, ConvertPolicy::SATURATE);
-		output->allocator()->allocate();		
+		//A quantized output is set up by the caller with its calibrated range
+		if(output->info()->total_size() == 0)
+		{
+			output->allocator()->init(TensorInfo(input1->info()->tensor_shape(),1,input1->info()->data_type()));
+		}
+		//Floats never overflow into the policy, only QASYMM8 has to saturate
+		const ConvertPolicy policy = is_data_type_quantized_asymmetric(input1->info()->data_type()) ? ConvertPolicy::SATURATE : ConvertPolicy::WRAP;
+		eal->configure(input1, input2, output, policy);
+		allocateOutput(output);		
 		return eal;
 	}
 	
+	FusedEpilogue * ResidualAddOp(Tensor * input, Tensor * residual, Tensor * output, const ActivationLayerInfo &act_info, const std::string &bn_filename)
+	{
+		if(output->info()->total_size() == 0)
+		{
+			output->allocator()->init(TensorInfo(input->info()->tensor_shape(),1,input->info()->data_type()));
+		}
+		//Same folding as foldBatchNorm, the statistics stay F32 whatever the tensors are
+		std::vector<float> scale;
+		std::vector<float> shift;
+		if(!bn_filename.empty())
+		{
+			const std::vector<float> mean = loadVector(bn_filename + "_moving_mean_0.npy");
+			const std::vector<float> var = loadVector(bn_filename + "_moving_variance_0.npy");
+			const std::vector<float> gamma = loadVector(bn_filename + "_gamma_0.npy");
+			const std::vector<float> beta = loadVector(bn_filename + "_beta_0.npy");
+			const size_t channels = input->info()->dimension(2);
+			if(mean.size() != channels || var.size() != channels || gamma.size() != channels || beta.size() != channels)
+			{
+				ARM_COMPUTE_ERROR("%s does not match its input", bn_filename.c_str());
+			}
+			keepPrepared(bn_filename + "_moving_mean_0.npy", mean);
+			keepPrepared(bn_filename + "_moving_variance_0.npy", var);
+			keepPrepared(bn_filename + "_gamma_0.npy", gamma);
+			keepPrepared(bn_filename + "_beta_0.npy", beta);
+			for(size_t c = 0; c < mean.size(); c++)
+			{
+				scale.push_back(gamma[c] / std::sqrt(var[c] + bn_epsilon));
+				shift.push_back(beta[c] - mean[c] * scale[c]);
+			}
+		}
+		FusedEpilogue * epilogue = new FusedEpilogue();
+		epilogue->configure(input, residual, output, scale, shift, act_info);
+		allocateOutput(output);
+		return epilogue;
+	}
+	
+	NEActivationLayer * ActivationOp(Tensor * input, Tensor * output, const ActivationLayerInfo &act_info)
+	{
+		NEActivationLayer * act = new NEActivationLayer();
+		act->configure(input, output, act_info);
+		if(output != nullptr)
+		{
+			allocateOutput(output);
+		}
+		return act;
+	}
+	
 	NEReshapeLayer	* ReshapeOp(Tensor * input, Tensor * output){
 		NEReshapeLayer	* rsop = new NEReshapeLayer();
 		rsop->configure(input, output);
-		output->allocator()->allocate();
+		allocateOutput(output);
 		return rsop;
 	}
 	
 	NETranspose * TransposeOp(Tensor * input, Tensor * output){
 		NETranspose * trans = new NETranspose();
 		trans->configure(input, output);
-		output->allocator()->allocate();
+		allocateOutput(output);
 		return trans;
 	}
 	
@@ -215,7 +719,7 @@ namespace opWrapper{
 	{
 		NEConcatenateLayer * cc = new NEConcatenateLayer();
 		cc->configure(inputs_vector, output, 2);
-		output->allocator()->allocate();
+		allocateOutput(output);
 		return cc;
 	}
 	
@@ -234,23 +738,20 @@ namespace opWrapper{
 	
 	NEReduceMean * ReduceMeanLayer(Tensor * input, Tensor * output, Coordinates reduction_axis)
 	{		
-		NEReduceMean * rml = new NEReduceMean();
+		NEReduceMean * rml = new NEReduceMean(memoryManager());
 		rml->configure(input, reduction_axis, true, output);
-		output->allocator()->allocate();
+		allocateOutput(output);
 		return rml;
 	}
 	
 	NEFullyConnectedLayer * FullyConnectedLayer(Tensor * input, Tensor * output, const std::string &base_filename)
 	{
-		Tensor * weights = new Tensor();
-		NPLoader weightLoader;
-		weightLoader.open(base_filename+"classifier_weights_0.npy", DataLayout::NHWC);
-		weightLoader.init_tensor(*weights, DataType::F32);
-		
-		Tensor * biases = new Tensor();
-		NPLoader biasesLoader;
-		biasesLoader.open(base_filename+"classifier_biases_0.npy", DataLayout::NHWC);
-		biasesLoader.init_tensor(*biases, DataType::F32);
+		Tensor * weights = newWeights(base_filename+"classifier_weights_0.npy");
+		Tensor * biases = newWeights(base_filename+"classifier_biases_0.npy");
+		if(isQuantized(input) && (!isQuantized(weights) || biases->info()->data_type() != DataType::S32))
+		{
+			ARM_COMPUTE_ERROR("The classifier is not quantized, load the bundle written by calibrate");
+		}
 		
 		
 		std::cout<<weights->info()->tensor_shape()[0]<<std::endl;
@@ -261,37 +762,56 @@ namespace opWrapper{
 		std::cout<<biases->info()->tensor_shape()[1]<<std::endl;
 		std::cout<<biases->info()->tensor_shape()[2]<<std::endl;
 		
-		const TensorShape out_shape(1000);
-		output->allocator()-> init(TensorInfo(out_shape, 1, DataType::F32));
+		//One row of scores per image, the weights are (inputs, outputs)
+		const size_t batch = input->info()->tensor_shape().total_size() / weights->info()->dimension(0);
+		const TensorShape out_shape(weights->info()->dimension(1), batch);
+		if(output->info()->total_size() == 0)
+		{
+			output->allocator()-> init(TensorInfo(out_shape, 1, DataType::F32));
+		}
 		
-		NEFullyConnectedLayer * fcl = new NEFullyConnectedLayer();
+		NEFullyConnectedLayer * fcl = new NEFullyConnectedLayer(memoryManager());
 		fcl->configure(input, weights, biases, output);
 		
 		std::cout<<output->info()->tensor_shape()[0]<<std::endl;
 		std::cout<<output->info()->tensor_shape()[1]<<std::endl;
 		std::cout<<output->info()->tensor_shape()[2]<<std::endl;
 		
-		weights->allocator()->allocate();
-		biases->allocator()->allocate();
-		output->allocator()->allocate();
-		
-		if(weightLoader.is_open())
-		{
-			weightLoader.fill_tensor(*weights);
-			weightLoader.close();
-		}
-		
-		if(biasesLoader.is_open())
-		{
-			biasesLoader.fill_tensor(*biases);
-			biasesLoader.close();
-		}
+		loadWeights(weights, base_filename+"classifier_weights_0.npy");
+		loadWeights(biases, base_filename+"classifier_biases_0.npy");
+		keepPrepared(base_filename+"classifier_weights_0.npy", weights);
+		keepPrepared(base_filename+"classifier_biases_0.npy", biases);
+		allocateOutput(output);
 		
 		return fcl;
 	}
 	
 	
 	
+	NEQuantizationLayer * QuantizeOp(Tensor * input, Tensor * output)
+	{
+		NEQuantizationLayer * quant = new NEQuantizationLayer();
+		quant->configure(input, output);
+		allocateOutput(output);
+		return quant;
+	}
+	
+	NEDequantizationLayer * DequantizeOp(Tensor * input, Tensor * output)
+	{
+		NEDequantizationLayer * dequant = new NEDequantizationLayer();
+		dequant->configure(input, output);
+		allocateOutput(output);
+		return dequant;
+	}
+	
+	NEDepthConvertLayer * CastOp(Tensor * input, Tensor * output)
+	{
+		NEDepthConvertLayer * cast = new NEDepthConvertLayer();
+		cast->configure(input, output, ConvertPolicy::SATURATE, 0);
+		allocateOutput(output);
+		return cast;
+	}
+	
 	/* NEPermute * PermuteOp(Tensor *input, Tensor *output, PermutationVector &perm)
 	{
 		NEPermute * pop = new NEPermute();
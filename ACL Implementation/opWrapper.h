@@ -8,6 +8,12 @@
 #include "arm_compute/runtime/MemoryManagerOnDemand.h"
 #include "arm_compute/runtime/PoolManager.h"
 #include "utils/Utils.h"
+#include "memoryPlanner.h"
+#include "weightBundle.h"
+#include "groupedConvolution.h"
+#include "convTuner.h"
+#include "fusedEpilogue.h"
+#include "depthwise3x3.h"
 #include <string>
 
 using namespace arm_compute;
@@ -18,23 +24,75 @@ namespace opWrapper{
 	//These are Layer Wrappers
 	//They can automatically configure weights and add memory manager
 	//However the input and output tensor must be handled outside
-	Tensor * configure1DTensor(int dim0);
-	Tensor * configure2DTensor(int dim0, int dim1);
-	Tensor * configure3DTensor(int dim0, int dim1, int dim2);		
-	Tensor * configure4DTensor(int dim0, int dim1, int dim2, int dim3);	
-	NEConvolutionLayer * ConvolutionLayer(Tensor * input, Tensor * output,  
-											int stride, int padding, 
-											const std::string &npy_filename);//, const std::string &name
-	NEPoolingLayer * MaxPoolLayer(Tensor * input, Tensor * output, int poolsize, int stride);
-	
-	NEBatchNormalizationLayer * BNLayer(Tensor * input, Tensor * output, const std::string &base_filename);
-	
-	NEDepthwiseConvolutionLayer * DWConvolutionLayer(Tensor * input, Tensor * output, int stride, int padding, const std::string &base_filename);
+	//A layer whose input is QASYMM8 runs quantized, its weights and S32 biases are read from the weight bundle
+	//written by calibrate, with the BN already folded in. The output tensor must carry its quantization already
+	
+	//<name>_biases_0.npy next to <name>_weights_0.npy, where calibrate stores the bias of a quantized layer
+	std::string biasFilename(const std::string &weights_filename);
+	//One parameter tensor, allocated and filled from the bundle or its NPY file
+	//It goes to the parameter owner while one is set (see newParameter()), the caller deletes it otherwise
+	Tensor * loadParameter(const std::string &npy_filename);
+	//Merge a BN into F32 weights and biases, channel_dim is the dimension of the weights that indexes the BN channels
+	void foldBatchNorm(Tensor * weights, Tensor * biases, const std::string &bn_filename, int bn_offset, unsigned int channel_dim);
+	
+	//Warm start: while recording, the factories remember every float parameter after folding, shuffling and narrowing
+	//writePreparedBundle saves them with the signature, the layers built from that bundle load them unchanged
+	void recordPrepared(bool record);
+	void writePreparedBundle(const std::string &filename, const std::string &signature);
+	
+	//A layer whose input is F16 gets F16 weights converted from the F32 files at load time, BN statistics
+	//are normalised in F32 before the conversion
+	
+	Tensor * configure1DTensor(int dim0, DataType data_type = DataType::F32);
+	Tensor * configure2DTensor(int dim0, int dim1, DataType data_type = DataType::F32);
+	Tensor * configure3DTensor(int dim0, int dim1, int dim2, DataType data_type = DataType::F32);		
+	//configure1D-3DTensor make parameters, which go to the parameter owner while one is set (see newParameter())
+	//configure4DTensor makes an activation, which the caller always owns
+	//NCHW activations of a batch are (W, H, C, N)
+	Tensor * configure4DTensor(int dim0, int dim1, int dim2, int dim3, DataType data_type = DataType::F32);	
+	IFunction * ConvolutionLayer(Tensor * input, Tensor * output,  
+								 int stride, int padding, 
+								 const std::string &npy_filename,
+								 const ActivationLayerInfo &act_info = ActivationLayerInfo(ActivationLayerInfo::ActivationFunction::RELU),
+								 int shuffle = 0);//, const std::string &name
+	//The convolutions take the method the tuner found for their shape when one is set, see convTuner.h
+	//Convolution followed by a batch norm, the BN statistics are merged into the weights and a new bias at load time
+	//bn_offset is the first BN channel produced by this conv, a grouped conv only sees a slice of the BN
+	//shuffle > 0 permutes the output channels of the weights the way a following channel shuffle with that many groups would
+	IFunction * ConvolutionBNLayer(Tensor * input, Tensor * output, int stride, int padding,
+								   const std::string &npy_filename, const std::string &bn_filename, int bn_offset = 0,
+								   const ActivationLayerInfo &act_info = ActivationLayerInfo(), int shuffle = 0);
+	//Convolution with one weights file per group (npy_filenames[g]), run on channel views of input and output
+	//output must be initialised already, bn_filename is empty when no BN is folded in
+	//shuffle (equal to the groups) interleaves the groups in the output, a following channel shuffle folded into the conv
+	GroupedConvolution * GroupedConvolutionLayer(Tensor * input, Tensor * output, int stride, int padding,
+												 const std::vector<std::string> &npy_filenames, const std::string &bn_filename = "",
+												 const ActivationLayerInfo &act_info = ActivationLayerInfo(), int shuffle = 0);
+	NEPoolingLayer * MaxPoolLayer(Tensor * input, Tensor * output, int poolsize, int stride, int padding = 0);
+	
+	NEPoolingLayer * PoolLayer(Tensor * input, Tensor * output, PoolingType type, int poolsize, int stride, int padding);
+	
+	NEBatchNormalizationLayer * BNLayer(Tensor * input, Tensor * output, const std::string &base_filename, const ActivationLayerInfo &act_info = ActivationLayerInfo());
+	
+	//shuffle > 0: input and output are in shuffled channel order, the filters are permuted to match
+	//3x3 F32 layers with padding 1 and stride 1 or 2 run on Depthwise3x3, the others on NEDepthwiseConvolutionLayer
+	IFunction * DWConvolutionLayer(Tensor * input, Tensor * output, int stride, int padding, const std::string &base_filename,
+								   const ActivationLayerInfo &act_info = ActivationLayerInfo(), int shuffle = 0);
+	
+	IFunction * DWConvolutionBNLayer(Tensor * input, Tensor * output, int stride, int padding, const std::string &npy_filename,
+									 const std::string &bn_filename, const ActivationLayerInfo &act_info = ActivationLayerInfo(), int shuffle = 0);
 	
 	NEChannelShuffleLayer * CSLayer(Tensor *input, Tensor *output, int num_groups);
 	
 	NEArithmeticAddition * ElementAddOp(Tensor * input1, Tensor * input2, Tensor * output);
 	
+	//act(BN(input) + residual) in one pass, the tail of a residual block, F32 or F16 only
+	//The BN is the identity when bn_filename is empty, only clamping activations (ReLU and its bounded forms) can be fused
+	FusedEpilogue * ResidualAddOp(Tensor * input, Tensor * residual, Tensor * output, const ActivationLayerInfo &act_info, const std::string &bn_filename = "");
+	
+	//In-place when output is nullptr
+	NEActivationLayer * ActivationOp(Tensor * input, Tensor * output, const ActivationLayerInfo &act_info);
+	
 	NEReshapeLayer	* ReshapeOp(Tensor * input, Tensor * output);
 	
 	NETranspose * TransposeOp(Tensor * input, Tensor * output);
@@ -47,6 +105,14 @@ namespace opWrapper{
 	
 	NEFullyConnectedLayer * FullyConnectedLayer(Tensor * input, Tensor * output, const std::string &base_filename);
 	
+	//F32 to QASYMM8 with the quantization of output, and back
+	NEQuantizationLayer * QuantizeOp(Tensor * input, Tensor * output);
+	
+	NEDequantizationLayer * DequantizeOp(Tensor * input, Tensor * output);
+	
+	//F16 to F32 and back, the type of output must be set by the caller
+	NEDepthConvertLayer * CastOp(Tensor * input, Tensor * output);
+	
 	
 	
 	//NEPermute * PermuteOp(Tensor *input, Tensor *output, PermutationVector &perm);
@@ -0,0 +1,324 @@
+#include "opWrapper_avx2.h"
+#include "arm_compute/core/Error.h"
+
+#include <cstring>
+
+namespace opWrapper{
+
+	//These are Layer Wrappers, as in opWrapper_synthetic.cpp
+	//The weights are created here, the input and output tensor must be handled outside
+
+	Tensor * configure1DTensor(const int dim0, DataType data_type){
+		Tensor * ts = newParameter();
+		ts->allocator()->init(TensorInfo(TensorShape(dim0), 1, data_type));
+		return ts;
+	}
+	Tensor * configure2DTensor(const int dim0, const int dim1, DataType data_type){
+		Tensor * ts = newParameter();
+		ts->allocator()->init(TensorInfo(TensorShape(dim0, dim1), 1, data_type));
+		return ts;
+	}
+	Tensor * configure3DTensor(const int dim0, const int dim1, const int dim2, DataType data_type){
+		Tensor * ts = newParameter();
+		ts->allocator()->init(TensorInfo(TensorShape(dim0, dim1, dim2), 1, data_type));
+		return ts;
+	}
+	Tensor * configure4DTensor(const int dim0, const int dim1, const int dim2, const int dim3, DataType data_type){
+		Tensor * ts = new Tensor();
+		ts->allocator()->init(TensorInfo(TensorShape(dim0, dim1, dim2, dim3), 1, data_type));
+		return ts;
+	}
+
+	static Tensor * syntheticWeights(const TensorShape &shape, const ITensor * input){
+		if(input->info()->data_type() != DataType::F32)
+		{
+			ARM_COMPUTE_ERROR("The AVX2 backend only runs F32, build the network without quantize and fp16");
+		}
+		Tensor * weights = newParameter();
+		weights->allocator()->init(TensorInfo(shape, 1, DataType::F32));
+		return weights;
+	}
+
+	//Whatever the allocator hands back could hold denormals, which are slow on x86
+	static void allocateZeroed(Tensor * tensor){
+		tensor->allocator()->allocate();
+		memset(tensor->buffer(), 0, tensor->info()->total_size());
+	}
+
+	static IFunction * convolution(ITensor * input, const ITensor * weights, const ITensor * biases, ITensor * output,
+								   int stride, int padding, const ActivationLayerInfo &act_info){
+		AVX2ConvolutionKernel * kernel = new AVX2ConvolutionKernel();
+		kernel->configure(input, weights, biases, output, PadStrideInfo(stride, stride, padding, padding), act_info);
+		return new AVX2Function(kernel);
+	}
+
+	static IFunction * depthwise(Tensor * input, Tensor * output, int stride, int padding, int w_h, int w_w, int w_c, bool bias,
+								 const ActivationLayerInfo &act_info){
+		Tensor * weights = syntheticWeights(TensorShape(w_h, w_w, w_c), input);
+		Tensor * biases = bias ? syntheticWeights(TensorShape(w_c), input) : nullptr;
+
+		IFunction * dwcl = nullptr;
+		if(isDepthwise3x3(input, weights, stride, padding, act_info))
+		{
+			Depthwise3x3 * dw = new Depthwise3x3();
+			dw->configure(input, weights, biases, output, stride, act_info);
+			dwcl = dw;
+		}
+		else
+		{
+			AVX2DepthwiseKernel * kernel = new AVX2DepthwiseKernel();
+			kernel->configure(input, weights, biases, output, PadStrideInfo(stride, stride, padding, padding), act_info);
+			dwcl = new AVX2Function(kernel);
+		}
+
+		allocateZeroed(weights);
+		if(biases != nullptr)
+		{
+			allocateZeroed(biases);
+		}
+		allocateOutput(output);
+		return dwcl;
+	}
+
+	static IFunction * channelCopy(const std::vector<ChannelCopy> &copies){
+		AVX2ChannelCopyKernel * kernel = new AVX2ChannelCopyKernel();
+		kernel->configure(copies);
+		return new AVX2Function(kernel);
+	}
+
+	IFunction * ConvolutionLayer(Tensor * input, Tensor * output, int stride, int padding, int w_h, int w_w, int w_d, int w_c, const ActivationLayerInfo &act_info){
+		Tensor * weights = syntheticWeights(TensorShape(w_h, w_w, w_d, w_c), input);
+
+		IFunction * conv = convolution(input, weights, nullptr, output, stride, padding, act_info);
+
+		allocateZeroed(weights);
+		allocateOutput(output);
+		return conv;
+	}
+
+	IFunction * ConvolutionBNLayer(Tensor * input, Tensor * output, int stride, int padding, int w_h, int w_w, int w_d, int w_c, const ActivationLayerInfo &act_info){
+		Tensor * weights = syntheticWeights(TensorShape(w_h, w_w, w_d, w_c), input);
+		Tensor * biases = syntheticWeights(TensorShape(w_c), input);
+
+		IFunction * conv = convolution(input, weights, biases, output, stride, padding, act_info);
+
+		allocateZeroed(weights);
+		allocateZeroed(biases);
+		allocateOutput(output);
+		return conv;
+	}
+
+	GroupedConvolution * GroupedConvolutionLayer(Tensor * input, Tensor * output, int stride, int padding, int w_h, int w_w, int groups,
+												 bool bias, const ActivationLayerInfo &act_info, int shuffle){
+
+		if(output->info()->total_size() == 0)
+		{
+			ARM_COMPUTE_ERROR("The output of a grouped convolution must be initialised");
+		}
+		if(groups < 1 || input->info()->dimension(2) % groups != 0 || output->info()->dimension(2) % groups != 0)
+		{
+			ARM_COMPUTE_ERROR("The channels of a grouped convolution are not divisible by its %d groups", groups);
+		}
+		if(shuffle > 0 && shuffle != groups)
+		{
+			ARM_COMPUTE_ERROR("A folded shuffle must have the groups of the convolution");
+		}
+		const int in_channels = input->info()->dimension(2) / groups;
+		const int out_channels = output->info()->dimension(2) / groups;
+
+		GroupedConvolution * grouped = new GroupedConvolution();
+		std::vector<Tensor *> parameters;
+		for(int g = 0; g < groups; g++)
+		{
+			Tensor * weights = syntheticWeights(TensorShape(w_h, w_w, in_channels, out_channels), input);
+			Tensor * biases = bias ? syntheticWeights(TensorShape(out_channels), input) : nullptr;
+			ITensor * group_output = shuffle > 0 ? grouped->view(output, g, out_channels, groups) : grouped->view(output, g * out_channels, out_channels);
+			grouped->add(convolution(grouped->view(input, g * in_channels, in_channels), weights, biases, group_output, stride, padding, act_info));
+			parameters.push_back(weights);
+			if(biases != nullptr)
+			{
+				parameters.push_back(biases);
+			}
+		}
+
+		for(size_t p = 0; p < parameters.size(); p++)
+		{
+			allocateZeroed(parameters[p]);
+		}
+		grouped->extendParents();
+		allocateOutput(output);
+		return grouped;
+	}
+
+	IFunction * MaxPoolLayer(Tensor * input, Tensor * output, int poolsize, int stride, int padding){
+		return PoolLayer(input, output, PoolingType::MAX, poolsize, stride, padding);
+	}
+
+	IFunction * PoolLayer(Tensor * input, Tensor * output, PoolingType type, int poolsize, int stride, int padding){
+		AVX2PoolingKernel * kernel = new AVX2PoolingKernel();
+		kernel->configure(input, output, type, poolsize, stride, padding);
+		allocateOutput(output);
+		return new AVX2Function(kernel);
+	}
+
+	IFunction * BNLayer(Tensor * input, Tensor * output, int v, const ActivationLayerInfo &act_info){
+		Tensor * mean = configure1DTensor(v);
+		Tensor * var = configure1DTensor(v);
+		Tensor * gamma = configure1DTensor(v);
+		Tensor * beta = configure1DTensor(v);
+
+		AVX2BatchNormalization * bnl = new AVX2BatchNormalization();
+		bnl->configure(input, output, mean, var, beta, gamma, 0.001f, act_info);
+
+		allocateZeroed(mean);
+		allocateZeroed(var);
+		allocateZeroed(gamma);
+		allocateZeroed(beta);
+		allocateOutput(output);
+		return bnl;
+	}
+
+	IFunction * DWConvolutionLayer(Tensor * input, Tensor * output, int stride, int padding, int w_h, int w_w, int w_c, const ActivationLayerInfo &act_info){
+		return depthwise(input, output, stride, padding, w_h, w_w, w_c, false, act_info);
+	}
+
+	IFunction * DWConvolutionBNLayer(Tensor * input, Tensor * output, int stride, int padding, int w_h, int w_w, int w_c, const ActivationLayerInfo &act_info){
+		return depthwise(input, output, stride, padding, w_h, w_w, w_c, true, act_info);
+	}
+
+	//Input channel c = group * K + i goes to output channel i * num_groups + group, K channels per group, as NEChannelShuffleLayer
+	IFunction * CSLayer(Tensor * input, Tensor * output, int num_groups)
+	{
+		const int channels = input->info()->dimension(2);
+		const int group_channels = channels / num_groups;
+		if(output->info()->total_size() == 0)
+		{
+			output->allocator()->init(TensorInfo(input->info()->tensor_shape(), 1, input->info()->data_type()));
+		}
+		std::vector<ChannelCopy> copies;
+		for(int c = 0; c < channels; c++)
+		{
+			copies.push_back({ input, c, output, (c % group_channels) * num_groups + c / group_channels });
+		}
+		IFunction * csl = channelCopy(copies);
+		allocateOutput(output);
+		return csl;
+	}
+
+	FusedEpilogue * ElementAddOp(Tensor * input1, Tensor * input2, Tensor * output)
+	{
+		return ResidualAddOp(input1, input2, output, ActivationLayerInfo(), false);
+	}
+
+	FusedEpilogue * ResidualAddOp(Tensor * input, Tensor * residual, Tensor * output, const ActivationLayerInfo &act_info, bool bn)
+	{
+		if(output->info()->total_size() == 0)
+		{
+			output->allocator()->init(TensorInfo(input->info()->tensor_shape(), 1, input->info()->data_type()));
+		}
+		const size_t channels = input->info()->dimension(2);
+		FusedEpilogue * epilogue = new FusedEpilogue();
+		epilogue->configure(input, residual, output, std::vector<float>(bn ? channels : 0, 1.f), std::vector<float>(bn ? channels : 0, 0.f), act_info);
+		allocateOutput(output);
+		return epilogue;
+	}
+
+	IFunction * ActivationOp(Tensor * input, Tensor * output, const ActivationLayerInfo &act_info)
+	{
+		AVX2ChannelAffineKernel * kernel = new AVX2ChannelAffineKernel();
+		kernel->configure(input, output, nullptr, nullptr, act_info);
+		if(output != nullptr)
+		{
+			allocateOutput(output);
+		}
+		return new AVX2Function(kernel);
+	}
+
+	IFunction * ConcatLayer(std::vector<ITensor *> inputs_vector, Tensor * output)
+	{
+		const TensorShape &first = inputs_vector[0]->info()->tensor_shape();
+		std::vector<ChannelCopy> copies;
+		int channels = 0;
+		for(size_t i = 0; i < inputs_vector.size(); i++)
+		{
+			for(size_t c = 0; c < inputs_vector[i]->info()->dimension(2); c++)
+			{
+				copies.push_back({ inputs_vector[i], static_cast<int>(c), output, channels++ });
+			}
+		}
+		if(output->info()->total_size() == 0)
+		{
+			output->allocator()->init(TensorInfo(TensorShape(first[0], first[1], channels, first[3]), 1, inputs_vector[0]->info()->data_type()));
+		}
+		IFunction * cc = channelCopy(copies);
+		allocateOutput(output);
+		return cc;
+	}
+
+	//Equal parts of the input channels, the outputs are allocated by the caller
+	IFunction * SplitLayer(Tensor * input, std::vector<ITensor *> outputs, unsigned int axis)
+	{
+		if(axis != 2)
+		{
+			ARM_COMPUTE_ERROR("The AVX2 backend only splits channels");
+		}
+		TensorShape shape = input->info()->tensor_shape();
+		const int channels = shape[2] / outputs.size();
+		shape.set(2, channels);
+		std::vector<ChannelCopy> copies;
+		for(size_t o = 0; o < outputs.size(); o++)
+		{
+			auto_init_if_empty(*outputs[o]->info(), shape, 1, input->info()->data_type());
+			for(int c = 0; c < channels; c++)
+			{
+				copies.push_back({ input, static_cast<int>(o) * channels + c, outputs[o], c });
+			}
+		}
+		return channelCopy(copies);
+	}
+
+	IFunction * ReduceMeanLayer(Tensor * input, Tensor * output, Coordinates reduction_axis)
+	{
+		if(reduction_axis.num_dimensions() != 2 || reduction_axis[0] != 0 || reduction_axis[1] != 1)
+		{
+			ARM_COMPUTE_ERROR("The AVX2 backend only reduces over width and height");
+		}
+		AVX2ReduceMeanKernel * kernel = new AVX2ReduceMeanKernel();
+		kernel->configure(input, output);
+		allocateOutput(output);
+		return new AVX2Function(kernel);
+	}
+
+	IFunction * FullyConnectedLayer(Tensor * input, Tensor * output, int in, int out)
+	{
+		Tensor * weights = syntheticWeights(TensorShape(in, out), input);
+		Tensor * biases = syntheticWeights(TensorShape(out), input);
+
+		AVX2FullyConnectedKernel * kernel = new AVX2FullyConnectedKernel();
+		kernel->configure(input, weights, biases, output);
+
+		allocateZeroed(weights);
+		allocateZeroed(biases);
+		allocateOutput(output);
+		return new AVX2Function(kernel);
+	}
+
+	IFunction * QuantizeOp(Tensor * input, Tensor * output)
+	{
+		ARM_COMPUTE_ERROR("QASYMM8 is not in the AVX2 backend");
+		return nullptr;
+	}
+
+	IFunction * DequantizeOp(Tensor * input, Tensor * output)
+	{
+		ARM_COMPUTE_ERROR("QASYMM8 is not in the AVX2 backend");
+		return nullptr;
+	}
+
+	IFunction * CastOp(Tensor * input, Tensor * output)
+	{
+		ARM_COMPUTE_ERROR("F16 is not in the AVX2 backend");
+		return nullptr;
+	}
+
+ }
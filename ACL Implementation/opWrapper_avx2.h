@@ -0,0 +1,81 @@
+#ifndef OPWRAPPER
+#define OPWRAPPER
+
+#include "arm_compute/core/Types.h"
+#include "arm_compute/runtime/IFunction.h"
+#include "arm_compute/runtime/Tensor.h"
+#include "memoryPlanner.h"
+#include "groupedConvolution.h"
+#include "fusedEpilogue.h"
+#include "avx2Kernels.h"
+#include "depthwise3x3.h"
+#include <string>
+#include <vector>
+
+using namespace arm_compute;
+
+namespace opWrapper{
+
+	//The layer wrappers of opWrapper_synthetic.h for x86-64, on the kernels of avx2Kernels.h
+	//ACL builds no NEON functions for x86, only its tensors, scheduler and memory managers are used here
+	//Same signatures and synthetic weights, zero filled; every layer is F32 and returned as an IFunction
+	//QASYMM8 and F16 networks cannot be lowered with this backend, neither can the convolution tuner
+	Tensor * configure1DTensor(int dim0, DataType data_type = DataType::F32);
+	Tensor * configure2DTensor(int dim0, int dim1, DataType data_type = DataType::F32);
+	Tensor * configure3DTensor(int dim0, int dim1, int dim2, DataType data_type = DataType::F32);
+	//configure1D-3DTensor make parameters, which go to the parameter owner while one is set (see newParameter())
+	//configure4DTensor makes an activation, which the caller always owns
+	//NCHW activations of a batch are (W, H, C, N)
+	Tensor * configure4DTensor(int dim0, int dim1, int dim2, int dim3, DataType data_type = DataType::F32);
+	IFunction * ConvolutionLayer(Tensor * input, Tensor * output,
+								 int stride, int padding,
+								 int w_h, int w_w, int w_d, int w_c,
+								 const ActivationLayerInfo &act_info = ActivationLayerInfo(ActivationLayerInfo::ActivationFunction::RELU));
+	IFunction * ConvolutionBNLayer(Tensor * input, Tensor * output, int stride, int padding,
+								   int w_h, int w_w, int w_d, int w_c,
+								   const ActivationLayerInfo &act_info = ActivationLayerInfo());
+	//Grouped convolution on channel views of input and output, output must be initialised already
+	GroupedConvolution * GroupedConvolutionLayer(Tensor * input, Tensor * output, int stride, int padding, int w_h, int w_w, int groups,
+												 bool bias, const ActivationLayerInfo &act_info = ActivationLayerInfo(), int shuffle = 0);
+	IFunction * MaxPoolLayer(Tensor * input, Tensor * output, int poolsize, int stride, int padding = 0);
+
+	IFunction * PoolLayer(Tensor * input, Tensor * output, PoolingType type, int poolsize, int stride, int padding);
+
+	IFunction * BNLayer(Tensor * input, Tensor * output, int v, const ActivationLayerInfo &act_info = ActivationLayerInfo());
+
+	//3x3 layers with padding 1 and stride 1 or 2 run on Depthwise3x3, the others on AVX2DepthwiseKernel
+	IFunction * DWConvolutionLayer(Tensor * input, Tensor * output, int stride, int padding, int w_h, int w_w, int w_c, const ActivationLayerInfo &act_info = ActivationLayerInfo());
+
+	IFunction * DWConvolutionBNLayer(Tensor * input, Tensor * output, int stride, int padding, int w_h, int w_w, int w_c, const ActivationLayerInfo &act_info = ActivationLayerInfo());
+
+	IFunction * CSLayer(Tensor *input, Tensor *output, int num_groups);
+
+	//The fused epilogue without BN or activation
+	FusedEpilogue * ElementAddOp(Tensor * input1, Tensor * input2, Tensor * output);
+
+	FusedEpilogue * ResidualAddOp(Tensor * input, Tensor * residual, Tensor * output, const ActivationLayerInfo &act_info, bool bn = false);
+
+	//In-place when output is nullptr, only clamping activations
+	IFunction * ActivationOp(Tensor * input, Tensor * output, const ActivationLayerInfo &act_info);
+
+	//Along the channels only
+	IFunction * ConcatLayer(std::vector<ITensor *> inputs_vector, Tensor *output);
+
+	IFunction * SplitLayer(Tensor * input, std::vector<ITensor *> outputs, unsigned int axis);
+
+	//Over width and height only
+	IFunction * ReduceMeanLayer(Tensor * input, Tensor * output, Coordinates reduction_axis);
+
+	IFunction * FullyConnectedLayer(Tensor * input, Tensor * output, int in, int out);
+
+	//Not in this backend, they fail
+	IFunction * QuantizeOp(Tensor * input, Tensor * output);
+
+	IFunction * DequantizeOp(Tensor * input, Tensor * output);
+
+	IFunction * CastOp(Tensor * input, Tensor * output);
+
+ }
+
+
+#endif
@@ -7,44 +7,79 @@ namespace opWrapper{
 	//They can automatically configure weights and add memory manager
 	//However the input and output tensor must be handled outside
 	 
-	Tensor * configure1DTensor(const int dim0){
+	Tensor * configure1DTensor(const int dim0, DataType data_type){
 		const TensorShape ts_shape(dim0);		
-		Tensor * ts = new Tensor();
-		ts->allocator()->init(TensorInfo(ts_shape, 1, DataType::F32));
+		Tensor * ts = newParameter();
+		ts->allocator()->init(TensorInfo(ts_shape, 1, data_type));
 		return ts;
 	}	
-	Tensor * configure2DTensor(const int dim0, const int dim1){
+	Tensor * configure2DTensor(const int dim0, const int dim1, DataType data_type){
 		const TensorShape ts_shape(dim0, dim1);		
-		Tensor * ts = new Tensor();
-		ts->allocator()->init(TensorInfo(ts_shape, 1, DataType::F32));
+		Tensor * ts = newParameter();
+		ts->allocator()->init(TensorInfo(ts_shape, 1, data_type));
 		return ts;
 	}	
-	Tensor * configure3DTensor(const int dim0, const int dim1, const int dim2){
+	Tensor * configure3DTensor(const int dim0, const int dim1, const int dim2, DataType data_type){
 		const TensorShape ts_shape(dim0, dim1, dim2);		
-		Tensor * ts = new Tensor();
-		ts->allocator()->init(TensorInfo(ts_shape, 1, DataType::F32));
+		Tensor * ts = newParameter();
+		ts->allocator()->init(TensorInfo(ts_shape, 1, data_type));
 		return ts;
 	}	
-	Tensor * configure4DTensor(const int dim0, const int dim1, const int dim2, const int dim3){
+	Tensor * configure4DTensor(const int dim0, const int dim1, const int dim2, const int dim3, DataType data_type){
 		const TensorShape ts_shape(dim0, dim1, dim2, dim3);		
 		Tensor * ts = new Tensor();
-		ts->allocator()->init(TensorInfo(ts_shape, 1, DataType::F32));
+		ts->allocator()->init(TensorInfo(ts_shape, 1, data_type));
 		return ts;
 	}		
 	
 	
 	
+	static bool isQuantized(const ITensor * tensor){
+		return is_data_type_quantized_asymmetric(tensor->info()->data_type());
+	}
+	
+	static DataType floatType(const ITensor * input){
+		return input->info()->data_type() == DataType::F16 ? DataType::F16 : DataType::F32;
+	}
+	
+	//Parameters follow the input: QASYMM8 weights and S32 biases for a quantized layer, F16 for a F16 layer, F32 otherwise
+	static Tensor * syntheticWeights(const TensorShape &shape, const ITensor * input){
+		Tensor * weights = newParameter();
+		if(isQuantized(input))
+		{
+			weights->allocator()->init(TensorInfo(shape, 1, DataType::QASYMM8, QuantizationInfo(1.f / 128, 128)));
+		}
+		else
+		{
+			weights->allocator()->init(TensorInfo(shape, 1, floatType(input)));
+		}
+		return weights;
+	}
+	
+	static Tensor * syntheticBiases(int channels, const ITensor * input){
+		Tensor * biases = newParameter();
+		if(isQuantized(input))
+		{
+			//Bias scale is input scale * weight scale, the accumulators are added to it directly
+			const float scale = input->info()->quantization_info().uniform().scale / 128;
+			biases->allocator()->init(TensorInfo(TensorShape(channels), 1, DataType::S32, QuantizationInfo(scale, 0)));
+		}
+		else
+		{
+			biases->allocator()->init(TensorInfo(TensorShape(channels), 1, floatType(input)));
+		}
+		return biases;
+	}
+	
 	// Delete the FilePath and the Weight tensor need to be create by hand
-	NEConvolutionLayer * ConvolutionLayer(Tensor * input,Tensor * output, int stride, int padding, int w_h, int w_w, int w_d, int w_c){ 
+	IFunction * ConvolutionLayer(Tensor * input,Tensor * output, int stride, int padding, int w_h, int w_w, int w_d, int w_c, const ActivationLayerInfo &act_info){ 
 		
-		Tensor * weights = configure4DTensor(w_h, w_w, w_d, w_c);		
+		Tensor * weights = syntheticWeights(TensorShape(w_h, w_w, w_d, w_c), input);		
 		
-		NEConvolutionLayer * conv = new NEConvolutionLayer();
-		conv->configure(input, weights, nullptr, output, PadStrideInfo(stride, stride, padding, padding), WeightsInfo(),
-             Size2D(1U, 1U), ActivationLayerInfo(ActivationLayerInfo::ActivationFunction::RELU));				
+		IFunction * conv = newConvolution(input, weights, nullptr, output, PadStrideInfo(stride, stride, padding, padding), act_info);
 				
 		weights->allocator()->allocate();
-		output->allocator()->allocate();	
+		allocateOutput(output);	
 		
 	
 		 // std::cout<<output->info()->tensor_shape()[0]<<std::endl;
@@ -57,20 +92,84 @@ namespace opWrapper{
 		return conv;
 	}
 	
-	NEPoolingLayer * MaxPoolLayer(Tensor * input, Tensor * output, int poolsize, int stride){		
+	IFunction * ConvolutionBNLayer(Tensor * input, Tensor * output, int stride, int padding, int w_h, int w_w, int w_d, int w_c, const ActivationLayerInfo &act_info){
+		
+		Tensor * weights = syntheticWeights(TensorShape(w_h, w_w, w_d, w_c), input);
+		Tensor * biases = syntheticBiases(w_c, input);
+		
+		IFunction * conv = newConvolution(input, weights, biases, output, PadStrideInfo(stride, stride, padding, padding), act_info);
+		
+		weights->allocator()->allocate();
+		biases->allocator()->allocate();
+		allocateOutput(output);
+		
+		return conv;
+	}
+	
+	GroupedConvolution * GroupedConvolutionLayer(Tensor * input, Tensor * output, int stride, int padding, int w_h, int w_w, int groups,
+												 bool bias, const ActivationLayerInfo &act_info, int shuffle){
+		
+		if(output->info()->total_size() == 0)
+		{
+			ARM_COMPUTE_ERROR("The output of a grouped convolution must be initialised");
+		}
+		if(groups < 1 || input->info()->dimension(2) % groups != 0 || output->info()->dimension(2) % groups != 0)
+		{
+			ARM_COMPUTE_ERROR("The channels of a grouped convolution are not divisible by its %d groups", groups);
+		}
+		if(shuffle > 0 && shuffle != groups)
+		{
+			ARM_COMPUTE_ERROR("A folded shuffle must have the groups of the convolution");
+		}
+		const int in_channels = input->info()->dimension(2) / groups;
+		const int out_channels = output->info()->dimension(2) / groups;
+		
+		GroupedConvolution * grouped = new GroupedConvolution();
+		std::vector<Tensor *> parameters;
+		for(int g = 0; g < groups; g++)
+		{
+			Tensor * weights = syntheticWeights(TensorShape(w_h, w_w, in_channels, out_channels), input);
+			Tensor * biases = bias ? syntheticBiases(out_channels, input) : nullptr;
+			ITensor * group_output = shuffle > 0 ? grouped->view(output, g, out_channels, groups) : grouped->view(output, g * out_channels, out_channels);
+			grouped->add(newConvolution(grouped->view(input, g * in_channels, in_channels), weights, biases,
+										group_output, PadStrideInfo(stride, stride, padding, padding), act_info));
+			parameters.push_back(weights);
+			if(biases != nullptr)
+			{
+				parameters.push_back(biases);
+			}
+		}
+		
+		for(size_t p = 0; p < parameters.size(); p++)
+		{
+			parameters[p]->allocator()->allocate();
+		}
+		grouped->extendParents();
+		allocateOutput(output);
+		return grouped;
+	}
+	
+	NEPoolingLayer * MaxPoolLayer(Tensor * input, Tensor * output, int poolsize, int stride, int padding){		
 		NEPoolingLayer * pool = new NEPoolingLayer();
-		pool->configure(input, output, PoolingLayerInfo(PoolingType::MAX, poolsize, PadStrideInfo(2, 2, 0, 0)));
-		output->allocator()->allocate();
+		pool->configure(input, output, PoolingLayerInfo(PoolingType::MAX, poolsize, PadStrideInfo(stride, stride, padding, padding)));
+		allocateOutput(output);
 		//std::cout<<output->info()->tensor_shape()[0]<<std::endl;
 		return pool; 
 	}
 	
-	NEBatchNormalizationLayer * BNLayer(Tensor * input, Tensor * output, int v){		
+	NEPoolingLayer * PoolLayer(Tensor * input, Tensor * output, PoolingType type, int poolsize, int stride, int padding){
+		NEPoolingLayer * pool = new NEPoolingLayer();
+		pool->configure(input, output, PoolingLayerInfo(type, poolsize, PadStrideInfo(stride, stride, padding, padding)));
+		allocateOutput(output);
+		return pool;
+	}
+	
+	NEBatchNormalizationLayer * BNLayer(Tensor * input, Tensor * output, int v, const ActivationLayerInfo &act_info){		
 		
-		Tensor * mean = configure1DTensor(v);
-		Tensor * var = configure1DTensor(v);
-		Tensor * gamma = configure1DTensor(v);
-		Tensor * beta = configure1DTensor(v);
+		Tensor * mean = configure1DTensor(v, floatType(input));
+		Tensor * var = configure1DTensor(v, floatType(input));
+		Tensor * gamma = configure1DTensor(v, floatType(input));
+		Tensor * beta = configure1DTensor(v, floatType(input));
 		
 		/* NPLoader meanLoader;
 		NPLoader varLoader; 
@@ -89,13 +188,13 @@ namespace opWrapper{
 		
 		NEBatchNormalizationLayer * bnl = new NEBatchNormalizationLayer();
 		
-		bnl->configure(input, output, mean, var, beta, gamma, 0.001f);
+		bnl->configure(input, output, mean, var, beta, gamma, 0.001f, act_info);
 		
 		mean->allocator()->allocate();
 		var->allocator()->allocate();
 		gamma->allocator()->allocate();
 		beta->allocator()->allocate();		
-		output->allocator()->allocate();
+		allocateOutput(output);
 		
 		/* if(meanLoader.is_open())
 		{
@@ -143,51 +242,108 @@ namespace opWrapper{
 		
 	
 		
-	NEDepthwiseConvolutionLayer * DWConvolutionLayer(Tensor * input, Tensor * output, int stride, int padding, int w_h, int w_w, int w_c){
+	//Depthwise3x3 where it applies, NEDepthwiseConvolutionLayer otherwise
+	static IFunction * depthwise(Tensor * input, Tensor * weights, Tensor * biases, Tensor * output, int stride, int padding,
+								 const ActivationLayerInfo &act_info){
+		if(isDepthwise3x3(input, weights, stride, padding, act_info))
+		{
+			Depthwise3x3 * dw = new Depthwise3x3();
+			dw->configure(input, weights, biases, output, stride, act_info);
+			return dw;
+		}
+		NEDepthwiseConvolutionLayer * dwcl = new NEDepthwiseConvolutionLayer();
+		dwcl->configure(input, weights, biases, output, PadStrideInfo(stride, stride, padding, padding), 1, act_info);
+		return dwcl;
+	}
+	
+	IFunction * DWConvolutionLayer(Tensor * input, Tensor * output, int stride, int padding, int w_h, int w_w, int w_c, const ActivationLayerInfo &act_info){
 
-		Tensor * weights = configure4DTensor(w_h, w_w, w_c, 1);
+		Tensor * weights = syntheticWeights(TensorShape(w_h, w_w, w_c, 1), input);
 		
-		NEDepthwiseConvolutionLayer * dwcl = new NEDepthwiseConvolutionLayer();
-		dwcl->configure(input, weights, nullptr, output, PadStrideInfo(stride,stride,padding,padding),1);
+		IFunction * dwcl = depthwise(input, weights, nullptr, output, stride, padding, act_info);
 		
 		weights->allocator()->allocate();
-		output->allocator()->allocate();		
+		allocateOutput(output);		
 		
 		
 		return dwcl;
 		
 	}
 	
+	IFunction * DWConvolutionBNLayer(Tensor * input, Tensor * output, int stride, int padding, int w_h, int w_w, int w_c, const ActivationLayerInfo &act_info){
+		
+		Tensor * weights = syntheticWeights(TensorShape(w_h, w_w, w_c, 1), input);
+		Tensor * biases = syntheticBiases(w_c, input);
+		
+		IFunction * dwcl = depthwise(input, weights, biases, output, stride, padding, act_info);
+		
+		weights->allocator()->allocate();
+		biases->allocator()->allocate();
+		allocateOutput(output);
+		
+		return dwcl;
+	}
+	
 	NEChannelShuffleLayer * CSLayer(Tensor *input, Tensor *output, int num_groups)
 	{
 		NEChannelShuffleLayer * csl = new NEChannelShuffleLayer();
 		csl->configure(input, output, num_groups);
 		//output->info()->set_data_layout(DataLayout::NHWC);
-		output->allocator()->allocate();
+		allocateOutput(output);
 		return csl;
 	}
 	
 	NEArithmeticAddition * ElementAddOp(Tensor * input1, Tensor * input2, Tensor * output)
 	{
 		NEArithmeticAddition * eal = new NEArithmeticAddition();		
-		const TensorShape x(input1->info()->tensor_shape()[0],input1->info()->tensor_shape()[1],input1->info()->tensor_shape()[2]);
-		output->allocator()->init(TensorInfo(x,1,DataType::F32));
-		eal->configure(input1, input2, output, ConvertPolicy::SATURATE);
-		output->allocator()->allocate();		
+		//A quantized output is set up by the caller with its calibrated range
+		if(output->info()->total_size() == 0)
+		{
+			output->allocator()->init(TensorInfo(input1->info()->tensor_shape(),1,input1->info()->data_type()));
+		}
+		//Floats never overflow into the policy, only QASYMM8 has to saturate
+		const ConvertPolicy policy = is_data_type_quantized_asymmetric(input1->info()->data_type()) ? ConvertPolicy::SATURATE : ConvertPolicy::WRAP;
+		eal->configure(input1, input2, output, policy);
+		allocateOutput(output);		
 		return eal;
 	}
 	
+	FusedEpilogue * ResidualAddOp(Tensor * input, Tensor * residual, Tensor * output, const ActivationLayerInfo &act_info, bool bn)
+	{
+		if(output->info()->total_size() == 0)
+		{
+			output->allocator()->init(TensorInfo(input->info()->tensor_shape(),1,input->info()->data_type()));
+		}
+		//Random statistics would only change the values, an identity BN costs the same
+		const size_t channels = input->info()->dimension(2);
+		FusedEpilogue * epilogue = new FusedEpilogue();
+		epilogue->configure(input, residual, output, std::vector<float>(bn ? channels : 0, 1.f), std::vector<float>(bn ? channels : 0, 0.f), act_info);
+		allocateOutput(output);
+		return epilogue;
+	}
+	
+	NEActivationLayer * ActivationOp(Tensor * input, Tensor * output, const ActivationLayerInfo &act_info)
+	{
+		NEActivationLayer * act = new NEActivationLayer();
+		act->configure(input, output, act_info);
+		if(output != nullptr)
+		{
+			allocateOutput(output);
+		}
+		return act;
+	}
+	
 	NEReshapeLayer	* ReshapeOp(Tensor * input, Tensor * output){
 		NEReshapeLayer	* rsop = new NEReshapeLayer();
 		rsop->configure(input, output);
-		output->allocator()->allocate();
+		allocateOutput(output);
 		return rsop;
 	}
 	
 	NETranspose * TransposeOp(Tensor * input, Tensor * output){
 		NETranspose * trans = new NETranspose();
 		trans->configure(input, output);
-		output->allocator()->allocate();
+		allocateOutput(output);
 		return trans;
 	}
 	
@@ -195,7 +351,7 @@ namespace opWrapper{
 	{
 		NEConcatenateLayer * cc = new NEConcatenateLayer();
 		cc->configure(inputs_vector, output, 2);
-		output->allocator()->allocate();
+		allocateOutput(output);
 		return cc;
 	}
 	
@@ -214,17 +370,17 @@ namespace opWrapper{
 	
 	NEReduceMean * ReduceMeanLayer(Tensor * input, Tensor * output, Coordinates reduction_axis)
 	{		
-		NEReduceMean * rml = new NEReduceMean();
+		NEReduceMean * rml = new NEReduceMean(memoryManager());
 		rml->configure(input, reduction_axis, true, output);
-		output->allocator()->allocate();
+		allocateOutput(output);
 		return rml;
 	}
 	
 	NEFullyConnectedLayer * FullyConnectedLayer(Tensor * input, Tensor * output, int in, int out)
 	{
-		Tensor * weights = configure2DTensor(in, out);
+		Tensor * weights = syntheticWeights(TensorShape(in, out), input);
 		
-		Tensor * biases = configure1DTensor(out);
+		Tensor * biases = syntheticBiases(out, input);
 		
 		
 		/* std::cout<<weights->info()->tensor_shape()[0]<<std::endl;
@@ -235,10 +391,14 @@ namespace opWrapper{
 		std::cout<<biases->info()->tensor_shape()[1]<<std::endl;
 		std::cout<<biases->info()->tensor_shape()[2]<<std::endl; */
 		
-		TensorShape out_shape(out);
-		output->allocator()-> init(TensorInfo(out_shape, 1, DataType::F32));
+		//One row of scores per image
+		const TensorShape out_shape(out, input->info()->tensor_shape().total_size() / in);
+		if(output->info()->total_size() == 0)
+		{
+			output->allocator()-> init(TensorInfo(out_shape, 1, DataType::F32));
+		}
 		
-		NEFullyConnectedLayer * fcl = new NEFullyConnectedLayer();
+		NEFullyConnectedLayer * fcl = new NEFullyConnectedLayer(memoryManager());
 		fcl->configure(input, weights, biases, output);
 		
 		/* std::cout<<output->info()->tensor_shape()[0]<<std::endl;
@@ -247,7 +407,7 @@ namespace opWrapper{
 		
 		weights->allocator()->allocate();
 		biases->allocator()->allocate();
-		output->allocator()->allocate();
+		allocateOutput(output);
 		
 		
 		return fcl;
@@ -255,6 +415,30 @@ namespace opWrapper{
 	
 	
 	
+	NEQuantizationLayer * QuantizeOp(Tensor * input, Tensor * output)
+	{
+		NEQuantizationLayer * quant = new NEQuantizationLayer();
+		quant->configure(input, output);
+		allocateOutput(output);
+		return quant;
+	}
+	
+	NEDequantizationLayer * DequantizeOp(Tensor * input, Tensor * output)
+	{
+		NEDequantizationLayer * dequant = new NEDequantizationLayer();
+		dequant->configure(input, output);
+		allocateOutput(output);
+		return dequant;
+	}
+	
+	NEDepthConvertLayer * CastOp(Tensor * input, Tensor * output)
+	{
+		NEDepthConvertLayer * cast = new NEDepthConvertLayer();
+		cast->configure(input, output, ConvertPolicy::SATURATE, 0);
+		allocateOutput(output);
+		return cast;
+	}
+	
 	/* NEPermute * PermuteOp(Tensor *input, Tensor *output, PermutationVector &perm)
 	{
 		NEPermute * pop = new NEPermute();
@@ -8,6 +8,11 @@
 #include "arm_compute/runtime/MemoryManagerOnDemand.h"
 #include "arm_compute/runtime/PoolManager.h"
 #include "utils/Utils.h"
+#include "memoryPlanner.h"
+#include "groupedConvolution.h"
+#include "convTuner.h"
+#include "fusedEpilogue.h"
+#include "depthwise3x3.h"
 #include <string>
 
 using namespace arm_compute;
@@ -18,23 +23,50 @@ namespace opWrapper{
 	//These are Layer Wrappers
 	//They can automatically configure weights and add memory manager
 	//However the input and output tensor must be handled outside
-	Tensor * configure1DTensor(int dim0);
-	Tensor * configure2DTensor(int dim0, int dim1);
-	Tensor * configure3DTensor(int dim0, int dim1, int dim2);		
-	Tensor * configure4DTensor(int dim0, int dim1, int dim2, int dim3);	
-	NEConvolutionLayer * ConvolutionLayer(Tensor * input, Tensor * output,  
-											int stride, int padding, 
-											int w_h, int w_w, int w_d, int w_c);//, const std::string &name
-	NEPoolingLayer * MaxPoolLayer(Tensor * input, Tensor * output, int poolsize, int stride);
-	
-	NEBatchNormalizationLayer * BNLayer(Tensor * input, Tensor * output, int v);
-	
-	NEDepthwiseConvolutionLayer * DWConvolutionLayer(Tensor * input, Tensor * output, int stride, int padding,  int w_h, int w_w, int w_c);
+	//A layer whose input is QASYMM8 gets QASYMM8 weights and S32 biases, the output tensor must carry its quantization already
+	Tensor * configure1DTensor(int dim0, DataType data_type = DataType::F32);
+	Tensor * configure2DTensor(int dim0, int dim1, DataType data_type = DataType::F32);
+	Tensor * configure3DTensor(int dim0, int dim1, int dim2, DataType data_type = DataType::F32);		
+	//configure1D-3DTensor make parameters, which go to the parameter owner while one is set (see newParameter())
+	//configure4DTensor makes an activation, which the caller always owns
+	//NCHW activations of a batch are (W, H, C, N)
+	Tensor * configure4DTensor(int dim0, int dim1, int dim2, int dim3, DataType data_type = DataType::F32);	
+	IFunction * ConvolutionLayer(Tensor * input, Tensor * output,  
+								 int stride, int padding, 
+								 int w_h, int w_w, int w_d, int w_c,
+								 const ActivationLayerInfo &act_info = ActivationLayerInfo(ActivationLayerInfo::ActivationFunction::RELU));//, const std::string &name
+	//Convolution with a batch norm folded into it, only the bias is added here since the weights are not loaded
+	IFunction * ConvolutionBNLayer(Tensor * input, Tensor * output, int stride, int padding,
+								   int w_h, int w_w, int w_d, int w_c,
+								   const ActivationLayerInfo &act_info = ActivationLayerInfo());
+	//Grouped convolution on channel views of input and output, output must be initialised already
+	//bias adds the bias of a folded BN, shuffle interleaves the groups in the output as a folded channel shuffle would
+	//The dense and depthwise factories need no shuffle argument, their synthetic weights are never loaded
+	GroupedConvolution * GroupedConvolutionLayer(Tensor * input, Tensor * output, int stride, int padding, int w_h, int w_w, int groups,
+												 bool bias, const ActivationLayerInfo &act_info = ActivationLayerInfo(), int shuffle = 0);
+	NEPoolingLayer * MaxPoolLayer(Tensor * input, Tensor * output, int poolsize, int stride, int padding = 0);
+	
+	NEPoolingLayer * PoolLayer(Tensor * input, Tensor * output, PoolingType type, int poolsize, int stride, int padding);
+	
+	NEBatchNormalizationLayer * BNLayer(Tensor * input, Tensor * output, int v, const ActivationLayerInfo &act_info = ActivationLayerInfo());
+	
+	//3x3 F32 layers with padding 1 and stride 1 or 2 run on Depthwise3x3, the others on NEDepthwiseConvolutionLayer
+	IFunction * DWConvolutionLayer(Tensor * input, Tensor * output, int stride, int padding,  int w_h, int w_w, int w_c, const ActivationLayerInfo &act_info = ActivationLayerInfo());
+	
+	//Depthwise convolution with a batch norm folded into it, only the bias is added here
+	IFunction * DWConvolutionBNLayer(Tensor * input, Tensor * output, int stride, int padding, int w_h, int w_w, int w_c, const ActivationLayerInfo &act_info = ActivationLayerInfo());
 	
 	NEChannelShuffleLayer * CSLayer(Tensor *input, Tensor *output, int num_groups);
 	
 	NEArithmeticAddition * ElementAddOp(Tensor * input1, Tensor * input2, Tensor * output);
 	
+	//act(BN(input) + residual) in one pass, the tail of a residual block, F32 or F16 only
+	//The BN is the identity when bn is false, only clamping activations (ReLU and its bounded forms) can be fused
+	FusedEpilogue * ResidualAddOp(Tensor * input, Tensor * residual, Tensor * output, const ActivationLayerInfo &act_info, bool bn = false);
+	
+	//In-place when output is nullptr
+	NEActivationLayer * ActivationOp(Tensor * input, Tensor * output, const ActivationLayerInfo &act_info);
+	
 	NEReshapeLayer	* ReshapeOp(Tensor * input, Tensor * output);
 	
 	NETranspose * TransposeOp(Tensor * input, Tensor * output);
@@ -47,6 +79,14 @@ namespace opWrapper{
 	
 	NEFullyConnectedLayer * FullyConnectedLayer(Tensor * input, Tensor * output, int in, int out);
 	
+	//F32 to QASYMM8 with the quantization of output, and back
+	NEQuantizationLayer * QuantizeOp(Tensor * input, Tensor * output);
+	
+	NEDequantizationLayer * DequantizeOp(Tensor * input, Tensor * output);
+	
+	//F16 to F32 and back, the type of output must be set by the caller
+	NEDepthConvertLayer * CastOp(Tensor * input, Tensor * output);
+	
 	
 	
 	//NEPermute * PermuteOp(Tensor *input, Tensor *output, PermutationVector &perm);
@@ -0,0 +1,71 @@
+#include "weightBundle.h"
+#include "dataLoader.h"
+#include "arm_compute/runtime/Tensor.h"
+
+#include <algorithm>
+#include <dirent.h>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace arm_compute;
+using namespace utils;
+using namespace std;
+
+//Offline converter: loads every NPY dump of a directory exactly like the opWrapper factories do
+//and writes them into one aligned bundle that the engine can mmap at startup
+int main (int argc, char **argv)
+{
+	if(argc != 3)
+	{
+		std::cout<<"Usage: ./pack_weights [npy directory] [bundle file]"<<std::endl;
+		return 0;
+	}
+	string directory = argv[1];
+	if(directory.empty() || directory[directory.size() - 1] != '/')
+	{
+		directory += "/";
+	}
+
+	vector<string> files;
+	DIR * dir = opendir(directory.c_str());
+	if(dir == nullptr)
+	{
+		std::cout<<"Cannot open "<<directory<<std::endl;
+		return 1;
+	}
+	for(struct dirent * entry = readdir(dir); entry != nullptr; entry = readdir(dir))
+	{
+		const string name = entry->d_name;
+		if(name.size() > 4 && name.compare(name.size() - 4, 4, ".npy") == 0)
+		{
+			files.push_back(name);
+		}
+	}
+	closedir(dir);
+	std::sort(files.begin(), files.end());
+
+	vector<unique_ptr<Tensor>> tensors;
+	vector<pair<string, const ITensor *>> entries;
+	size_t bytes = 0;
+	for(size_t i = 0; i < files.size(); i++)
+	{
+		//Same layout conversion as the factories, the bundle holds the final tensor bytes
+		unique_ptr<Tensor> tensor(new Tensor());
+		NPLoader loader;
+		loader.open(directory + files[i], DataLayout::NHWC);
+		loader.init_tensor(*tensor, DataType::F32);
+		tensor->allocator()->allocate();
+		loader.fill_tensor(*tensor);
+		loader.close();
+
+		bytes += tensor->info()->total_size();
+		entries.push_back(make_pair(opWrapper::bundleKey(files[i]), tensor.get()));
+		tensors.push_back(std::move(tensor));
+	}
+
+	opWrapper::writeWeightBundle(argv[2], entries);
+	std::cout<<"Packed "<<entries.size()<<" tensors, "<<bytes / 1048576.0<<" MB into "<<argv[2]<<std::endl;
+	return 0;
+}
@@ -0,0 +1,511 @@
+#include "partitionPlanner.h"
+#include "distributed.h"
+#include "arm_compute/core/Error.h"
+
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <limits>
+#include <sstream>
+
+namespace opGraph{
+
+	static std::string costKey(const std::string &model, const std::string &device, int threads, const std::string &node){
+		return model + " " + device + " " + std::to_string(threads) + " " + node;
+	}
+
+	CostTable::CostTable(const std::string &filename)
+		: _filename(filename), _ms()
+	{
+		std::ifstream fs(filename);
+		std::string line;
+		while(std::getline(fs, line))
+		{
+			std::istringstream is(line);
+			std::string model;
+			std::string device;
+			std::string node;
+			int threads = 0;
+			double ms = 0;
+			if(line.empty() || line[0] == '#' || !(is >> model >> device >> threads >> node >> ms))
+			{
+				continue;
+			}
+			_ms[costKey(model, device, threads, node)] = ms;
+		}
+	}
+
+	bool CostTable::find(const std::string &model, const std::string &device, int threads, const std::string &node, double &ms) const{
+		const std::map<std::string, double>::const_iterator it = _ms.find(costKey(model, device, threads, node));
+		if(it == _ms.end())
+		{
+			return false;
+		}
+		ms = it->second;
+		return true;
+	}
+
+	void CostTable::record(const std::string &model, const std::string &device, int threads, const Graph &graph, const std::vector<double> &costs){
+		for(const Node &node : graph.nodes())
+		{
+			_ms[costKey(model, device, threads, node.name)] = costs.at(node.id);
+		}
+	}
+
+	void CostTable::save() const{
+		std::ofstream fs(_filename, std::ios::out | std::ios::trunc);
+		if(!fs.is_open())
+		{
+			ARM_COMPUTE_ERROR("Cannot write the cost table %s", _filename.c_str());
+		}
+		fs << "#model, device, threads, node, then its median ms" << std::endl;
+		fs << std::fixed << std::setprecision(4);
+		for(std::map<std::string, double>::const_iterator it = _ms.begin(); it != _ms.end(); ++it)
+		{
+			fs << it->first << " " << it->second << std::endl;
+		}
+	}
+
+	Cluster loadCluster(const std::string &filename){
+		std::ifstream fs(filename);
+		if(!fs.is_open())
+		{
+			ARM_COMPUTE_ERROR("Cannot read the cluster %s", filename.c_str());
+		}
+		Cluster cluster;
+		std::vector<std::pair<std::pair<std::string, std::string>, Link>> links;
+		std::string line;
+		while(std::getline(fs, line))
+		{
+			std::istringstream is(line);
+			std::string kind;
+			if(line.empty() || line[0] == '#' || !(is >> kind))
+			{
+				continue;
+			}
+			if(kind == "rank")
+			{
+				Device device;
+				if(!(is >> device.type >> device.threads >> device.memory) || device.threads < 1)
+				{
+					ARM_COMPUTE_ERROR("Bad rank line in %s: %s", filename.c_str(), line.c_str());
+				}
+				cluster.ranks.push_back(device);
+			}
+			else if(kind == "link")
+			{
+				std::string a;
+				std::string b;
+				Link link;
+				if(!(is >> a >> b >> link.bandwidth >> link.latency) || link.bandwidth <= 0)
+				{
+					ARM_COMPUTE_ERROR("Bad link line in %s: %s", filename.c_str(), line.c_str());
+				}
+				links.emplace_back(std::make_pair(a, b), link);
+			}
+			else
+			{
+				ARM_COMPUTE_ERROR("Unknown line in %s: %s", filename.c_str(), line.c_str());
+			}
+		}
+		const int size = cluster.size();
+		if(size < 1)
+		{
+			ARM_COMPUTE_ERROR("%s has no rank", filename.c_str());
+		}
+
+		//The wildcard first, the pairs listed by rank override it
+		cluster.links.assign(size, std::vector<Link>(size, Link()));
+		for(int pass = 0; pass < 2; pass++)
+		{
+			for(size_t l = 0; l < links.size(); l++)
+			{
+				const std::string &a = links[l].first.first;
+				const std::string &b = links[l].first.second;
+				if((a == "*" || b == "*") != (pass == 0))
+				{
+					continue;
+				}
+				for(int i = 0; i < size; i++)
+				{
+					for(int j = 0; j < size; j++)
+					{
+						const bool ab = (a == "*" || a == std::to_string(i)) && (b == "*" || b == std::to_string(j));
+						const bool ba = (a == "*" || a == std::to_string(j)) && (b == "*" || b == std::to_string(i));
+						if(i != j && (ab || ba))
+						{
+							cluster.links[i][j] = links[l].second;
+						}
+					}
+				}
+			}
+		}
+		for(int i = 0; i < size; i++)
+		{
+			for(int j = 0; j < size; j++)
+			{
+				if(i != j && cluster.links[i][j].bandwidth <= 0)
+				{
+					ARM_COMPUTE_ERROR("%s has no link between rank %d and rank %d", filename.c_str(), i, j);
+				}
+			}
+		}
+		return cluster;
+	}
+
+	std::vector<std::vector<double>> rankCosts(const CostTable &table, const std::string &model, const Graph &graph, const Cluster &cluster){
+		std::vector<std::vector<double>> costs(graph.nodes().size(), std::vector<double>(cluster.size(), 0));
+		for(const Node &node : graph.nodes())
+		{
+			for(int r = 0; r < cluster.size(); r++)
+			{
+				const Device &device = cluster.ranks[r];
+				if(!table.find(model, device.type, device.threads, node.name, costs[node.id][r]))
+				{
+					ARM_COMPUTE_ERROR("No cost of %s for %s on %s with %d threads, run plan_partition measure there first",
+									  node.name.c_str(), model.c_str(), device.type.c_str(), device.threads);
+				}
+			}
+		}
+		return costs;
+	}
+
+	//F32 parameters of a node, the bias of a folded BN included
+	static double parameterMB(const Graph &graph, const Node &node){
+		const Edge &in = graph.edge(node.inputs.empty() ? graph.inputEdge() : node.inputs[0]);
+		double floats = 0;
+		switch(node.type)
+		{
+			case OpType::Conv:
+				floats = static_cast<double>(node.kernel) * node.kernel * in.c / node.groups * node.channels + node.channels;
+				break;
+			case OpType::DWConv:
+				floats = static_cast<double>(node.kernel) * node.kernel * in.c + in.c;
+				break;
+			case OpType::BN:
+				floats = 4.0 * in.c;
+				break;
+			case OpType::Add:
+				floats = node.bn.empty() ? 0 : 4.0 * in.c;
+				break;
+			case OpType::FC:
+				floats = static_cast<double>(in.elements()) * node.channels + node.channels;
+				break;
+			default:
+				break;
+		}
+		return floats * sizeof(float) / 1048576.0;
+	}
+
+	static int findUnit(std::vector<int> &parent, int id){
+		while(parent[id] != id)
+		{
+			parent[id] = parent[parent[id]];
+			id = parent[id];
+		}
+		return id;
+	}
+
+	PartitionPlanner::PartitionPlanner(const Graph &graph, const Cluster &cluster, const std::vector<std::vector<double>> &costs, int batch)
+		: _graph(graph), _cluster(cluster), _costs(costs), _batch(std::max(batch, 1)), _order(graph.schedule()),
+		  _unit(graph.nodes().size(), -1), _units(0), _parameters(graph.nodes().size(), 0)
+	{
+		if(costs.size() != graph.nodes().size())
+		{
+			ARM_COMPUTE_ERROR("One cost per node is needed");
+		}
+		//A node of a decoupled group joins the producers of its inputs in the same group, the shared nodes are units of their own
+		std::vector<int> parent(graph.nodes().size());
+		for(size_t i = 0; i < parent.size(); i++)
+		{
+			parent[i] = static_cast<int>(i);
+		}
+		for(const Node &node : graph.nodes())
+		{
+			_parameters[node.id] = parameterMB(graph, node);
+			for(size_t i = 0; i < node.inputs.size() && node.group >= 0; i++)
+			{
+				const int producer = graph.edge(node.inputs[i]).producer;
+				if(producer >= 0 && graph.node(producer).group == node.group)
+				{
+					parent[findUnit(parent, producer)] = findUnit(parent, node.id);
+				}
+			}
+		}
+		std::vector<int> number(graph.nodes().size(), -1);
+		for(size_t i = 0; i < _order.size(); i++)
+		{
+			const int root = findUnit(parent, _order[i]);
+			if(number[root] < 0)
+			{
+				number[root] = _units++;
+			}
+			_unit[_order[i]] = number[root];
+		}
+	}
+
+	Simulation PartitionPlanner::simulate(const std::vector<int> &rank_of, int frames) const{
+		const int size = _cluster.size();
+		frames = std::max(frames, 1);
+		Simulation s;
+		s.nodes.assign(size, 0);
+		s.compute.assign(size, 0);
+		s.wait.assign(size, 0);
+		s.sent.assign(size, 0);
+		s.memory.assign(size, 0);
+
+		std::vector<double> clock(size, 0);
+		std::vector<std::vector<double>> link_free(size, std::vector<double>(size, 0));
+		std::vector<double> finish(frames, 0);
+		for(int f = 0; f < frames; f++)
+		{
+			for(size_t i = 0; i < _order.size(); i++)
+			{
+				const Node &node = _graph.node(_order[i]);
+				const int owner = rank_of[node.id];
+				clock[owner] += _costs[node.id][owner];
+				s.compute[owner] += _costs[node.id][owner];
+				for(size_t o = 0; o < node.outputs.size(); o++)
+				{
+					const Edge &edge = _graph.edge(node.outputs[o]);
+					std::vector<bool> needed(size, false);
+					for(size_t c = 0; c < edge.consumers.size(); c++)
+					{
+						needed[rank_of[edge.consumers[c]]] = true;
+					}
+					const double mb = edge.elements() * _batch * sizeof(float) / 1048576.0;
+					for(int peer = 0; peer < size; peer++)
+					{
+						if(!needed[peer] || peer == owner)
+						{
+							continue;
+						}
+						const Link &link = _cluster.links[owner][peer];
+						link_free[owner][peer] = std::max(link_free[owner][peer], clock[owner]) + mb / link.bandwidth * 1000.0;
+						const double arrival = link_free[owner][peer] + link.latency;
+						if(arrival > clock[peer])
+						{
+							s.wait[peer] += arrival - clock[peer];
+							clock[peer] = arrival;
+						}
+						s.sent[owner] += mb;
+					}
+				}
+			}
+			finish[f] = *std::max_element(clock.begin(), clock.end());
+		}
+		s.latency = finish[0];
+		s.throughput = frames > 1 ? 1000.0 * (frames - 1) / std::max(finish[frames - 1] - finish[0], 1e-9) : 1000.0 / std::max(finish[0], 1e-9);
+		for(int r = 0; r < size; r++)
+		{
+			s.compute[r] /= frames;
+			s.wait[r] /= frames;
+			s.sent[r] /= frames;
+		}
+
+		//Parameters, plus the activations while they are alive: on the owner from its producer to its last consumer there,
+		//the whole run for the network input and output and for the tensors a rank receives, they are not planned
+		std::vector<double> permanent(size, 0);
+		std::vector<std::vector<double>> delta(size, std::vector<double>(_order.size() + 1, 0));
+		std::vector<size_t> position(_graph.nodes().size(), 0);
+		for(size_t i = 0; i < _order.size(); i++)
+		{
+			position[_order[i]] = i;
+			s.nodes[rank_of[_order[i]]]++;
+			permanent[rank_of[_order[i]]] += _parameters[_order[i]];
+		}
+		for(const Edge &edge : _graph.edges())
+		{
+			if(edge.producer < 0)
+			{
+				continue;
+			}
+			const int owner = rank_of[edge.producer];
+			const double mb = edge.elements() * _batch * sizeof(float) / 1048576.0;
+			if(edge.id == _graph.inputEdge() || edge.id == _graph.outputEdge())
+			{
+				permanent[owner] += mb;
+			}
+			size_t last = position[edge.producer];
+			std::vector<bool> received(size, false);
+			for(size_t c = 0; c < edge.consumers.size(); c++)
+			{
+				const int rank = rank_of[edge.consumers[c]];
+				if(rank == owner)
+				{
+					last = std::max(last, position[edge.consumers[c]]);
+				}
+				else if(!received[rank])
+				{
+					received[rank] = true;
+					permanent[rank] += mb;
+				}
+			}
+			if(edge.id != _graph.inputEdge() && edge.id != _graph.outputEdge())
+			{
+				delta[owner][position[edge.producer]] += mb;
+				delta[owner][last + 1] -= mb;
+			}
+		}
+		for(int r = 0; r < size; r++)
+		{
+			double live = 0;
+			double peak = 0;
+			for(size_t i = 0; i < delta[r].size(); i++)
+			{
+				live += delta[r][i];
+				peak = std::max(peak, live);
+			}
+			s.memory[r] = permanent[r] + peak;
+			s.fits = s.fits && (_cluster.ranks[r].memory <= 0 || s.memory[r] <= _cluster.ranks[r].memory);
+		}
+		return s;
+	}
+
+	std::vector<int> PartitionPlanner::nodeRanks(const std::vector<int> &unit_rank) const{
+		std::vector<int> rank_of(_graph.nodes().size(), 0);
+		for(size_t i = 0; i < rank_of.size(); i++)
+		{
+			rank_of[i] = unit_rank[_unit[i]];
+		}
+		return rank_of;
+	}
+
+	//Lower is better, a placement that does not fit is worse than any that does and better the less it overflows
+	double PartitionPlanner::score(const std::vector<int> &unit_rank, Objective objective) const{
+		const Simulation s = simulate(nodeRanks(unit_rank), objective == Objective::Latency ? 1 : 4);
+		if(!s.fits)
+		{
+			double overflow = 0;
+			for(int r = 0; r < _cluster.size(); r++)
+			{
+				//As in simulate(), a rank without a memory limit never overflows
+				if(_cluster.ranks[r].memory > 0)
+				{
+					overflow += std::max(0.0, s.memory[r] - _cluster.ranks[r].memory);
+				}
+			}
+			return 1e9 + overflow;
+		}
+		return objective == Objective::Latency ? s.latency : 1000.0 / s.throughput;
+	}
+
+	void PartitionPlanner::improve(std::vector<int> &unit_rank, double &best, Objective objective) const{
+		const int size = _cluster.size();
+		//The unit of the graph input is the first of the schedule, rank 0 fills the input
+		const int pinned = _unit[_order.front()];
+		bool improved = true;
+		for(int pass = 0; pass < 50 && improved; pass++)
+		{
+			improved = false;
+			for(int u = 0; u < _units; u++)
+			{
+				for(int r = 0; r < size && u != pinned; r++)
+				{
+					const int previous = unit_rank[u];
+					if(r == previous)
+					{
+						continue;
+					}
+					unit_rank[u] = r;
+					const double s = score(unit_rank, objective);
+					if(s < best * (1 - 1e-6))
+					{
+						best = s;
+						improved = true;
+					}
+					else
+					{
+						unit_rank[u] = previous;
+					}
+				}
+			}
+			//Cutting the schedule: the units of rank a from unit u on go to rank b
+			for(int u = 1; u < _units; u++)
+			{
+				for(int a = 0; a < size; a++)
+				{
+					for(int b = 0; b < size; b++)
+					{
+						if(a == b)
+						{
+							continue;
+						}
+						std::vector<int> moved = unit_rank;
+						bool changed = false;
+						for(int v = u; v < _units; v++)
+						{
+							if(v != pinned && moved[v] == a)
+							{
+								moved[v] = b;
+								changed = true;
+							}
+						}
+						if(!changed)
+						{
+							continue;
+						}
+						const double s = score(moved, objective);
+						if(s < best * (1 - 1e-6))
+						{
+							best = s;
+							unit_rank = moved;
+							improved = true;
+						}
+					}
+				}
+			}
+		}
+	}
+
+	std::vector<int> PartitionPlanner::plan(Objective objective) const{
+		const int size = _cluster.size();
+		std::vector<std::vector<int>> starts;
+		for(int r = 0; r < size; r++)
+		{
+			starts.push_back(std::vector<int>(_units, r));
+		}
+		std::vector<int> round_robin(_units, 0);
+		for(size_t i = 0; i < _order.size(); i++)
+		{
+			round_robin[_unit[_order[i]]] = placeNode(_graph.node(_order[i]), size);
+		}
+		starts.push_back(round_robin);
+
+		std::vector<int> best_units;
+		double best = std::numeric_limits<double>::max();
+		for(size_t i = 0; i < starts.size(); i++)
+		{
+			std::vector<int> unit_rank = starts[i];
+			unit_rank[_unit[_order.front()]] = 0;
+			double s = score(unit_rank, objective);
+			improve(unit_rank, s, objective);
+			if(s < best)
+			{
+				best = s;
+				best_units = unit_rank;
+			}
+		}
+		return nodeRanks(best_units);
+	}
+
+	void PartitionPlanner::print(std::ostream &os, const std::vector<int> &rank_of) const{
+		const Simulation s = simulate(rank_of);
+		os << std::fixed << std::setprecision(3);
+		os << "latency " << s.latency << " ms, " << s.throughput << " frames/s" << (s.fits ? "" : ", over the memory of a rank") << std::endl;
+		os << "rank  device         threads  nodes  compute ms  recv wait ms  sent MB  memory MB" << std::endl;
+		for(int r = 0; r < _cluster.size(); r++)
+		{
+			const Device &device = _cluster.ranks[r];
+			os << std::left << std::setw(6) << r << std::setw(15) << device.type << std::right << std::setw(7) << device.threads
+			   << std::setw(7) << s.nodes[r] << std::setw(12) << s.compute[r] << std::setw(14) << s.wait[r]
+			   << std::setw(9) << s.sent[r] << std::setw(11) << s.memory[r];
+			if(device.memory > 0)
+			{
+				os << " / " << device.memory;
+			}
+			os << std::endl;
+		}
+	}
+
+ }
@@ -0,0 +1,130 @@
+#ifndef OPPARTITIONPLANNER
+#define OPPARTITIONPLANNER
+
+#include "graph.h"
+
+#include <map>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace opGraph{
+
+	//Median ms of every node of a model per device type and thread count, measured once on each kind of board
+	//Every line is "model device threads node ms", e.g. "resnet50_s3_addchannel rpi4 4 layer1_0_conv1 1.204"
+	//The files of several boards can be concatenated
+	class CostTable{
+	public:
+		//Nothing is read when the file does not exist
+		explicit CostTable(const std::string &filename);
+
+		bool find(const std::string &model, const std::string &device, int threads, const std::string &node, double &ms) const;
+		//costs is indexed by the node ids of graph, the lines already held for these nodes are replaced
+		void record(const std::string &model, const std::string &device, int threads, const Graph &graph, const std::vector<double> &costs);
+		void save() const;
+
+	private:
+		std::string _filename;
+		std::map<std::string, double> _ms;	//keyed by the line without its ms
+	};
+
+	struct Device{
+		std::string type;	//device name of the costs in the CostTable
+		int threads;
+		double memory;		//MB for the parameters and activations of the nodes placed on it, 0 or less for no limit
+
+		Device()
+			: type(), threads(1), memory(0)
+		{
+		}
+	};
+
+	struct Link{
+		double bandwidth;	//MB/s
+		double latency;		//ms
+
+		Link()
+			: bandwidth(0), latency(0)
+		{
+		}
+	};
+
+	//Ranks and the links between them, read from a text file
+	//  rank <device> <threads> <memory MB>			one line per rank, in rank order
+	//  link <rank> <rank> <MB/s> <latency ms>		both directions, "link * * ..." for every pair not listed
+	struct Cluster{
+		std::vector<Device> ranks;
+		std::vector<std::vector<Link>> links;	//[from][to]
+
+		Cluster()
+			: ranks(), links()
+		{
+		}
+		int size() const { return static_cast<int>(ranks.size()); }
+	};
+
+	Cluster loadCluster(const std::string &filename);
+
+	//Cost of every node of graph on every rank of the cluster, [node id][rank] in ms
+	//Fails on the first node the table does not hold for the device and threads of a rank
+	std::vector<std::vector<double>> rankCosts(const CostTable &table, const std::string &model, const Graph &graph, const Cluster &cluster);
+
+	//A placement as the simulator sees it, per rank values are per frame
+	struct Simulation{
+		double latency;					//ms of one frame, every rank idle when it starts
+		double throughput;				//frames per second when the frames follow each other as fast as the ranks allow
+		std::vector<int> nodes;			//per rank
+		std::vector<double> compute;	//per rank ms in layers
+		std::vector<double> wait;		//per rank ms blocked in recv
+		std::vector<double> sent;		//per rank MB sent
+		std::vector<double> memory;		//per rank MB of parameters and peak live activations
+		bool fits;						//every rank within its memory
+
+		Simulation()
+			: latency(0), throughput(0), nodes(), compute(), wait(), sent(), memory(), fits(true)
+		{
+		}
+	};
+
+	enum class Objective{
+		Latency,
+		Throughput
+	};
+
+	//Which layers and which channel groups go to which rank, from measured costs instead of by hand
+	//The simulator replays the distributed runtime: every rank runs its nodes in the global schedule order, the owner of an edge
+	//sends it to every other rank that consumes it right after producing it and those ranks block in recv at that point
+	//A link carries one transfer at a time in each direction, bytes / bandwidth + latency, the sender does not wait for it
+	class PartitionPlanner{
+	public:
+		//graph is Network::graph() (see foldGraph), costs come from rankCosts(), activations are F32 of batch images
+		PartitionPlanner(const Graph &graph, const Cluster &cluster, const std::vector<std::vector<double>> &costs, int batch = 1);
+
+		//rank_of is indexed by node id, the throughput is measured over frames back to back
+		Simulation simulate(const std::vector<int> &rank_of, int frames = 8) const;
+		//Local search from every single rank and from placeNode(): a unit (the nodes of one decoupled group in one block,
+		//or one shared node) moves to another rank, or every unit of a rank from some point of the schedule on does
+		//The graph input stays on rank 0, which fills it. Placements over a memory limit are only kept while nothing fits
+		std::vector<int> plan(Objective objective) const;
+		//Summary of the simulation then the nodes, ms, transfers and memory of every rank
+		void print(std::ostream &os, const std::vector<int> &rank_of) const;
+
+	private:
+		double score(const std::vector<int> &unit_rank, Objective objective) const;
+		std::vector<int> nodeRanks(const std::vector<int> &unit_rank) const;
+		void improve(std::vector<int> &unit_rank, double &best, Objective objective) const;
+
+		Graph _graph;
+		Cluster _cluster;
+		std::vector<std::vector<double>> _costs;
+		int _batch;
+		std::vector<int> _order;		//schedule
+		std::vector<int> _unit;			//unit of every node id, numbered in schedule order
+		int _units;
+		std::vector<double> _parameters;	//MB of every node id
+	};
+
+ }
+
+
+#endif
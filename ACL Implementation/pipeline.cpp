@@ -0,0 +1,239 @@
+#include "pipeline.h"
+#include "profiler.h"
+#include <arm_compute/runtime/Scheduler.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <limits>
+#include <pthread.h>
+#include <sched.h>
+#include <thread>
+
+namespace opGraph{
+
+	typedef std::chrono::steady_clock Clock;
+
+	static double elapsed(const Clock::time_point &begin, const Clock::time_point &end){
+		return std::chrono::duration<double, std::milli>(end - begin).count();
+	}
+
+	//Nearest-rank percentile of a sorted sample
+	static double percentile(const std::vector<double> &sorted, double p){
+		if(sorted.empty())
+		{
+			return 0;
+		}
+		const size_t rank = static_cast<size_t>(std::ceil(p / 100.0 * sorted.size()));
+		return sorted[std::min(sorted.size(), std::max<size_t>(rank, 1)) - 1];
+	}
+
+	static void pinThread(int core){
+		cpu_set_t set;
+		CPU_ZERO(&set);
+		CPU_SET(core, &set);
+		pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+	}
+
+	std::vector<double> measureNodeCosts(Network &network, int iterations){
+		Profiler profiler(network);
+		profiler.run(iterations);
+		const std::vector<LayerStats> stats = profiler.stats();
+		const std::vector<Layer> &layers = network.layers();
+		std::vector<double> costs(network.graph().nodes().size(), 0);
+		for(size_t i = 0; i < layers.size(); i++)
+		{
+			if(layers[i].type != OpType::Send && layers[i].type != OpType::Recv)
+			{
+				costs.at(layers[i].node) += stats[i].median;
+			}
+		}
+		return costs;
+	}
+
+	std::vector<size_t> cutStages(const std::vector<double> &costs, int stages){
+		const size_t n = costs.size();
+		const size_t k = std::min(static_cast<size_t>(std::max(stages, 1)), std::max<size_t>(n, 1));
+		std::vector<double> prefix(n + 1, 0);
+		for(size_t i = 0; i < n; i++)
+		{
+			prefix[i + 1] = prefix[i] + costs[i];
+		}
+
+		//best[j][i]: cheapest bottleneck for the first i nodes on j stages, start[j][i] where the last of them begins
+		const double none = std::numeric_limits<double>::max();
+		std::vector<std::vector<double>> best(k + 1, std::vector<double>(n + 1, none));
+		std::vector<std::vector<size_t>> start(k + 1, std::vector<size_t>(n + 1, 0));
+		best[0][0] = 0;
+		for(size_t j = 1; j <= k; j++)
+		{
+			for(size_t i = j; i <= n; i++)
+			{
+				for(size_t s = j - 1; s < i; s++)
+				{
+					if(best[j - 1][s] == none)
+					{
+						continue;
+					}
+					const double bottleneck = std::max(best[j - 1][s], prefix[i] - prefix[s]);
+					if(bottleneck < best[j][i])
+					{
+						best[j][i] = bottleneck;
+						start[j][i] = s;
+					}
+				}
+			}
+		}
+
+		std::vector<size_t> starts(k, 0);
+		size_t end = n;
+		for(size_t j = k; j > 0; j--)
+		{
+			starts[j - 1] = start[j][end];
+			end = starts[j - 1];
+		}
+		return starts;
+	}
+
+	Pipeline::Pipeline(const Graph &graph, const std::vector<double> &costs, int stages,
+					   const CompileOptions &options, const std::vector<int> &cores)
+		: _graph(graph), _costs(costs), _stage_of(graph.nodes().size(), 0), _cores(cores), _comms(), _stages()
+	{
+		if(costs.size() != _graph.nodes().size())
+		{
+			ARM_COMPUTE_ERROR("One cost per node is needed");
+		}
+		const std::vector<int> order = _graph.schedule();
+		std::vector<double> ordered;
+		for(size_t i = 0; i < order.size(); i++)
+		{
+			ordered.push_back(_costs[order[i]]);
+		}
+		const std::vector<size_t> starts = cutStages(ordered, stages);
+		for(size_t i = 0; i < order.size(); i++)
+		{
+			_stage_of[order[i]] = static_cast<int>(std::upper_bound(starts.begin(), starts.end(), i) - starts.begin()) - 1;
+		}
+
+		//Every edge goes forward in the schedule, so a stage only ever receives from the stages before it
+		const int count = static_cast<int>(starts.size());
+		const std::vector<std::vector<int>> mesh = socketMesh(count);
+		CompileOptions stage_options = options;
+		stage_options.fold_bn = false;
+		const std::vector<int> stage_of = _stage_of;
+		stage_options.place = [stage_of](const Node &node) { return stage_of.at(node.id); };
+		for(int s = 0; s < count; s++)
+		{
+			_comms.emplace_back(new Communicator(s, mesh[s]));
+			stage_options.comm = _comms.back().get();
+			_stages.emplace_back(new Network(_graph, stage_options));
+		}
+	}
+
+	PipelineStats Pipeline::run(int frames, int warmup){
+		const int count = stages();
+		const int total = warmup + frames;
+		std::vector<Clock::time_point> begin(total);
+		std::vector<Clock::time_point> end(total);
+		std::vector<double> compute(count, 0);
+		std::vector<double> transfer(count, 0);
+
+		//The CPP scheduler has one global thread pool, stages running kernels at once need the calling thread to do the work
+		const Scheduler::Type previous = Scheduler::get_type();
+		Scheduler::set(Scheduler::Type::ST);
+
+		std::vector<std::thread> threads;
+		for(int s = 0; s < count; s++)
+		{
+			threads.emplace_back([&, s]()
+			{
+				const unsigned int cpus = std::max(std::thread::hardware_concurrency(), 1u);
+				pinThread(_cores.empty() ? static_cast<int>(s % cpus) : _cores[s % _cores.size()]);
+				const std::vector<Layer> &layers = _stages[s]->layers();
+				for(int f = 0; f < total; f++)
+				{
+					if(s == 0)
+					{
+						begin[f] = Clock::now();
+					}
+					for(size_t i = 0; i < layers.size(); i++)
+					{
+						const Clock::time_point start = Clock::now();
+						layers[i].run();
+						if(f >= warmup)
+						{
+							const bool link = layers[i].type == OpType::Send || layers[i].type == OpType::Recv;
+							(link ? transfer[s] : compute[s]) += elapsed(start, Clock::now());
+						}
+					}
+					if(s == count - 1)
+					{
+						end[f] = Clock::now();
+					}
+				}
+			});
+		}
+		for(size_t t = 0; t < threads.size(); t++)
+		{
+			threads[t].join();
+		}
+		Scheduler::set(previous);
+
+		PipelineStats stats;
+		stats.frames = frames;
+		if(frames <= 0)
+		{
+			return stats;
+		}
+		std::vector<double> latency;
+		for(int f = warmup; f < total; f++)
+		{
+			latency.push_back(elapsed(begin[f], end[f]));
+		}
+		std::sort(latency.begin(), latency.end());
+		stats.latency_median = percentile(latency, 50);
+		stats.latency_p99 = percentile(latency, 99);
+		//Measured from the last warmup frame leaving the pipeline, when it is already full
+		const Clock::time_point origin = warmup > 0 ? end[warmup - 1] : begin[0];
+		stats.throughput = frames * 1000.0 / elapsed(origin, end[total - 1]);
+		for(int s = 0; s < count; s++)
+		{
+			stats.compute.push_back(compute[s] / frames);
+			stats.transfer.push_back(transfer[s] / frames);
+		}
+		return stats;
+	}
+
+	void Pipeline::print(std::ostream &os) const{
+		const std::vector<int> order = _graph.schedule();
+		double total = 0;
+		for(size_t i = 0; i < _costs.size(); i++)
+		{
+			total += _costs[i];
+		}
+		os << std::fixed << std::setprecision(1);
+		for(int s = 0; s < stages(); s++)
+		{
+			std::string first;
+			std::string last;
+			int nodes = 0;
+			double cost = 0;
+			for(size_t i = 0; i < order.size(); i++)
+			{
+				if(_stage_of[order[i]] != s)
+				{
+					continue;
+				}
+				const Node &node = _graph.node(order[i]);
+				first = first.empty() ? node.name : first;
+				last = node.name;
+				cost += _costs[node.id];
+				nodes++;
+			}
+			os << "Stage " << s << ": " << nodes << " nodes, " << first << " .. " << last << ", "
+			   << (total > 0 ? 100.0 * cost / total : 0.0) << "% of the cost" << std::endl;
+		}
+	}
+
+ }
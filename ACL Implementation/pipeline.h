@@ -0,0 +1,71 @@
+#ifndef OPPIPELINE
+#define OPPIPELINE
+
+#include "network.h"
+#include "distributed.h"
+
+#include <memory>
+#include <ostream>
+#include <vector>
+
+namespace opGraph{
+
+	//Median time of every node of network.graph() over a profiled run, indexed by node id
+	//A grouped conv sums its split, group convs and concat
+	std::vector<double> measureNodeCosts(Network &network, int iterations);
+
+	//Cut the schedule into stages of consecutive nodes so the most expensive stage is as cheap as possible
+	//costs are in schedule order, returns the schedule position where every stage starts
+	std::vector<size_t> cutStages(const std::vector<double> &costs, int stages);
+
+	struct PipelineStats{
+		int frames;
+		double throughput;				//frames per second once the pipeline is full
+		double latency_median;			//ms from stage 0 starting a frame to the last stage finishing it
+		double latency_p99;
+		std::vector<double> compute;	//per stage ms per frame spent in layers
+		std::vector<double> transfer;	//per stage ms per frame spent in send and recv, waiting included
+
+		PipelineStats()
+			: frames(0), throughput(0), latency_median(0), latency_p99(0), compute(), transfer()
+		{
+		}
+	};
+
+	//Pipeline-parallel execution: the schedule is cut into stages, each stage is a Network of its own
+	//run by one thread pinned to one core, and consecutive frames flow through the stages at the same time
+	//Stages hand their boundary tensors over the same Communicator the distributed mode uses, on an
+	//in-process socket mesh, so a stage never reads a tensor the previous stage is already overwriting
+	class Pipeline{
+	public:
+		//graph is lowered as is, fold it first (Network::graph() already is) so costs match its node ids
+		Pipeline(const Graph &graph, const std::vector<double> &costs, int stages,
+				 const CompileOptions &options = CompileOptions(), const std::vector<int> &cores = std::vector<int>());
+		Pipeline(const Pipeline &) = delete;
+		Pipeline &operator=(const Pipeline &) = delete;
+
+		//Stream frames through every stage, the first warmup frames are not measured
+		//The kernels run on the single threaded scheduler meanwhile, the previous scheduler is restored after
+		PipelineStats run(int frames, int warmup = 1);
+
+		int stages() const { return static_cast<int>(_stages.size()); }
+		int stage(const Node &node) const { return _stage_of.at(node.id); }
+		//Nodes of every stage and their share of the total cost
+		void print(std::ostream &os) const;
+
+		Tensor * input() { return _stages.front()->input(); }
+		Tensor * output() { return _stages.back()->output(); }
+
+	private:
+		Graph _graph;
+		std::vector<double> _costs;
+		std::vector<int> _stage_of;		//stage of every node id
+		std::vector<int> _cores;
+		std::vector<std::unique_ptr<Communicator>> _comms;
+		std::vector<std::unique_ptr<Network>> _stages;
+	};
+
+ }
+
+
+#endif
@@ -0,0 +1,125 @@
+#include "network.h"
+#include "distributed.h"
+#include "modelZoo.h"
+#include "partitionPlanner.h"
+#include "pipeline.h"
+#include <arm_compute/runtime/Scheduler.h>
+
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace arm_compute;
+using namespace std;
+
+//Partition planning for run_distributed on boards that are not alike
+//  measure: time every node of the model on this board and add it to the cost table under a device name
+//  plan: search the placement of the nodes over the ranks of a cluster file and write it for run_distributed
+//  simulate: replay a placement file on the cluster without running anything
+//The plan is printed against every rank alone and the round robin of placeNode()
+
+static void usage(){
+	std::cout<<"Usage: ./plan_partition measure [device] [numberThread(4)] [model(resnet50_s3_addchannel)] [costs(partition_costs.txt)] [numberIteration(20)]"<<std::endl;
+	std::cout<<"       ./plan_partition plan [cluster] [model(resnet50_s3_addchannel)] [costs(partition_costs.txt)] [placement(placement.txt)] [objective(latency): latency or throughput]"<<std::endl;
+	std::cout<<"       ./plan_partition simulate [cluster] [model(resnet50_s3_addchannel)] [costs(partition_costs.txt)] [placement(placement.txt)]"<<std::endl;
+	std::cout<<"A cluster file has one \"rank <device> <threads> <memory MB>\" line per rank and \"link <rank|*> <rank|*> <MB/s> <latency ms>\" lines"<<std::endl;
+}
+
+int main (int argc, char **argv)
+{
+	if(argc < 3 || argc > 7)
+	{
+		usage();
+		return 0;
+	}
+	const string mode = argv[1];
+
+	if(mode == "measure")
+	{
+		const string device = argv[2];
+		const int threads = argc > 3 ? atoi(argv[3]) : 4;
+		const string model = argc > 4 ? argv[4] : "resnet50_s3_addchannel";
+		const string costs_file = argc > 5 ? argv[5] : "partition_costs.txt";
+		const int iterations = argc > 6 ? atoi(argv[6]) : 20;
+		arm_compute::Scheduler::get().set_num_threads(threads);
+
+		opGraph::Graph graph;
+		opGraph::buildModel(graph, model);
+		opGraph::CompileOptions options;
+		opGraph::Network network(graph, options);
+		const std::vector<double> costs = opGraph::measureNodeCosts(network, iterations);
+
+		opGraph::CostTable table(costs_file);
+		table.record(model, device, threads, network.graph(), costs);
+		table.save();
+		double total = 0;
+		for(size_t i = 0; i < costs.size(); i++)
+		{
+			total += costs[i];
+		}
+		std::cout << model << " on " << device << " with " << threads << " threads: " << costs.size() << " nodes, "
+				  << total << " ms, added to " << costs_file << std::endl;
+		return 0;
+	}
+
+	if(mode != "plan" && mode != "simulate")
+	{
+		usage();
+		return 0;
+	}
+	const string cluster_file = argv[2];
+	const string model = argc > 3 ? argv[3] : "resnet50_s3_addchannel";
+	const string costs_file = argc > 4 ? argv[4] : "partition_costs.txt";
+	const string placement_file = argc > 5 ? argv[5] : "placement.txt";
+	const string objective_name = argc > 6 ? argv[6] : "latency";
+	if(objective_name != "latency" && objective_name != "throughput")
+	{
+		usage();
+		return 0;
+	}
+	const opGraph::Objective objective = objective_name == "latency" ? opGraph::Objective::Latency : opGraph::Objective::Throughput;
+
+	//The node names and shapes run_distributed will lower, without building the network
+	opGraph::Graph graph;
+	opGraph::buildModel(graph, model);
+	opGraph::foldGraph(graph, opGraph::CompileOptions());
+	const opGraph::Cluster cluster = opGraph::loadCluster(cluster_file);
+	const opGraph::CostTable table(costs_file);
+	const opGraph::PartitionPlanner planner(graph, cluster, opGraph::rankCosts(table, model, graph, cluster));
+
+	std::vector<int> rank_of(graph.nodes().size(), 0);
+	if(mode == "simulate")
+	{
+		const std::function<int(const opGraph::Node &)> place = opGraph::loadPlacement(placement_file, cluster.size());
+		for(const opGraph::Node &node : graph.nodes())
+		{
+			rank_of[node.id] = place(node);
+		}
+		std::cout << model << " placed by " << placement_file << " on " << cluster_file << std::endl;
+		planner.print(std::cout, rank_of);
+		return 0;
+	}
+
+	for(int r = 0; r < cluster.size(); r++)
+	{
+		std::cout << "every node on rank " << r << ": ";
+		planner.print(std::cout, std::vector<int>(graph.nodes().size(), r));
+	}
+	for(const opGraph::Node &node : graph.nodes())
+	{
+		rank_of[node.id] = opGraph::placeNode(node, cluster.size());
+	}
+	std::cout << "round robin of the decoupled groups: ";
+	planner.print(std::cout, rank_of);
+
+	rank_of = planner.plan(objective);
+	std::cout << "planned for " << objective_name << ": ";
+	planner.print(std::cout, rank_of);
+	const opGraph::Simulation s = planner.simulate(rank_of);
+	opGraph::savePlacement(placement_file, graph, rank_of, cluster.size(),
+						   model + " on " + cluster_file + ", " + objective_name + ": simulated " + std::to_string(s.latency) + " ms, "
+						   + std::to_string(s.throughput) + " frames/s");
+	std::cout << "written to " << placement_file << ", run it with ./run_distributed " << cluster.size() << " ... " << model
+			  << " [image] " << placement_file << std::endl;
+	return 0;
+}
@@ -0,0 +1,250 @@
+#include "profiler.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+
+namespace opGraph{
+
+	static size_t elements(const ITensor * tensor){
+		return tensor->info()->tensor_shape().total_size();
+	}
+
+	static size_t channels(const ITensor * tensor){
+		return tensor->info()->dimension(2);
+	}
+
+	LayerCost estimateCost(const Graph &graph, const Layer &layer){
+		LayerCost cost;
+		if(layer.outputs.empty() || layer.inputs.empty())
+		{
+			return cost;
+		}
+		const Node &node = graph.node(layer.node);
+		const ITensor * in = layer.inputs[0];
+		const ITensor * out = layer.outputs[0];
+		const double k2 = static_cast<double>(node.kernel) * node.kernel;
+		size_t parameters = 0;
+
+		switch(layer.type)
+		{
+			case OpType::Conv:
+				//The layer input is already the group slice for grouped convs
+				cost.flops = 2.0 * k2 * channels(in) * elements(out);
+				parameters = static_cast<size_t>(k2) * channels(in) * channels(out) + (node.bn.empty() ? 0 : channels(out));
+				break;
+			case OpType::DWConv:
+				cost.flops = 2.0 * k2 * elements(out);
+				parameters = static_cast<size_t>(k2) * channels(out) + (node.bn.empty() ? 0 : channels(out));
+				break;
+			case OpType::BN:
+				cost.flops = 2.0 * elements(out);
+				parameters = 4 * channels(out);
+				break;
+			case OpType::Activation:
+				cost.flops = static_cast<double>(elements(out));
+				break;
+			case OpType::Add:
+				//A BN folded into the add is a multiply-add more per element
+				cost.flops = (node.bn.empty() ? 1.0 : 3.0) * elements(out);
+				parameters = node.bn.empty() ? 0 : 4 * channels(out);
+				break;
+			case OpType::MaxPool:
+			case OpType::AvgPool:
+				cost.flops = k2 * elements(out);
+				break;
+			case OpType::ReduceMean:
+				cost.flops = static_cast<double>(elements(in));
+				break;
+			case OpType::FC:
+				cost.flops = 2.0 * elements(in) * elements(out);
+				parameters = elements(in) * elements(out) + elements(out);
+				break;
+			default:
+				//Data movement only
+				break;
+		}
+
+		for(size_t i = 0; i < layer.inputs.size(); i++)
+		{
+			cost.bytes += layer.inputs[i]->info()->total_size();
+		}
+		for(size_t i = 0; i < layer.outputs.size(); i++)
+		{
+			cost.bytes += layer.outputs[i]->info()->total_size();
+		}
+		cost.bytes += parameters * sizeof(float);
+		return cost;
+	}
+
+	//Nearest-rank percentile of a sorted sample
+	static double percentile(const std::vector<double> &sorted, double p){
+		if(sorted.empty())
+		{
+			return 0;
+		}
+		const size_t rank = static_cast<size_t>(std::ceil(p / 100.0 * sorted.size()));
+		return sorted[std::min(sorted.size(), std::max<size_t>(rank, 1)) - 1];
+	}
+
+	Profiler::Profiler(Network &network)
+		: _network(network), _costs(), _begin(), _time()
+	{
+		const std::vector<Layer> &layers = _network.layers();
+		for(size_t i = 0; i < layers.size(); i++)
+		{
+			_costs.push_back(estimateCost(_network.graph(), layers[i]));
+		}
+	}
+
+	void Profiler::run(int iterations, int warmup){
+		typedef std::chrono::steady_clock Clock;
+		const std::vector<Layer> &layers = _network.layers();
+		for(int it = 0; it < warmup; it++)
+		{
+			_network.run();
+		}
+
+		const Clock::time_point origin = Clock::now();
+		for(int it = 0; it < iterations; it++)
+		{
+			std::vector<double> begin(layers.size());
+			std::vector<double> time(layers.size());
+			for(size_t i = 0; i < layers.size(); i++)
+			{
+				const Clock::time_point start = Clock::now();
+				layers[i].run();
+				const Clock::time_point end = Clock::now();
+				begin[i] = std::chrono::duration<double, std::milli>(start - origin).count();
+				time[i] = std::chrono::duration<double, std::milli>(end - start).count();
+			}
+			_begin.push_back(begin);
+			_time.push_back(time);
+		}
+	}
+
+	std::vector<LayerStats> Profiler::stats() const{
+		const std::vector<Layer> &layers = _network.layers();
+		std::vector<LayerStats> result(layers.size());
+		for(size_t i = 0; i < layers.size(); i++)
+		{
+			std::vector<double> samples;
+			for(size_t it = 0; it < _time.size(); it++)
+			{
+				samples.push_back(_time[it][i]);
+			}
+			std::sort(samples.begin(), samples.end());
+
+			LayerStats &s = result[i];
+			s.name = layers[i].name;
+			s.type = layers[i].type;
+			s.cost = _costs[i];
+			if(!samples.empty())
+			{
+				s.min = samples.front();
+				s.median = percentile(samples, 50);
+				s.p99 = percentile(samples, 99);
+				for(size_t k = 0; k < samples.size(); k++)
+				{
+					s.mean += samples[k];
+				}
+				s.mean /= samples.size();
+			}
+		}
+		return result;
+	}
+
+	double Profiler::iterationMedian() const{
+		std::vector<double> totals;
+		for(size_t it = 0; it < _time.size(); it++)
+		{
+			double total = 0;
+			for(size_t i = 0; i < _time[it].size(); i++)
+			{
+				total += _time[it][i];
+			}
+			totals.push_back(total);
+		}
+		std::sort(totals.begin(), totals.end());
+		return percentile(totals, 50);
+	}
+
+	void Profiler::print(std::ostream &os, size_t top) const{
+		std::vector<LayerStats> s = stats();
+		double total = 0;
+		for(size_t i = 0; i < s.size(); i++)
+		{
+			total += s[i].median;
+		}
+		std::stable_sort(s.begin(), s.end(), [](const LayerStats &a, const LayerStats &b)
+		{
+			return a.median > b.median;
+		});
+
+		os << std::fixed << std::setprecision(3);
+		os << "Profiled " << _time.size() << " iterations of " << s.size() << " layers, median iteration "
+		   << iterationMedian() << " ms" << std::endl;
+		os << std::left << std::setw(36) << "layer" << std::setw(16) << "type" << std::right
+		   << std::setw(10) << "min" << std::setw(10) << "median" << std::setw(10) << "p99"
+		   << std::setw(8) << "share" << std::setw(10) << "GFLOP/s" << std::setw(10) << "GB/s" << std::endl;
+		for(size_t i = 0; i < std::min(top, s.size()); i++)
+		{
+			const double seconds = s[i].median / 1000.0;
+			os << std::left << std::setw(36) << s[i].name << std::setw(16) << opName(s[i].type) << std::right
+			   << std::setw(10) << s[i].min << std::setw(10) << s[i].median << std::setw(10) << s[i].p99
+			   << std::setw(7) << std::setprecision(1) << (total > 0 ? 100.0 * s[i].median / total : 0.0) << "%"
+			   << std::setprecision(3)
+			   << std::setw(10) << (seconds > 0 ? s[i].cost.flops / seconds / 1e9 : 0.0)
+			   << std::setw(10) << (seconds > 0 ? s[i].cost.bytes / seconds / 1e9 : 0.0) << std::endl;
+		}
+	}
+
+	void Profiler::writeTrace(const std::string &filename) const{
+		const std::vector<Layer> &layers = _network.layers();
+		std::ofstream fs(filename);
+		if(!fs.is_open())
+		{
+			ARM_COMPUTE_ERROR("Cannot write the trace %s", filename.c_str());
+		}
+		fs << std::fixed << std::setprecision(3);
+		fs << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[" << std::endl;
+		fs << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":0,\"args\":{\"name\":\"layers\"}}";
+		for(size_t it = 0; it < _time.size(); it++)
+		{
+			for(size_t i = 0; i < layers.size(); i++)
+			{
+				//Trace timestamps are in microseconds
+				fs << "," << std::endl
+				   << "{\"name\":\"" << layers[i].name << "\",\"cat\":\"" << opName(layers[i].type)
+				   << "\",\"ph\":\"X\",\"pid\":0,\"tid\":0,\"ts\":" << _begin[it][i] * 1000.0
+				   << ",\"dur\":" << _time[it][i] * 1000.0
+				   << ",\"args\":{\"iteration\":" << it << ",\"flops\":" << _costs[i].flops
+				   << ",\"bytes\":" << _costs[i].bytes << "}}";
+			}
+		}
+		fs << std::endl << "]}" << std::endl;
+	}
+
+	void Profiler::writeCSV(const std::string &filename) const{
+		const std::vector<LayerStats> s = stats();
+		std::ofstream fs(filename);
+		if(!fs.is_open())
+		{
+			ARM_COMPUTE_ERROR("Cannot write the summary %s", filename.c_str());
+		}
+		fs << std::fixed << std::setprecision(4);
+		fs << "index,name,type,min_ms,median_ms,p99_ms,mean_ms,mflops,bytes,gflops_per_s,gbytes_per_s" << std::endl;
+		for(size_t i = 0; i < s.size(); i++)
+		{
+			const double seconds = s[i].median / 1000.0;
+			fs << i << "," << s[i].name << "," << opName(s[i].type) << ","
+			   << s[i].min << "," << s[i].median << "," << s[i].p99 << "," << s[i].mean << ","
+			   << s[i].cost.flops / 1e6 << "," << s[i].cost.bytes << ","
+			   << (seconds > 0 ? s[i].cost.flops / seconds / 1e9 : 0.0) << ","
+			   << (seconds > 0 ? s[i].cost.bytes / seconds / 1e9 : 0.0) << std::endl;
+		}
+	}
+
+ }
@@ -0,0 +1,71 @@
+#ifndef OPPROFILER
+#define OPPROFILER
+
+#include "network.h"
+
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace opGraph{
+
+	//Work done by one layer, estimated from the tensor shapes
+	struct LayerCost{
+		double flops;
+		size_t bytes;		//activations read and written plus the parameters
+
+		LayerCost()
+			: flops(0), bytes(0)
+		{
+		}
+	};
+
+	LayerCost estimateCost(const Graph &graph, const Layer &layer);
+
+	//Timing of one layer over every profiled iteration, in milliseconds
+	struct LayerStats{
+		std::string name;
+		OpType type;
+		LayerCost cost;
+		double min;
+		double median;
+		double p99;
+		double mean;
+
+		LayerStats()
+			: name(), type(OpType::Input), cost(), min(0), median(0), p99(0), mean(0)
+		{
+		}
+	};
+
+	//Instrumented replacement of the m_vecFuc loop: every layer is timed on its own
+	class Profiler{
+	public:
+		explicit Profiler(Network &network);
+		Profiler(const Profiler &) = delete;
+		Profiler &operator=(const Profiler &) = delete;
+
+		//Warmup iterations run the network without recording (first run reshapes the weights)
+		void run(int iterations, int warmup = 1);
+
+		std::vector<LayerStats> stats() const;
+		//Median time of a whole iteration
+		double iterationMedian() const;
+
+		//Top layers by median time
+		void print(std::ostream &os, size_t top = 15) const;
+		//One complete event per layer and iteration, open with chrome://tracing or Perfetto
+		void writeTrace(const std::string &filename) const;
+		void writeCSV(const std::string &filename) const;
+
+	private:
+		Network &_network;
+		std::vector<LayerCost> _costs;
+		std::vector<std::vector<double>> _begin;	//[iteration][layer] start, ms since the first recorded iteration
+		std::vector<std::vector<double>> _time;		//[iteration][layer] duration in ms
+	};
+
+ }
+
+
+#endif
@@ -0,0 +1,88 @@
+#include "network.h"
+#include "distributed.h"
+#include "modelZoo.h"
+#include "dataLoader.h"
+#include <chrono>
+#include <arm_compute/runtime/Scheduler.h>
+
+#include <iostream>
+#include <vector>
+
+using namespace arm_compute;
+using namespace utils;
+using namespace std;
+
+int main (int argc, char **argv)
+{
+
+	if(argc < 4 || argc > 7)
+	{
+		std::cout<<"Usage: ./run_distributed [numberRank(4)] [numberThread(1)] [numberIteration(100)] [model(resnet50_s3_addchannel)] [image] [placement]"<<std::endl;
+		std::cout<<"Decoupled groups are dealt round robin over the ranks, rank 0 keeps the shared layers,"<<std::endl;
+		std::cout<<"unless a placement file written by plan_partition says otherwise"<<std::endl;
+		return 0;
+	}
+
+	const int ranks = atoi(argv[1]);
+	const int threads = atoi(argv[2]);
+	const int iterations = atoi(argv[3]);
+	const string model = argc > 4 ? argv[4] : "resnet50_s3_addchannel";
+	const string image = argc > 5 ? argv[5] : "/root/Project/disInfer/go_kart.ppm";
+	const string placement = argc > 6 ? argv[6] : "";
+
+	return opGraph::launchLocal(ranks, [&](opGraph::Communicator &comm) -> int
+	{
+		arm_compute::Scheduler::get().set_num_threads(threads);
+
+		opGraph::Graph graph;
+		opGraph::buildModel(graph, model);
+
+		opGraph::CompileOptions options;
+		options.comm = &comm;
+		if(!placement.empty())
+		{
+			options.place = opGraph::loadPlacement(placement, comm.size());
+		}
+		opGraph::Network network(graph, options);
+
+		if(comm.rank() == 0)
+		{
+			pmLoader ppm;
+			ppm.open(image);
+			if(ppm.is_open())
+			{
+				ppm.fill_image(*network.input());
+			}
+			ppm.close();
+		}
+
+		int compute = 0;
+		for(size_t i = 0; i < network.layers().size(); i++)
+		{
+			const opGraph::OpType type = network.layers()[i].type;
+			compute += type != opGraph::OpType::Send && type != opGraph::OpType::Recv;
+		}
+		cout<<"Rank "<<comm.rank()<<": "<<compute<<" layers, "<<network.layers().size() - compute<<" transfers"<<endl;
+
+		//The first run reshapes the weights, keep it out of the measure
+		network.run();
+		const size_t warm_bytes = comm.bytesSent();
+
+		auto beginTime = std::chrono::steady_clock::now();
+		for(int iters = 0; iters < iterations; iters++)
+		{
+			network.run();
+		}
+		auto endTime = std::chrono::steady_clock::now();
+		auto elapsedTime = std::chrono::duration<double,std::milli>(endTime - beginTime);
+
+		if(comm.rank() == 0)
+		{
+			std::cout << "elapsed time is " << elapsedTime.count() << " ms, "
+					  << elapsedTime.count() / std::max(iterations, 1) << " ms per inference on " << comm.size() << " ranks" << std::endl;
+		}
+		std::cout << "Rank " << comm.rank() << " sent " << (comm.bytesSent() - warm_bytes) / std::max(iterations, 1) / 1024.0
+				  << " KB per inference" << std::endl;
+		return 0;
+	});
+}
@@ -0,0 +1,66 @@
+#include "network.h"
+#include "executor.h"
+#include "modelZoo.h"
+#include <chrono>
+#include <arm_compute/runtime/Scheduler.h>
+
+#include <algorithm>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+using namespace arm_compute;
+using namespace std;
+
+//Median latency of one inference over iterations runs, after one warmup run
+static double medianLatency(int iterations, const function<void()> &run)
+{
+	run();
+	vector<double> latency;
+	for(int i = 0; i < iterations; i++)
+	{
+		auto beginTime = std::chrono::steady_clock::now();
+		run();
+		latency.push_back(std::chrono::duration<double,std::milli>(std::chrono::steady_clock::now() - beginTime).count());
+	}
+	std::sort(latency.begin(), latency.end());
+	return latency[latency.size() / 2];
+}
+
+int main (int argc, char **argv)
+{
+
+	if(argc > 4)
+	{
+		std::cout<<"Usage: ./run_executor [numberWorker(4)] [numberIteration(50)] [model(resnet50)]"<<std::endl;
+		return 0;
+	}
+
+	const int workers = argc > 1 ? atoi(argv[1]) : 4;
+	const int iterations = std::max(argc > 2 ? atoi(argv[2]) : 50, 1);
+	const string model = argc > 3 ? argv[3] : "resnet50";
+
+	opGraph::Graph graph;
+	opGraph::buildModel(graph, model);
+	opGraph::CompileOptions options;
+	options.workspace_pools = workers;
+	opGraph::Network network(graph, options);
+
+	opGraph::Executor executor(network, workers);
+	std::cout << network.layers().size() << " layers, " << executor.dependencies() << " dependencies, longest chain "
+			  << executor.depth() << " layers" << std::endl;
+
+	arm_compute::Scheduler::get().set_num_threads(1);
+	const double single = medianLatency(iterations, [&]() { network.run(); });
+	arm_compute::Scheduler::get().set_num_threads(workers);
+	const double intra = medianLatency(iterations, [&]() { network.run(); });
+	const double branches = medianLatency(iterations, [&]() { executor.run(); });
+
+	std::cout << std::fixed << std::setprecision(2);
+	std::cout << "sequential, 1 thread:              " << single << " ms" << std::endl;
+	std::cout << "sequential, " << workers << " threads per kernel: " << intra << " ms" << std::endl;
+	std::cout << "dependency executor, " << workers << " workers:  " << branches << " ms ("
+			  << single / branches << "x against 1 thread, " << intra / branches << "x against intra-op)" << std::endl;
+	return 0;
+}
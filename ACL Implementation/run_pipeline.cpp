@@ -0,0 +1,76 @@
+#include "network.h"
+#include "pipeline.h"
+#include "modelZoo.h"
+#include <chrono>
+#include <arm_compute/runtime/Scheduler.h>
+
+#include <algorithm>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+using namespace arm_compute;
+using namespace std;
+
+//Throughput and latency of intra-op threading against pipeline stages, for 1 to N cores
+int main (int argc, char **argv)
+{
+
+	if(argc > 4)
+	{
+		std::cout<<"Usage: ./run_pipeline [numberCore(4)] [numberFrame(50)] [model(resnet50)]"<<std::endl;
+		return 0;
+	}
+
+	const int cores = argc > 1 ? atoi(argv[1]) : 4;
+	const int frames = std::max(argc > 2 ? atoi(argv[2]) : 50, 1);
+	const string model = argc > 3 ? argv[3] : "resnet50";
+
+	opGraph::Graph graph;
+	opGraph::buildModel(graph, model);
+	opGraph::CompileOptions options;
+
+	//Stage cuts follow the single threaded time of every node
+	arm_compute::Scheduler::get().set_num_threads(1);
+	opGraph::Network network(graph, options);
+	const vector<double> costs = opGraph::measureNodeCosts(network, 10);
+
+	std::cout << std::fixed << std::setprecision(2);
+	std::cout << std::setw(6) << "cores" << std::setw(14) << "intra fps" << std::setw(14) << "intra ms"
+			  << std::setw(14) << "pipe fps" << std::setw(14) << "pipe ms" << std::setw(14) << "pipe p99"
+			  << std::setw(16) << "slowest stage" << std::endl;
+	for(int n = 1; n <= cores; n++)
+	{
+		//Intra-op: one frame at a time, every kernel split over n threads
+		arm_compute::Scheduler::get().set_num_threads(n);
+		network.run();
+		vector<double> latency;
+		auto beginTime = std::chrono::steady_clock::now();
+		for(int f = 0; f < frames; f++)
+		{
+			auto runTime = std::chrono::steady_clock::now();
+			network.run();
+			latency.push_back(std::chrono::duration<double,std::milli>(std::chrono::steady_clock::now() - runTime).count());
+		}
+		const double elapsed = std::chrono::duration<double,std::milli>(std::chrono::steady_clock::now() - beginTime).count();
+		std::sort(latency.begin(), latency.end());
+
+		//Pipeline: n single threaded stages, up to n frames in flight
+		opGraph::Pipeline pipeline(network.graph(), costs, n, options);
+		const opGraph::PipelineStats stats = pipeline.run(frames);
+		const double slowest = *std::max_element(stats.compute.begin(), stats.compute.end());
+
+		std::cout << std::setw(6) << n << std::setw(14) << frames * 1000.0 / elapsed << std::setw(14) << latency[latency.size() / 2]
+				  << std::setw(14) << stats.throughput << std::setw(14) << stats.latency_median << std::setw(14) << stats.latency_p99
+				  << std::setw(16) << slowest << std::endl;
+		if(n == cores)
+		{
+			pipeline.print(std::cout);
+			for(int s = 0; s < pipeline.stages(); s++)
+			{
+				std::cout << "Stage " << s << ": compute " << stats.compute[s] << " ms/frame, transfer " << stats.transfer[s] << " ms/frame" << std::endl;
+			}
+		}
+	}
+	return 0;
+}
@@ -0,0 +1,55 @@
+#include "inferenceServer.h"
+#include "modelZoo.h"
+#include <arm_compute/runtime/Scheduler.h>
+
+#include <csignal>
+#include <iostream>
+#include <string>
+
+using namespace arm_compute;
+using namespace std;
+
+//The model is built and its weights reshaped once, then every request only runs the prepared layers
+//Stop with Ctrl-C, the statistics are printed on the way out, load_client can also ask for them
+
+static opGraph::InferenceServer * g_server = nullptr;
+
+static void onSignal(int){
+	if(g_server != nullptr)
+	{
+		g_server->stop();
+	}
+}
+
+int main (int argc, char **argv)
+{
+	if(argc > 6)
+	{
+		std::cout<<"Usage: ./run_server [socket(/tmp/opgraph.sock)] [model(resnet50)] [numberThread(4)] [max batch(8)] [max wait ms(5)]"<<std::endl;
+		return 0;
+	}
+	const string socket_path = argc > 1 ? argv[1] : "/tmp/opgraph.sock";
+	const string model = argc > 2 ? argv[2] : "resnet50";
+	arm_compute::Scheduler::get().set_num_threads(argc > 3 ? atoi(argv[3]) : 4);
+	const int max_batch = argc > 4 ? atoi(argv[4]) : 8;
+	const double max_wait = argc > 5 ? atof(argv[5]) : 5.0;
+
+	opGraph::Graph graph;
+	opGraph::buildModel(graph, model);
+	opGraph::CompileOptions options;
+	options.batch = max_batch;
+	opGraph::Network network(graph, options);
+	//The constructor prepared the weights, one run warms up the caches and the workspaces before any request
+	network.run();
+
+	opGraph::InferenceServer server(network, socket_path, max_wait);
+	g_server = &server;
+	signal(SIGINT, onSignal);
+	signal(SIGTERM, onSignal);
+	std::cout << "Serving " << model << " on " << socket_path << ", batches of up to " << max_batch << ", max wait " << max_wait << " ms" << std::endl;
+	server.serve();
+	g_server = nullptr;
+
+	server.printStats(std::cout);
+	return 0;
+}
@@ -0,0 +1,56 @@
+#include "network.h"
+#include "modelZoo.h"
+#include "inputPipeline.h"
+#include <chrono>
+#include <arm_compute/runtime/Scheduler.h>
+
+#include <iostream>
+#include <vector>
+
+using namespace arm_compute;
+using namespace std;
+
+int main (int argc, char **argv)
+{
+
+	if(argc < 3 || argc > 6)
+	{
+		std::cout<<"Usage: ./run_stream [numberThread(1)] [frames(directory of .ppm or one .ppm)] [model(resnet50)] [depth(2)] [repeat(1)]"<<std::endl;
+		return 0;
+	}
+
+	arm_compute::Scheduler::get().set_num_threads(atoi(argv[1]));
+	const vector<string> frames = opGraph::InputPipeline::listFrames(argv[2]);
+	const string model = argc > 3 ? argv[3] : "resnet50";
+	const size_t depth = argc > 4 ? static_cast<size_t>(atoi(argv[4])) : 2;
+	const int repeat = argc > 5 ? atoi(argv[5]) : 1;
+
+	opGraph::Graph graph;
+	opGraph::buildModel(graph, model);
+	opGraph::CompileOptions options;
+	opGraph::Network network(graph, options);
+
+	//The first run reshapes the weights, keep it out of the stream
+	network.run();
+
+	//The ring is shaped after the configured input, padding included
+	opGraph::InputPipeline pipeline(frames, TensorInfo(*network.input()->info()), depth, repeat);
+
+	double compute = 0;
+	auto beginTime = std::chrono::steady_clock::now();
+	while(pipeline.next(network.input()))
+	{
+		auto runTime = std::chrono::steady_clock::now();
+		network.run();
+		compute += std::chrono::duration<double,std::milli>(std::chrono::steady_clock::now() - runTime).count();
+	}
+	auto endTime = std::chrono::steady_clock::now();
+	const double elapsed = std::chrono::duration<double,std::milli>(endTime - beginTime).count();
+	const size_t count = std::max<size_t>(pipeline.frames(), 1);
+
+	std::cout << pipeline.frames() << " frames in " << elapsed << " ms, " << pipeline.frames() * 1000.0 / elapsed << " frames/sec" << std::endl;
+	std::cout << "network " << compute / count << " ms/frame, decode " << pipeline.decodeTime() / count << " ms/frame" << std::endl;
+	std::cout << "queue stall " << pipeline.stallTime() << " ms total (" << pipeline.stallTime() / count << " ms/frame), "
+			  << "decoder waited " << pipeline.decoderWaitTime() << " ms for a free slot" << std::endl;
+	return 0;
+}
@@ -0,0 +1,93 @@
+#ifndef OPSERVERPROTOCOL
+#define OPSERVERPROTOCOL
+
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <sys/socket.h>
+#include <unistd.h>
+
+//Wire format of run_server, shared with load_client which does not link ACL
+//Every message is a ServerHeader followed by size bytes of payload, in the byte order of the board
+//  Info   request without payload, the reply payload is a ServerInfo
+//  Infer  request payload is one (W, H, C) F32 image, planes one after the other, the reply payload the class scores
+//  Stats  request without payload, the reply payload is the server statistics as text
+//A reply carries the type of its request and status 0, the server closes the connection after any other status
+
+namespace opGraph{
+
+	enum class MessageType : uint32_t{
+		Info = 1,
+		Infer = 2,
+		Stats = 3
+	};
+
+	static const uint32_t server_magic = 0x4253504f;	//"OPSB"
+
+	struct ServerHeader{
+		uint32_t magic;
+		uint32_t type;
+		uint32_t status;
+		uint32_t size;
+	};
+
+	struct ServerInfo{
+		uint32_t width;
+		uint32_t height;
+		uint32_t channels;
+		uint32_t classes;
+		uint32_t max_batch;
+	};
+
+	inline bool readAll(int fd, void * data, size_t size){
+		uint8_t * pos = static_cast<uint8_t *>(data);
+		while(size > 0)
+		{
+			const ssize_t n = read(fd, pos, size);
+			if(n < 0 && errno == EINTR)
+			{
+				continue;
+			}
+			if(n <= 0)
+			{
+				return false;
+			}
+			pos += n;
+			size -= static_cast<size_t>(n);
+		}
+		return true;
+	}
+
+	inline bool writeAll(int fd, const void * data, size_t size){
+		const uint8_t * pos = static_cast<const uint8_t *>(data);
+		while(size > 0)
+		{
+			//A client that went away must not kill the server with SIGPIPE
+			const ssize_t n = send(fd, pos, size, MSG_NOSIGNAL);
+			if(n < 0 && errno == EINTR)
+			{
+				continue;
+			}
+			if(n <= 0)
+			{
+				return false;
+			}
+			pos += n;
+			size -= static_cast<size_t>(n);
+		}
+		return true;
+	}
+
+	inline bool sendMessage(int fd, MessageType type, uint32_t status, const void * payload, size_t size){
+		const ServerHeader header = { server_magic, static_cast<uint32_t>(type), status, static_cast<uint32_t>(size) };
+		return writeAll(fd, &header, sizeof(header)) && (size == 0 || writeAll(fd, payload, size));
+	}
+
+	inline bool receiveHeader(int fd, ServerHeader &header){
+		return readAll(fd, &header, sizeof(header)) && header.magic == server_magic;
+	}
+
+ }
+
+
+#endif
@@ -0,0 +1,73 @@
+#include "network.h"
+#include "modelZoo.h"
+#include <chrono>
+#include <arm_compute/runtime/Scheduler.h>
+
+#include <algorithm>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace arm_compute;
+using namespace std;
+
+//Times GEMM, Winograd and direct convolution for every convolution shape of a model at this thread count
+//and stores the fastest in the tuning file, then compares the whole network with NEConvolutionLayer's own choices
+//Shapes already in the file are not measured again, later runs pass the file as CompileOptions::conv_tuning
+
+static double medianLatency(opGraph::Network &network, int iterations){
+	network.run();
+	vector<double> latency;
+	for(int i = 0; i < iterations; i++)
+	{
+		auto beginTime = std::chrono::steady_clock::now();
+		network.run();
+		latency.push_back(std::chrono::duration<double,std::milli>(std::chrono::steady_clock::now() - beginTime).count());
+	}
+	std::sort(latency.begin(), latency.end());
+	return latency[latency.size() / 2];
+}
+
+int main (int argc, char **argv)
+{
+	if(argc > 6)
+	{
+		std::cout<<"Usage: ./tune_conv [model(resnet50)] [numberThread(4)] [tuning file(conv_tuning.txt)] [batch(1)] [numberIteration(10)]"<<std::endl;
+		return 0;
+	}
+	const string model = argc > 1 ? argv[1] : "resnet50";
+	arm_compute::Scheduler::get().set_num_threads(argc > 2 ? atoi(argv[2]) : 4);
+	const string tuning = argc > 3 ? argv[3] : "conv_tuning.txt";
+	const int batch = std::max(argc > 4 ? atoi(argv[4]) : 1, 1);
+	const int iterations = std::max(argc > 5 ? atoi(argv[5]) : 10, 1);
+
+	opGraph::Graph graph;
+	opGraph::buildModel(graph, model);
+	opGraph::CompileOptions options;
+	options.batch = batch;
+
+	double untuned = 0;
+	{
+		opGraph::Network network(graph, options);
+		untuned = medianLatency(network, iterations);
+	}
+	options.conv_tuning = tuning;
+	{
+		//Measures and writes the file, the timings are printed
+		options.tune = true;
+		opGraph::Network network(graph, options);
+	}
+	double tuned = 0;
+	{
+		//What a later run gets: the stored choices, nothing measured
+		options.tune = false;
+		opGraph::Network network(graph, options);
+		tuned = medianLatency(network, iterations);
+	}
+
+	std::cout << std::fixed << std::setprecision(3);
+	std::cout << model << " batch " << batch << ", " << arm_compute::Scheduler::get().num_threads() << " threads" << std::endl;
+	std::cout << "NEConvolutionLayer choice " << untuned << " ms, tuned " << tuned << " ms, " << untuned / tuned << "x" << std::endl;
+	return 0;
+}
@@ -0,0 +1,248 @@
+#include "weightBundle.h"
+#include "arm_compute/core/Error.h"
+#include "arm_compute/core/Window.h"
+#include "arm_compute/core/Helpers.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cmath>
+#include <cstring>
+#include <fcntl.h>
+#include <fstream>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace opWrapper{
+
+	static const char bundle_magic[4] = { 'O', 'P', 'W', 'B' };
+	static const uint32_t bundle_version = 2;
+	static const uint32_t bundle_alignment = 64;
+
+	static WeightBundle * g_bundle = nullptr;
+
+	std::string bundleKey(const std::string &npy_filename){
+		const size_t slash = npy_filename.find_last_of('/');
+		return slash == std::string::npos ? npy_filename : npy_filename.substr(slash + 1);
+	}
+
+	WeightBundle::WeightBundle(const std::string &filename)
+		: _base(nullptr), _size(0), _entries()
+	{
+		const int fd = open(filename.c_str(), O_RDONLY);
+		if(fd < 0)
+		{
+			ARM_COMPUTE_ERROR("Cannot open weight bundle %s: %s", filename.c_str(), strerror(errno));
+		}
+		struct stat st;
+		fstat(fd, &st);
+		_size = static_cast<size_t>(st.st_size);
+		void * base = mmap(nullptr, _size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+		close(fd);
+		if(base == MAP_FAILED)
+		{
+			ARM_COMPUTE_ERROR("Cannot map weight bundle %s: %s", filename.c_str(), strerror(errno));
+		}
+		_base = static_cast<uint8_t *>(base);
+
+		BundleHeader header;
+		if(_size < sizeof(header))
+		{
+			ARM_COMPUTE_ERROR("Weight bundle %s is truncated", filename.c_str());
+		}
+		memcpy(&header, _base, sizeof(header));
+		if(memcmp(header.magic, bundle_magic, sizeof(bundle_magic)) != 0 || header.version != bundle_version)
+		{
+			ARM_COMPUTE_ERROR("%s is not a version %u weight bundle, pack it again", filename.c_str(), bundle_version);
+		}
+
+		size_t pos = sizeof(header);
+		for(uint32_t i = 0; i < header.count; i++)
+		{
+			uint32_t length = 0;
+			if(_size - pos < sizeof(length))
+			{
+				ARM_COMPUTE_ERROR("Weight bundle %s is truncated", filename.c_str());
+			}
+			memcpy(&length, _base + pos, sizeof(length));
+			pos += sizeof(length);
+			if(_size - pos < static_cast<size_t>(length) + sizeof(BundleRecord))
+			{
+				ARM_COMPUTE_ERROR("Weight bundle %s is truncated", filename.c_str());
+			}
+			const std::string name(reinterpret_cast<const char *>(_base + pos), length);
+			pos += length;
+			BundleRecord record;
+			memcpy(&record, _base + pos, sizeof(record));
+			pos += sizeof(record);
+
+			if(record.num_dimensions > 6)
+			{
+				ARM_COMPUTE_ERROR("%s in weight bundle %s has too many dimensions", name.c_str(), filename.c_str());
+			}
+			BundleEntry entry;
+			for(uint32_t d = 0; d < record.num_dimensions; d++)
+			{
+				entry.shape.set(d, record.shape[d]);
+			}
+			entry.data_type = static_cast<DataType>(record.data_type);
+			if(is_data_type_quantized_asymmetric(entry.data_type) || entry.data_type == DataType::S32)
+			{
+				entry.quantization = QuantizationInfo(record.scale, record.zero_point);
+			}
+			entry.offset = record.offset;
+			entry.size = record.size;
+			if(entry.offset > _size || entry.size > _size - entry.offset)
+			{
+				ARM_COMPUTE_ERROR("Weight bundle %s is truncated", filename.c_str());
+			}
+			_entries[name] = entry;
+		}
+	}
+
+	WeightBundle::~WeightBundle(){
+		if(_base != nullptr)
+		{
+			munmap(_base, _size);
+		}
+	}
+
+	bool WeightBundle::release(const uint8_t * data, size_t size) const{
+		if(data < _base || data + size > _base + _size)
+		{
+			return false;
+		}
+		//Only the pages the tensor covers entirely, its neighbours may still be in use
+		const uintptr_t page = static_cast<uintptr_t>(sysconf(_SC_PAGESIZE));
+		const uintptr_t begin = (reinterpret_cast<uintptr_t>(data) + page - 1) / page * page;
+		const uintptr_t end = (reinterpret_cast<uintptr_t>(data) + size) / page * page;
+		if(end > begin)
+		{
+			madvise(reinterpret_cast<void *>(begin), end - begin, MADV_DONTNEED);
+		}
+		return true;
+	}
+
+	const BundleEntry * WeightBundle::find(const std::string &npy_filename) const{
+		std::map<std::string, BundleEntry>::const_iterator it = _entries.find(bundleKey(npy_filename));
+		return it == _entries.end() ? nullptr : &it->second;
+	}
+
+	std::string WeightBundle::signature() const{
+		const BundleEntry * entry = find(preparedKey());
+		return entry == nullptr ? std::string() : std::string(reinterpret_cast<const char *>(data(*entry)), entry->size);
+	}
+
+	static void pad(std::ofstream &fs, size_t alignment){
+		static const char zeros[64] = { 0 };
+		const size_t pos = static_cast<size_t>(fs.tellp());
+		fs.write(zeros, (alignment - pos % alignment) % alignment);
+	}
+
+	void writeWeightBundle(const std::string &filename, const std::vector<std::pair<std::string, const ITensor *>> &tensors){
+		std::ofstream fs(filename, std::ios::out | std::ios::binary | std::ios::trunc);
+		if(!fs.is_open())
+		{
+			ARM_COMPUTE_ERROR("Cannot write the weight bundle %s", filename.c_str());
+		}
+
+		BundleHeader header;
+		memcpy(header.magic, bundle_magic, sizeof(bundle_magic));
+		header.version = bundle_version;
+		header.count = static_cast<uint32_t>(tensors.size());
+		header.alignment = bundle_alignment;
+
+		//The table size is known up front, so every offset can be written in one pass
+		size_t offset = sizeof(header);
+		for(size_t i = 0; i < tensors.size(); i++)
+		{
+			offset += sizeof(uint32_t) + tensors[i].first.size() + sizeof(BundleRecord);
+		}
+		std::vector<BundleRecord> records(tensors.size());
+		for(size_t i = 0; i < tensors.size(); i++)
+		{
+			const ITensorInfo * info = tensors[i].second->info();
+			if(info->tensor_shape().num_dimensions() > 6)
+			{
+				ARM_COMPUTE_ERROR("%s has too many dimensions for a weight bundle", tensors[i].first.c_str());
+			}
+			BundleRecord &record = records[i];
+			memset(&record, 0, sizeof(record));
+			record.num_dimensions = static_cast<uint32_t>(info->tensor_shape().num_dimensions());
+			for(uint32_t d = 0; d < record.num_dimensions; d++)
+			{
+				record.shape[d] = static_cast<uint32_t>(info->tensor_shape()[d]);
+			}
+			record.data_type = static_cast<uint32_t>(info->data_type());
+			record.scale = info->quantization_info().uniform().scale;
+			record.zero_point = info->quantization_info().uniform().offset;
+			offset = (offset + bundle_alignment - 1) / bundle_alignment * bundle_alignment;
+			record.offset = offset;
+			record.size = info->tensor_shape().total_size() * info->element_size();
+			offset += record.size;
+		}
+
+		fs.write(reinterpret_cast<const char *>(&header), sizeof(header));
+		for(size_t i = 0; i < tensors.size(); i++)
+		{
+			const uint32_t length = static_cast<uint32_t>(tensors[i].first.size());
+			fs.write(reinterpret_cast<const char *>(&length), sizeof(length));
+			fs.write(tensors[i].first.data(), length);
+			fs.write(reinterpret_cast<const char *>(&records[i]), sizeof(BundleRecord));
+		}
+		for(size_t i = 0; i < tensors.size(); i++)
+		{
+			pad(fs, bundle_alignment);
+			const ITensor * tensor = tensors[i].second;
+			const ITensorInfo * info = tensor->info();
+			if(info->padding().empty())
+			{
+				fs.write(reinterpret_cast<const char *>(tensor->buffer() + info->offset_first_element_in_bytes()), records[i].size);
+				continue;
+			}
+			//Padded source, drop the borders row by row
+			const size_t row = info->dimension(0) * info->element_size();
+			Window window;
+			window.use_tensor_dimensions(info->tensor_shape());
+			window.set(Window::DimX, Window::Dimension(0, 1, 1));
+			execute_window_loop(window, [&](const Coordinates & id)
+			{
+				fs.write(reinterpret_cast<const char *>(tensor->ptr_to_element(id)), row);
+			});
+		}
+		fs.close();
+		if(!fs)
+		{
+			ARM_COMPUTE_ERROR("Writing the weight bundle %s failed", filename.c_str());
+		}
+	}
+
+	QuantizationInfo rangeQuantization(float min, float max){
+		min = std::min(min, 0.f);
+		max = std::max(max, 0.f);
+		if(max - min < 1e-6f)
+		{
+			max = min + 1e-6f;
+		}
+		const float scale = (max - min) / 255.f;
+		const int zero_point = static_cast<int>(std::round(-min / scale));
+		return QuantizationInfo(scale, std::max(0, std::min(255, zero_point)));
+	}
+
+	std::string rangeKey(const std::string &edge_name){
+		return edge_name + "_range";
+	}
+
+	std::string preparedKey(){
+		return "prepared_signature";
+	}
+
+	void setWeightBundle(WeightBundle * bundle){
+		g_bundle = bundle;
+	}
+
+	WeightBundle * weightBundle(){
+		return g_bundle;
+	}
+
+ }
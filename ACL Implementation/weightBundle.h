@@ -0,0 +1,97 @@
+#ifndef OPWEIGHTBUNDLE
+#define OPWEIGHTBUNDLE
+
+#include "arm_compute/core/TensorShape.h"
+#include "arm_compute/core/ITensor.h"
+#include "arm_compute/core/Types.h"
+
+#include <map>
+#include <string>
+#include <vector>
+
+using namespace arm_compute;
+
+namespace opWrapper{
+
+	//Layout of a bundle file, every field is little endian as written by the board itself
+	//  BundleHeader, then count entries of { uint32 name length, name, BundleRecord }, then the data
+	//Each tensor starts on a 64 byte boundary and holds exactly the bytes NPLoader::fill_tensor
+	//would write into an unpadded tensor of its data type, so it can be imported without any conversion
+	//Version 2 records the data type and the quantization of every tensor, calibrate writes QASYMM8 weights and S32 biases
+	struct BundleHeader{
+		char magic[4];
+		uint32_t version;
+		uint32_t count;
+		uint32_t alignment;
+	};
+
+	struct BundleRecord{
+		uint32_t num_dimensions;
+		uint32_t shape[6];
+		uint32_t data_type;		//arm_compute::DataType
+		float scale;
+		int32_t zero_point;
+		uint64_t offset;
+		uint64_t size;
+	};
+
+	struct BundleEntry{
+		TensorShape shape;
+		DataType data_type;
+		QuantizationInfo quantization;
+		size_t offset;
+		size_t size;
+
+		BundleEntry()
+			: shape(), data_type(DataType::F32), quantization(), offset(0), size(0)
+		{
+		}
+	};
+
+	//Parameters are looked up by NPY file name without the directory, the same key whatever data_path is
+	std::string bundleKey(const std::string &npy_filename);
+	//Key of the signature of a prepared bundle, stored as a U8 tensor
+	std::string preparedKey();
+
+	//A read-only view of a bundle file, the whole file is mmapped once
+	//Pages are private, a tensor that is modified after import (BN folding) only copies the pages it touches
+	class WeightBundle{
+	public:
+		explicit WeightBundle(const std::string &filename);
+		~WeightBundle();
+		WeightBundle(const WeightBundle &) = delete;
+		WeightBundle &operator=(const WeightBundle &) = delete;
+
+		const BundleEntry * find(const std::string &npy_filename) const;
+		//Written by writePreparedBundle: the float parameters are stored as the layers use them (BN folded,
+		//channels shuffled, narrowed to F16) and the signature names the resolved graph they were prepared for
+		bool prepared() const { return find(preparedKey()) != nullptr; }
+		std::string signature() const;
+		uint8_t * data(const BundleEntry &entry) const { return _base + entry.offset; }
+		//Drop the pages of a tensor imported from the bundle that is never read again, false when data is not in the bundle
+		bool release(const uint8_t * data, size_t size) const;
+		size_t size() const { return _size; }
+		size_t count() const { return _entries.size(); }
+
+	private:
+		uint8_t * _base;
+		size_t _size;
+		std::map<std::string, BundleEntry> _entries;
+	};
+
+	//Write one bundle from tensors already filled, used by pack_weights and calibrate
+	void writeWeightBundle(const std::string &filename, const std::vector<std::pair<std::string, const ITensor *>> &tensors);
+
+	//Asymmetric 8-bit quantization covering [min, max], widened so that 0 is represented exactly
+	QuantizationInfo rangeQuantization(float min, float max);
+	//Key of the calibrated [min, max] of an activation edge, stored as a 2 element F32 tensor
+	std::string rangeKey(const std::string &edge_name);
+
+	//Bundle used by the opWrapper factories, nullptr loads every parameter from its NPY file
+	void setWeightBundle(WeightBundle * bundle);
+	WeightBundle * weightBundle();
+
+ }
+
+
+#endif